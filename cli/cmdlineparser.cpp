@@ -341,6 +341,30 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Cache analysis results
+        else if (std::strncmp(argv[i], "--cache-dir=", 12) == 0) {
+            _settings->cacheDir = Path::fromNativeSeparators(argv[i] + 12);
+            if (_settings->cacheDir.empty()) {
+                PrintMessage("seccheck: error: no folder given for '--cache-dir='.");
+                return false;
+            }
+        }
+
+        // Only check the functions that a diff changed
+        else if (std::strncmp(argv[i], "--diff=", 7) == 0) {
+            const std::string filename = 7 + argv[i];
+            std::ifstream f(filename.c_str());
+            if (!f.is_open()) {
+                PrintMessage("seccheck: Couldn't open the file: \"" + filename + "\".");
+                return false;
+            }
+            const std::string errmsg(_settings->_changedLines.parseDiff(f));
+            if (!errmsg.empty()) {
+                PrintMessage(errmsg);
+                return false;
+            }
+        }
+
         // Check configuration
         else if (std::strcmp(argv[i], "--check-config") == 0) {
             _settings->checkConfiguration = true;
@@ -376,6 +400,22 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Use processes or threads for -j
+        else if (std::strncmp(argv[i], "--executor=", 11) == 0) {
+            const std::string executor(11+argv[i]);
+            if (executor == "process")
+                _settings->_executor = Settings::Process;
+            else if (executor == "thread")
+                _settings->_executor = Settings::Thread;
+            else {
+                std::string message("seccheck: error: unrecognized executor: \"");
+                message += executor;
+                message += "\".";
+                PrintMessage(message);
+                return false;
+            }
+        }
+
         // User define
         else if (std::strncmp(argv[i], "-D", 2) == 0) {
             std::string define;
@@ -766,6 +806,43 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Number of threads that check the configurations of one file
+        else if (std::strncmp(argv[i], "--config-jobs=", 14) == 0) {
+            std::istringstream iss(14+argv[i]);
+            if (!(iss >> _settings->_configJobs)) {
+                PrintMessage("seccheck: argument to '--config-jobs=' is not a number.");
+                return false;
+            }
+
+            if (_settings->_configJobs < 1) {
+                PrintMessage("seccheck: argument to '--config-jobs=' must be greater than 0.");
+                return false;
+            }
+        }
+
+        // Number of threads that analyse the function bodies of a file
+        else if (std::strncmp(argv[i], "--symboldatabase-jobs=", 22) == 0) {
+            std::istringstream iss(22+argv[i]);
+            if (!(iss >> _settings->_symbolDatabaseJobs)) {
+                PrintMessage("seccheck: argument to '--symboldatabase-jobs=' is not a number.");
+                return false;
+            }
+
+            if (_settings->_symbolDatabaseJobs < 1) {
+                PrintMessage("seccheck: argument to '--symboldatabase-jobs=' must be greater than 0.");
+                return false;
+            }
+        }
+
+        // Number of tokens of template expansions that are kept
+        else if (std::strncmp(argv[i], "--template-cache-size=", 22) == 0) {
+            std::istringstream iss(22+argv[i]);
+            if (!(iss >> _settings->_templateCacheSize)) {
+                PrintMessage("seccheck: argument to '--template-cache-size=' is not a number.");
+                return false;
+            }
+        }
+
         // Set maximum number of #ifdef configurations to check
         else if (std::strncmp(argv[i], "--max-configs=", 14) == 0) {
             _settings->_force = false;
@@ -813,10 +890,6 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
     if (_settings->_force)
         _settings->_maxConfigs = ~0U;
 
-    if (_settings->isEnabled("unusedFunction") && _settings->_jobs > 1) {
-        PrintMessage("seccheck: unusedFunction check can't be used with '-j' option. Disabling unusedFunction check.");
-    }
-
     if (_settings->inconclusive && _settings->_xml && _settings->_xml_version == 1U) {
         PrintMessage("seccheck: inconclusive messages will not be shown, because the old xml format is not compatible. It's recommended to use the new xml format (use --xml-version=2).");
     }
@@ -856,10 +929,22 @@ void CmdLineParser::PrintHelp()
               "Options:\n"
               "    --append=<file>      This allows you to provide information about functions\n"
               "                         by providing an implementation for them.\n"
+              "    --cache-dir=<dir>    Store analysis results in the given folder. When a\n"
+              "                         file is checked again and neither its preprocessed\n"
+              "                         code nor the settings have changed, the stored\n"
+              "                         results are reported instead of checking the code.\n"
               "    --check-config       Check seccheck configuration. The normal code\n"
               "                         analysis is disabled by this flag.\n"
               "    --check-library      Show information messages when library files have\n"
               "                         incomplete info.\n"
+              "    --config-jobs=<n>    Check up to [n] preprocessor configurations of a file\n"
+              "                         at the same time, in threads. The output is the same\n"
+              "                         as when the configurations are checked one by one.\n"
+              "                         Default is '1'.\n"
+              "    --diff=<file>        Only check the functions that are changed by the\n"
+              "                         given unified diff and only report messages in\n"
+              "                         these functions. The other files are analysed for\n"
+              "                         the whole program checks only.\n"
               "    --dump               Dump xml data for each translation unit. The dump\n"
               "                         files have the extension .dump and contain ast,\n"
               "                         tokenlist, symboldatabase, valueflow.\n"
@@ -902,6 +987,13 @@ void CmdLineParser::PrintHelp()
               "                         provided. Note that your operating system can modify\n"
               "                         this value, e.g. '256' can become '0'.\n"
               "    --errorlist          Print a list of all the error messages in XML format.\n"
+              "    --executor=<type>    How files are checked in parallel with '-j'. The\n"
+              "                         accepted types are:\n"
+              "                          * process  Check files in child processes. This is\n"
+              "                                     the default where fork() is available.\n"
+              "                          * thread   Check files in threads. Data for whole\n"
+              "                                     program analysis is then collected from\n"
+              "                                     all threads.\n"
               "    --exitcode-suppressions=<file>\n"
               "                         Used when certain messages should be displayed but\n"
               "                         should not cause a non-zero exitcode.\n"
@@ -1013,6 +1105,15 @@ void CmdLineParser::PrintHelp()
               "    --suppressions-list=<file>\n"
               "                         Suppress warnings listed in the file. Each suppression\n"
               "                         is in the same format as <spec> above.\n"
+              "    --symboldatabase-jobs=<n>\n"
+              "                         Analyse the function bodies of a file in [n] threads\n"
+              "                         when its symbol database is created. The output is\n"
+              "                         the same as with one thread. Default is '1'.\n"
+              "    --template-cache-size=<n>\n"
+              "                         Keep up to [n] tokens of template expansions, so a\n"
+              "                         template that is instantiated again in another\n"
+              "                         configuration or file is copied from memory. '0'\n"
+              "                         disables this. Default is '500000'.\n"
               "    --template='<text>'  Format the error messages. E.g.\n"
               "                         '{file}:{line},{severity},{id},{message}' or\n"
               "                         '{file}({line}):({severity}) {message}' or\n"
@@ -123,6 +123,12 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
         }
     }
 
+    // Check that the cache folder exists
+    if (!settings.cacheDir.empty() && !FileLister::isDirectory(Path::toNativeSeparators(settings.cacheDir))) {
+        std::cout << "seccheck: error: cache folder '" << Path::toNativeSeparators(settings.cacheDir) << "' does not exist." << std::endl;
+        return false;
+    }
+
     const std::vector<std::string>& pathnames = parser.GetPathNames();
 
     if (!pathnames.empty()) {
@@ -792,13 +798,13 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
     } else if (!ThreadExecutor::isEnabled()) {
         std::cout << "No thread support yet implemented for this platform." << std::endl;
     } else {
-        // Multiple processes
+        // Multiple processes or threads
         ThreadExecutor executor(_files, settings, *this);
         returnValue = executor.check();
     }
 
     if (settings.isEnabled("information") || settings.checkConfiguration)
-        reportUnmatchedSuppressions(settings.nomsg.getUnmatchedGlobalSuppressions(settings._jobs == 1 && settings.isEnabled("unusedFunction")));
+        reportUnmatchedSuppressions(settings.nomsg.getUnmatchedGlobalSuppressions(settings.isEnabled("unusedFunction")));
 
     if (!settings.checkConfiguration) {
         cppcheck.tooManyConfigsError("",0U);
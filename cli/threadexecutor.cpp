@@ -19,12 +19,12 @@
 #include "threadexecutor.h"
 #include "cppcheck.h"
 #include "cppcheckexecutor.h"
+#include <algorithm>
 #include <iostream>
 #ifdef __SVR4  // Solaris
 #include <sys/loadavg.h>
 #endif
 #ifdef THREADING_MODEL_FORK
-#include <algorithm>
 #include <sys/select.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -36,25 +36,43 @@
 #include <cstring>
 #include <sstream>
 #endif
-#ifdef THREADING_MODEL_WIN
-#include <process.h>
-#include <windows.h>
-#include <algorithm>
-#include <cstring>
-#include <errno.h>
+#ifdef THREADING_MODEL_THREAD
+#include <system_error>
+#include <thread>
 #endif
 
+#ifdef THREADING_MODEL_FORK
 // required for FD_ZERO
 using std::memset;
+#endif
+
+#if defined(THREADING_MODEL_FORK) || defined(THREADING_MODEL_THREAD)
+/** Order files by size, largest first. Files with the same size are kept in name order. */
+static bool largerFile(const std::map<std::string, std::size_t>::const_iterator &a, const std::map<std::string, std::size_t>::const_iterator &b)
+{
+    return a->second > b->second;
+}
+
+static std::vector<std::map<std::string, std::size_t>::const_iterator> largestFirst(const std::map<std::string, std::size_t> &files)
+{
+    std::vector<std::map<std::string, std::size_t>::const_iterator> queue;
+    queue.reserve(files.size());
+    for (auto i = files.begin(); i != files.end(); ++i)
+        queue.push_back(i);
+    std::stable_sort(queue.begin(), queue.end(), largerFile);
+    return queue;
+}
+#endif
 
 ThreadExecutor::ThreadExecutor(const std::map<std::string, std::size_t> &files, Settings &settings, ErrorLogger &errorLogger)
     : _files(files), _settings(settings), _errorLogger(errorLogger), _fileCount(0)
 {
 #if defined(THREADING_MODEL_FORK)
     _wpipe = 0;
-#elif defined(THREADING_MODEL_WIN)
-    _processedFiles = 0;
-    _totalFiles = 0;
+#endif
+#if defined(THREADING_MODEL_THREAD)
+    _useThreads = false;
+    _nextFile = 0;
     _processedSize = 0;
     _totalFileSize = 0;
 #endif
@@ -65,6 +83,24 @@ ThreadExecutor::~ThreadExecutor()
     //dtor
 }
 
+void ThreadExecutor::addFileContent(const std::string &path, const std::string &content)
+{
+    _fileContents[path] = content;
+}
+
+unsigned int ThreadExecutor::check()
+{
+#if defined(THREADING_MODEL_FORK)
+    if (_settings._executor == Settings::Process)
+        return checkProcesses();
+#endif
+#if defined(THREADING_MODEL_THREAD)
+    return checkThreads();
+#else
+    return 0;
+#endif
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 ////// This code is for platforms that support fork() only ////////////////////
@@ -72,34 +108,55 @@ ThreadExecutor::~ThreadExecutor()
 
 #if defined(THREADING_MODEL_FORK)
 
-void ThreadExecutor::addFileContent(const std::string &path, const std::string &content)
+/**
+ * read exactly len bytes, returns false on end-of-file or error. Large
+ * messages don't fit in the pipe so a non-blocking read waits for the rest.
+ */
+static bool readAll(int fd, char *buf, std::size_t len)
 {
-    _fileContents[ path ] = content;
+    while (len > 0) {
+        const ssize_t n = read(fd, buf, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && errno == EAGAIN) {
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(fd, &rfds);
+            select(fd + 1, &rfds, NULL, NULL, NULL);
+            continue;
+        }
+        if (n <= 0)
+            return false;
+        buf += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
 }
 
-int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
+int ThreadExecutor::handleRead(int rpipe, unsigned int &result, CppCheck &master)
 {
     char type = 0;
-    if (read(rpipe, &type, 1) <= 0) {
-        if (errno == EAGAIN)
+    const ssize_t n = read(rpipe, &type, 1);
+    if (n <= 0) {
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
             return 0;
 
         return -1;
     }
 
-    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END) {
+    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != FILE_END && type != FILE_INFO) {
         std::cerr << "#### You found a bug from seccheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(0);
     }
 
     unsigned int len = 0;
-    if (read(rpipe, &len, sizeof(len)) <= 0) {
+    if (!readAll(rpipe, reinterpret_cast<char *>(&len), sizeof(len))) {
         std::cerr << "#### You found a bug from seccheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(0);
     }
 
     char *buf = new char[len];
-    if (read(rpipe, buf, len) <= 0) {
+    if (!readAll(rpipe, buf, len)) {
         std::cerr << "#### You found a bug from seccheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(0);
     }
@@ -119,22 +176,24 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
 
         if (!_settings.nomsg.isSuppressed(msg._id, file, line)) {
             // Alert only about unique errors
-            std::string errmsg = msg.toString(_settings._verbose);
-            if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-                _errorList.push_back(errmsg);
+            if (_errorList.insert(msg.hash(_settings._verbose)).second) {
                 if (type == REPORT_ERROR)
                     _errorLogger.reportErr(msg);
                 else
                     _errorLogger.reportInfo(msg);
             }
         }
-    } else if (type == CHILD_END) {
+    } else if (type == FILE_INFO) {
+        // the data is sent with a terminating null character
+        const unsigned int size = (len > 0U && buf[len - 1U] == '\0') ? len - 1U : len;
+        master.loadFileInfo(std::string(buf, size));
+    } else if (type == FILE_END) {
         std::istringstream iss(buf);
         unsigned int fileResult = 0;
         iss >> fileResult;
         result += fileResult;
         delete [] buf;
-        return -1;
+        return 2;
     }
 
     delete [] buf;
@@ -161,7 +220,105 @@ bool ThreadExecutor::checkLoadAverage(size_t nchildren)
 #endif
 }
 
-unsigned int ThreadExecutor::check()
+void ThreadExecutor::startWorker(std::list<Worker> &workers)
+{
+    int pipes[2];
+    int cmdpipes[2];
+    if (pipe(pipes) == -1 || pipe(cmdpipes) == -1) {
+        std::cerr << "pipe() failed: "<< std::strerror(errno) << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    int flags = 0;
+    if ((flags = fcntl(pipes[0], F_GETFL, 0)) < 0) {
+        std::cerr << "fcntl(F_GETFL) failed: "<< std::strerror(errno) << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (fcntl(pipes[0], F_SETFL, flags | O_NONBLOCK) < 0) {
+        std::cerr << "fcntl(F_SETFL) failed: "<< std::strerror(errno) << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        // Error
+        std::cerr << "Failed to create child process: "<< std::strerror(errno) << std::endl;
+        std::exit(EXIT_FAILURE);
+    } else if (pid == 0) {
+        // The pipes of the other workers must be closed, otherwise they
+        // never see end-of-file on their command pipe.
+        for (auto w = workers.begin(); w != workers.end(); ++w) {
+            close(w->rpipe);
+            close(w->cmdpipe);
+        }
+        close(pipes[0]);
+        close(cmdpipes[1]);
+        _wpipe = pipes[1];
+        workerLoop(cmdpipes[0]);
+        std::exit(0);
+    }
+
+    close(pipes[1]);
+    close(cmdpipes[0]);
+
+    Worker worker;
+    worker.pid = pid;
+    worker.rpipe = pipes[0];
+    worker.cmdpipe = cmdpipes[1];
+    workers.push_back(worker);
+}
+
+void ThreadExecutor::sendFile(Worker &worker, const std::string &file)
+{
+    const unsigned int len = static_cast<unsigned int>(file.length());
+    std::string out(reinterpret_cast<const char *>(&len), sizeof(len));
+    out += file;
+    if (write(worker.cmdpipe, out.c_str(), out.length()) != static_cast<ssize_t>(out.length())) {
+        std::cerr << "#### ThreadExecutor::sendFile, Failed to write to pipe" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    worker.file = file;
+}
+
+void ThreadExecutor::workerLoop(int cmdpipe)
+{
+    // The settings and library configuration were loaded by the parent
+    // before the fork and are shared by all files that this worker checks.
+    for (;;) {
+        unsigned int len = 0;
+        if (!readAll(cmdpipe, reinterpret_cast<char *>(&len), sizeof(len)))
+            break;
+        std::string file(len, '\0');
+        if (len > 0 && !readAll(cmdpipe, &file[0], len))
+            break;
+
+        CppCheck fileChecker(*this, false);
+        fileChecker.settings() = _settings;
+        unsigned int resultOfCheck = 0;
+
+        auto content = _fileContents.find(file);
+        if (content != _fileContents.end()) {
+            // File content was given as a string
+            resultOfCheck = fileChecker.check(file, content->second);
+        } else {
+            // Read file from a file
+            resultOfCheck = fileChecker.check(file);
+        }
+
+        // Whole program data is sent before the file is reported as checked
+        const std::string fileInfo(fileChecker.fileInfoToString());
+        if (!fileInfo.empty())
+            writeToPipe(FILE_INFO, fileInfo);
+
+        std::ostringstream oss;
+        oss << resultOfCheck;
+        writeToPipe(FILE_END, oss.str());
+    }
+    close(cmdpipe);
+}
+
+unsigned int ThreadExecutor::checkProcesses()
 {
     _fileCount = 0;
     unsigned int result = 0;
@@ -171,138 +328,118 @@ unsigned int ThreadExecutor::check()
         totalfilesize += i->second;
     }
 
-    std::list<int> rpipes;
-    std::map<pid_t, std::string> childFile;
-    std::map<int, std::string> pipeFile;
-    std::size_t processedsize = 0;
-    auto i = _files.begin();
-    for (;;) {
-        // Start a new child
-        size_t nchildren = rpipes.size();
-        if (i != _files.end() && nchildren < _settings._jobs && checkLoadAverage(nchildren)) {
-            int pipes[2];
-            if (pipe(pipes) == -1) {
-                std::cerr << "pipe() failed: "<< std::strerror(errno) << std::endl;
-                std::exit(EXIT_FAILURE);
-            }
+    const std::vector<std::map<std::string, std::size_t>::const_iterator> queue(largestFirst(_files));
+    auto next = queue.begin();
 
-            int flags = 0;
-            if ((flags = fcntl(pipes[0], F_GETFL, 0)) < 0) {
-                std::cerr << "fcntl(F_GETFL) failed: "<< std::strerror(errno) << std::endl;
-                std::exit(EXIT_FAILURE);
-            }
+    // Whole program data of the workers is loaded into this instance
+    CppCheck master(*this, false);
+    master.settings() = _settings;
 
-            if (fcntl(pipes[0], F_SETFL, flags | O_NONBLOCK) < 0) {
-                std::cerr << "fcntl(F_SETFL) failed: "<< std::strerror(errno) << std::endl;
-                std::exit(EXIT_FAILURE);
+    std::list<Worker> workers;
+    std::size_t processedsize = 0;
+    for (;;) {
+        // Hand out files to idle workers, start new workers as needed
+        std::size_t busy = 0;
+        for (auto w = workers.begin(); w != workers.end(); ++w) {
+            if (!w->file.empty())
+                ++busy;
+        }
+        for (auto w = workers.begin(); w != workers.end() && next != queue.end(); ++w) {
+            if (w->file.empty() && checkLoadAverage(busy)) {
+                sendFile(*w, (*next)->first);
+                ++next;
+                ++busy;
             }
+        }
+        while (next != queue.end() && workers.size() < _settings._jobs && busy == workers.size() && checkLoadAverage(busy)) {
+            startWorker(workers);
+            sendFile(workers.back(), (*next)->first);
+            ++next;
+            ++busy;
+        }
 
-            pid_t pid = fork();
-            if (pid < 0) {
-                // Error
-                std::cerr << "Failed to create child process: "<< std::strerror(errno) << std::endl;
-                std::exit(EXIT_FAILURE);
-            } else if (pid == 0) {
-                close(pipes[0]);
-                _wpipe = pipes[1];
-
-                CppCheck fileChecker(*this, false);
-                fileChecker.settings() = _settings;
-                unsigned int resultOfCheck = 0;
-
-                if (!_fileContents.empty() && _fileContents.find(i->first) != _fileContents.end()) {
-                    // File content was given as a string
-                    resultOfCheck = fileChecker.check(i->first, _fileContents[ i->first ]);
-                } else {
-                    // Read file from a file
-                    resultOfCheck = fileChecker.check(i->first);
-                }
+        if (busy == 0 && next == queue.end()) {
+            // All done
+            break;
+        }
 
-                std::ostringstream oss;
-                oss << resultOfCheck;
-                writeToPipe(CHILD_END, oss.str());
-                std::exit(0);
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        int maxfd = -1;
+        for (auto w = workers.begin(); w != workers.end(); ++w) {
+            FD_SET(w->rpipe, &rfds);
+            maxfd = std::max(maxfd, w->rpipe);
+        }
+        struct timeval tv; // for every second polling of load average condition
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+        int r = select(maxfd + 1, &rfds, NULL, NULL, &tv);
+        if (r <= 0)
+            continue;
+
+        auto w = workers.begin();
+        while (w != workers.end()) {
+            if (!FD_ISSET(w->rpipe, &rfds)) {
+                ++w;
+                continue;
             }
 
-            close(pipes[1]);
-            rpipes.push_back(pipes[0]);
-            childFile[pid] = i->first;
-            pipeFile[pipes[0]] = i->first;
-
-            ++i;
-        } else if (!rpipes.empty()) {
-            fd_set rfds;
-            FD_ZERO(&rfds);
-            for (auto rp = rpipes.begin(); rp != rpipes.end(); ++rp)
-                FD_SET(*rp, &rfds);
-            struct timeval tv; // for every second polling of load average condition
-            tv.tv_sec = 1;
-            tv.tv_usec = 0;
-            int r = select(*std::max_element(rpipes.begin(), rpipes.end()) + 1, &rfds, NULL, NULL, &tv);
-
-            if (r > 0) {
-                auto rp = rpipes.begin();
-                while (rp != rpipes.end()) {
-                    if (FD_ISSET(*rp, &rfds)) {
-                        int readRes = handleRead(*rp, result);
-                        if (readRes == -1) {
-                            std::size_t size = 0;
-                            auto p = pipeFile.find(*rp);
-                            if (p != pipeFile.end()) {
-                                std::string name = p->second;
-                                pipeFile.erase(p);
-                                auto fs = _files.find(name);
-                                if (fs != _files.end()) {
-                                    size = fs->second;
-                                }
-                            }
-
-                            _fileCount++;
-                            processedsize += size;
-                            if (!_settings._errorsOnly)
-                                CppCheckExecutor::reportStatus(_fileCount, _files.size(), processedsize, totalfilesize);
-
-                            close(*rp);
-                            rp = rpipes.erase(rp);
-                        } else
-                            ++rp;
-                    } else
-                        ++rp;
+            const int readRes = handleRead(w->rpipe, result, master);
+            if (readRes == 2 || readRes == -1) {
+                if (!w->file.empty()) {
+                    auto fs = _files.find(w->file);
+                    if (fs != _files.end())
+                        processedsize += fs->second;
+                    _fileCount++;
+                    if (!_settings._errorsOnly)
+                        CppCheckExecutor::reportStatus(_fileCount, _files.size(), processedsize, totalfilesize);
                 }
             }
 
-            int stat = 0;
-            pid_t child = waitpid(0, &stat, WNOHANG);
-            if (child > 0) {
-                std::string childname;
-                auto c = childFile.find(child);
-                if (c != childFile.end()) {
-                    childname = c->second;
-                    childFile.erase(c);
-                }
+            if (readRes == -1) {
+                // The worker has died
+                close(w->rpipe);
+                close(w->cmdpipe);
 
+                int stat = 0;
+                waitpid(w->pid, &stat, 0);
                 if (WIFSIGNALED(stat)) {
                     std::ostringstream oss;
                     oss << "Internal error: Child process crashed with signal " << WTERMSIG(stat);
 
                     std::list<ErrorLogger::ErrorMessage::FileLocation> locations;
-                    locations.push_back(ErrorLogger::ErrorMessage::FileLocation(childname, 0));
+                    locations.push_back(ErrorLogger::ErrorMessage::FileLocation(w->file, 0));
                     const ErrorLogger::ErrorMessage errmsg(locations,
                                                            Severity::error,
                                                            oss.str(),
                                                            "cppcheckError",
                                                            false);
 
-                    if (!_settings.nomsg.isSuppressed(errmsg._id, childname, 0))
+                    if (!_settings.nomsg.isSuppressed(errmsg._id, w->file, 0))
                         _errorLogger.reportErr(errmsg);
                 }
+                w = workers.erase(w);
+            } else {
+                if (readRes == 2)
+                    w->file.clear();
+                ++w;
             }
-        } else {
-            // All done
-            break;
         }
     }
 
+    // Closing the command pipes tells the workers to exit
+    for (auto w = workers.begin(); w != workers.end(); ++w)
+        close(w->cmdpipe);
+    for (auto w = workers.begin(); w != workers.end(); ++w) {
+        int stat = 0;
+        waitpid(w->pid, &stat, 0);
+        close(w->rpipe);
+    }
+
+    // The messages of the whole program analysis are reported directly
+    _useThreads = true;
+    master.analyseWholeProgram();
+    _useThreads = false;
 
     return result;
 }
@@ -324,168 +461,92 @@ void ThreadExecutor::writeToPipe(PipeSignal type, const std::string &data)
     delete [] out;
 }
 
-void ThreadExecutor::reportOut(const std::string &outmsg)
-{
-    writeToPipe(REPORT_OUT, outmsg);
-}
-
-void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
-{
-    writeToPipe(REPORT_ERROR, msg.serialize());
-}
-
-void ThreadExecutor::reportInfo(const ErrorLogger::ErrorMessage &msg)
-{
-    writeToPipe(REPORT_INFO, msg.serialize());
-}
+#endif
 
-#elif defined(THREADING_MODEL_WIN)
+///////////////////////////////////////////////////////////////////////////////
+////// Checking in threads ////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-void ThreadExecutor::addFileContent(const std::string &path, const std::string &content)
-{
-    _fileContents[path] = content;
-}
+#if defined(THREADING_MODEL_THREAD)
 
-unsigned int ThreadExecutor::check()
+unsigned int ThreadExecutor::checkThreads()
 {
-    HANDLE *threadHandles = new HANDLE[_settings._jobs];
-
-    _itNextFile = _files.begin();
-
-    _processedFiles = 0;
+    _useThreads = true;
+    _queue = largestFirst(_files);
+    _nextFile = 0;
+    _fileCount = 0;
     _processedSize = 0;
-    _totalFiles = _files.size();
     _totalFileSize = 0;
     for (auto i = _files.begin(); i != _files.end(); ++i) {
         _totalFileSize += i->second;
     }
 
-    InitializeCriticalSection(&_fileSync);
-    InitializeCriticalSection(&_errorSync);
-    InitializeCriticalSection(&_reportSync);
-
-    for (unsigned int i = 0; i < _settings._jobs; ++i) {
-        threadHandles[i] = (HANDLE)_beginthreadex(NULL, 0, threadProc, this, 0, NULL);
-        if (!threadHandles[i]) {
-            std::cerr << "#### .\nThreadExecutor::check error, errno :" << errno << std::endl;
-            exit(EXIT_FAILURE);
-        }
-    }
-
-    DWORD waitResult = WaitForMultipleObjects(_settings._jobs, threadHandles, TRUE, INFINITE);
-    if (waitResult != WAIT_OBJECT_0) {
-        if (waitResult == WAIT_FAILED) {
-            std::cerr << "#### .\nThreadExecutor::check wait failed, result: " << waitResult << " error: " << GetLastError() << std::endl;
-            exit(EXIT_FAILURE);
-        } else {
-            std::cerr << "#### .\nThreadExecutor::check wait failed, result: " << waitResult << std::endl;
-            exit(EXIT_FAILURE);
-        }
+    // Timer results and whole program data of the threads are merged into this instance
+    CppCheck master(*this, false);
+    master.settings() = _settings;
+
+    const std::size_t jobs = std::min<std::size_t>(_settings._jobs, _files.size());
+    std::vector<unsigned int> results(jobs, 0U);
+    std::vector<std::thread> threads;
+    threads.reserve(jobs);
+    try {
+        for (std::size_t i = 0; i < jobs; ++i)
+            threads.push_back(std::thread(&ThreadExecutor::threadProc, this, std::ref(master), std::ref(results[i])));
+    } catch (const std::system_error &e) {
+        std::cerr << "#### ThreadExecutor::check error: " << e.what() << std::endl;
+        std::exit(EXIT_FAILURE);
     }
 
     unsigned int result = 0;
-    for (unsigned int i = 0; i < _settings._jobs; ++i) {
-        DWORD exitCode;
-
-        if (!GetExitCodeThread(threadHandles[i], &exitCode)) {
-            std::cerr << "#### .\nThreadExecutor::check get exit code failed, error:" << GetLastError() << std::endl;
-            exit(EXIT_FAILURE);
-        }
-
-        result += exitCode;
-
-        if (!CloseHandle(threadHandles[i])) {
-            std::cerr << "#### .\nThreadExecutor::check close handle failed, error:" << GetLastError() << std::endl;
-            exit(EXIT_FAILURE);
-        }
+    for (std::size_t i = 0; i < jobs; ++i) {
+        threads[i].join();
+        result += results[i];
     }
 
-    DeleteCriticalSection(&_fileSync);
-    DeleteCriticalSection(&_errorSync);
-    DeleteCriticalSection(&_reportSync);
-
-    delete[] threadHandles;
+    master.analyseWholeProgram();
 
+    _useThreads = false;
     return result;
 }
 
-unsigned int __stdcall ThreadExecutor::threadProc(void *args)
+void ThreadExecutor::threadProc(CppCheck &master, unsigned int &result)
 {
-    unsigned int result = 0;
-
-    ThreadExecutor *threadExecutor = static_cast<ThreadExecutor*>(args);
-    auto &it = threadExecutor->_itNextFile;
-
-    // guard static members of CppCheck against concurrent access
-    EnterCriticalSection(&threadExecutor->_fileSync);
-
-    CppCheck fileChecker(*threadExecutor, false);
-    fileChecker.settings() = threadExecutor->_settings;
-
-    LeaveCriticalSection(&threadExecutor->_fileSync);
+    CppCheck fileChecker(*this, false);
+    {
+        // the suppressions are updated by report() when messages are reported
+        std::lock_guard<std::mutex> lock(_errorSync);
+        fileChecker.settings() = _settings;
+    }
 
     for (;;) {
-
-        EnterCriticalSection(&threadExecutor->_fileSync);
-
-        if (it == threadExecutor->_files.end()) {
-            LeaveCriticalSection(&threadExecutor->_fileSync);
-            return result;
-
+        std::map<std::string, std::size_t>::const_iterator file;
+        {
+            std::lock_guard<std::mutex> lock(_fileSync);
+            if (_nextFile == _queue.size())
+                break;
+            file = _queue[_nextFile++];
         }
-        const std::string &file = it->first;
-        const std::size_t fileSize = it->second;
-        ++it;
-
-        LeaveCriticalSection(&threadExecutor->_fileSync);
 
-        auto fileContent = threadExecutor->_fileContents.find(file);
-        if (fileContent != threadExecutor->_fileContents.end()) {
+        auto fileContent = _fileContents.find(file->first);
+        if (fileContent != _fileContents.end()) {
             // File content was given as a string
-            result += fileChecker.check(file, fileContent->second);
+            result += fileChecker.check(file->first, fileContent->second);
         } else {
             // Read file from a file
-            result += fileChecker.check(file);
+            result += fileChecker.check(file->first);
         }
 
-        EnterCriticalSection(&threadExecutor->_fileSync);
-
-        threadExecutor->_processedSize += fileSize;
-        threadExecutor->_processedFiles++;
-        if (!threadExecutor->_settings._errorsOnly) {
-            EnterCriticalSection(&threadExecutor->_reportSync);
-            CppCheckExecutor::reportStatus(threadExecutor->_processedFiles, threadExecutor->_totalFiles, threadExecutor->_processedSize, threadExecutor->_totalFileSize);
-            LeaveCriticalSection(&threadExecutor->_reportSync);
+        std::lock_guard<std::mutex> lock(_fileSync);
+        _processedSize += file->second;
+        _fileCount++;
+        if (!_settings._errorsOnly) {
+            std::lock_guard<std::mutex> reportLock(_reportSync);
+            CppCheckExecutor::reportStatus(_fileCount, _files.size(), _processedSize, _totalFileSize);
         }
+    }
 
-        LeaveCriticalSection(&threadExecutor->_fileSync);
-    };
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning( disable : 4702 )
-#endif
-    return result;
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-}
-
-void ThreadExecutor::reportOut(const std::string &outmsg)
-{
-    EnterCriticalSection(&_reportSync);
-
-    _errorLogger.reportOut(outmsg);
-
-    LeaveCriticalSection(&_reportSync);
-}
-void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
-{
-    report(msg, REPORT_ERROR);
-}
-
-void ThreadExecutor::reportInfo(const ErrorLogger::ErrorMessage &msg)
-{
-    report(msg, REPORT_INFO);
+    std::lock_guard<std::mutex> lock(_fileSync);
+    master.merge(fileChecker);
 }
 
 void ThreadExecutor::report(const ErrorLogger::ErrorMessage &msg, MessageType msgType)
@@ -497,60 +558,71 @@ void ThreadExecutor::report(const ErrorLogger::ErrorMessage &msg, MessageType ms
         line = msg._callStack.back().line;
     }
 
-    if (_settings.nomsg.isSuppressed(msg._id, file, line))
-        return;
-
     // Alert only about unique errors
-    bool reportError = false;
-    std::string errmsg = msg.toString(_settings._verbose);
-
-    EnterCriticalSection(&_errorSync);
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-        _errorList.push_back(errmsg);
-        reportError = true;
+    const unsigned long long errmsg = msg.hash(_settings._verbose);
+    {
+        std::lock_guard<std::mutex> lock(_errorSync);
+        if (_settings.nomsg.isSuppressed(msg._id, file, line))
+            return;
+        if (!_errorList.insert(errmsg).second)
+            return;
     }
-    LeaveCriticalSection(&_errorSync);
 
-    if (reportError) {
-        EnterCriticalSection(&_reportSync);
-
-        switch (msgType) {
-        case REPORT_ERROR:
-            _errorLogger.reportErr(msg);
-            break;
-        case REPORT_INFO:
-            _errorLogger.reportInfo(msg);
-            break;
-        }
-
-        LeaveCriticalSection(&_reportSync);
+    std::lock_guard<std::mutex> lock(_reportSync);
+    switch (msgType) {
+    case MESSAGE_ERROR:
+        _errorLogger.reportErr(msg);
+        break;
+    case MESSAGE_INFO:
+        _errorLogger.reportInfo(msg);
+        break;
     }
 }
 
-#else
-
-void ThreadExecutor::addFileContent(const std::string &/*path*/, const std::string &/*content*/)
-{
-
-}
+#endif
 
-unsigned int ThreadExecutor::check()
+void ThreadExecutor::reportOut(const std::string &outmsg)
 {
-    return 0;
+#if defined(THREADING_MODEL_THREAD)
+    if (_useThreads) {
+        std::lock_guard<std::mutex> lock(_reportSync);
+        _errorLogger.reportOut(outmsg);
+        return;
+    }
+#endif
+#if defined(THREADING_MODEL_FORK)
+    writeToPipe(REPORT_OUT, outmsg);
+#else
+    (void)outmsg;
+#endif
 }
 
-void ThreadExecutor::reportOut(const std::string &/*outmsg*/)
-{
-
-}
-void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &/*msg*/)
+void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-
+#if defined(THREADING_MODEL_THREAD)
+    if (_useThreads) {
+        report(msg, MESSAGE_ERROR);
+        return;
+    }
+#endif
+#if defined(THREADING_MODEL_FORK)
+    writeToPipe(REPORT_ERROR, msg.serialize());
+#else
+    (void)msg;
+#endif
 }
 
-void ThreadExecutor::reportInfo(const ErrorLogger::ErrorMessage &/*msg*/)
+void ThreadExecutor::reportInfo(const ErrorLogger::ErrorMessage &msg)
 {
-
-}
-
+#if defined(THREADING_MODEL_THREAD)
+    if (_useThreads) {
+        report(msg, MESSAGE_INFO);
+        return;
+    }
+#endif
+#if defined(THREADING_MODEL_FORK)
+    writeToPipe(REPORT_INFO, msg.serialize());
+#else
+    (void)msg;
 #endif
+}
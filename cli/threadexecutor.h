@@ -22,15 +22,21 @@
 #include <map>
 #include <string>
 #include <list>
+#include <unordered_set>
+#include <vector>
 #include "errorlogger.h"
 
 #if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
 #define THREADING_MODEL_FORK
-#elif defined(_WIN32)
-#define THREADING_MODEL_WIN
-#include <windows.h>
+#include <sys/types.h>
 #endif
 
+#if defined(THREADING_MODEL_FORK) || defined(_WIN32)
+#define THREADING_MODEL_THREAD
+#include <mutex>
+#endif
+
+class CppCheck;
 class Settings;
 
 /// @addtogroup CLI
@@ -39,6 +45,12 @@ class Settings;
 /**
  * This class will take a list of filenames and settings and check then
  * all files using threads.
+ *
+ * A fixed number of workers is started once. The workers take files from
+ * a shared queue that is ordered by file size, largest first, so that long
+ * running files are not left until the end. The workers are child
+ * processes (--executor=process, the default where fork() is available)
+ * or threads in this process (--executor=thread).
  */
 class ThreadExecutor : public ErrorLogger {
 public:
@@ -59,32 +71,76 @@ public:
      */
     void addFileContent(const std::string &path, const std::string &content);
 
+    /**
+     * @return true if support for threads exist.
+     */
+    static bool isEnabled() {
+#if defined(THREADING_MODEL_FORK) || defined(THREADING_MODEL_THREAD)
+        return true;
+#else
+        return false;
+#endif
+    }
+
 private:
     const std::map<std::string, std::size_t> &_files;
     Settings &_settings;
     ErrorLogger &_errorLogger;
     unsigned int _fileCount;
 
-#if defined(THREADING_MODEL_FORK)
-
     /** @brief Key is file name, and value is the content of the file */
     std::map<std::string, std::string> _fileContents;
-private:
-    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', CHILD_END='4'};
+
+    /** @brief Hashes of the reported messages, used to filter out duplicates */
+    std::unordered_set<unsigned long long> _errorList;
+
+#if defined(THREADING_MODEL_FORK)
+    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', FILE_END='4', FILE_INFO='5'};
+
+    /** @brief Long-lived child process that checks the files it is given */
+    class Worker {
+    public:
+        Worker() : pid(0), rpipe(-1), cmdpipe(-1) {}
+
+        pid_t pid;
+
+        /** read end of the pipe where the worker reports results */
+        int rpipe;
+
+        /** write end of the pipe where files are handed to the worker */
+        int cmdpipe;
+
+        /** file that is being checked, empty if the worker is idle */
+        std::string file;
+    };
+
+    /** @brief Check the files in child processes */
+    unsigned int checkProcesses();
 
     /**
      * Read from the pipe, parse and handle what ever is in there.
-     *@return -1 in case of error
+     *@return -1 in case of error or if the pipe was closed
      *         0 if there is nothing in the pipe to be read
      *         1 if we did read something
+     *         2 if the worker finished checking its file
+     * The whole program data of the workers is loaded into master.
      */
-    int handleRead(int rpipe, unsigned int &result);
+    int handleRead(int rpipe, unsigned int &result, CppCheck &master);
     void writeToPipe(PipeSignal type, const std::string &data);
+
+    /** @brief Fork a new worker. The worker is added to workers. */
+    void startWorker(std::list<Worker> &workers);
+
+    /** @brief Main loop of a worker: check files until the command pipe is closed */
+    void workerLoop(int cmdpipe);
+
+    /** @brief Hand a file to an idle worker */
+    static void sendFile(Worker &worker, const std::string &file);
+
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
-    std::list<std::string> _errorList;
     int _wpipe;
 
     /**
@@ -93,55 +149,35 @@ private:
      * @return true - if new process can be started
      */
     bool checkLoadAverage(size_t nchildren);
+#endif
+
+#if defined(THREADING_MODEL_THREAD)
+    enum MessageType {MESSAGE_ERROR, MESSAGE_INFO};
+
+    /** @brief Check the files in threads */
+    unsigned int checkThreads();
 
-public:
     /**
-     * @return true if support for threads exist.
+     * @brief Worker thread. The thread uses its own CppCheck instance, its
+     * timer results and whole program data are merged into master when all
+     * files have been checked.
      */
-    static bool isEnabled() {
-        return true;
-    }
+    void threadProc(CppCheck &master, unsigned int &result);
 
-#elif defined(THREADING_MODEL_WIN)
+    void report(const ErrorLogger::ErrorMessage &msg, MessageType msgType);
 
-private:
-    enum MessageType {REPORT_ERROR, REPORT_INFO};
+    /** Are the files checked in threads? Messages are then reported directly instead of through a pipe. */
+    bool _useThreads;
 
-    std::map<std::string, std::string> _fileContents;
-    std::map<std::string, std::size_t>::const_iterator _itNextFile;
-    std::size_t _processedFiles;
-    std::size_t _totalFiles;
+    std::vector<std::map<std::string, std::size_t>::const_iterator> _queue;
+    std::size_t _nextFile;
     std::size_t _processedSize;
     std::size_t _totalFileSize;
-    CRITICAL_SECTION _fileSync;
-
-    std::list<std::string> _errorList;
-    CRITICAL_SECTION _errorSync;
-
-    CRITICAL_SECTION _reportSync;
-
-    void report(const ErrorLogger::ErrorMessage &msg, MessageType msgType);
-
-    static unsigned __stdcall threadProc(void*);
-
-public:
-    /**
-     * @return true if support for threads exist.
-     */
-    static bool isEnabled() {
-        return true;
-    }
-#else
-public:
-    /**
-     * @return true if support for threads exist.
-     */
-    static bool isEnabled() {
-        return false;
-    }
+    std::mutex _fileSync;
+    std::mutex _errorSync;
+    std::mutex _reportSync;
 #endif
 
-private:
     /** disabled copy constructor */
     ThreadExecutor(const ThreadExecutor &);
 
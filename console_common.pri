@@ -7,6 +7,12 @@ win32 {
     LIBS += -lshlwapi
 }
 
+# ThreadExecutor uses std::thread
+unix {
+    CONFIG += thread
+    LIBS += -pthread
+}
+
 # Add more strict compiling flags for GCC
 contains(QMAKE_CXX, g++) {
     QMAKE_CXXFLAGS_WARN_ON += -Wextra -pedantic -Wfloat-equal -Wcast-qual -Wlogical-op -Wno-long-long
@@ -0,0 +1,189 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysiscache.h"
+#include "settings.h"
+#include "version.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+AnalysisCache::AnalysisCache(const std::string &dir, const Settings &settings)
+    : _dir(dir), _fingerprint(fingerprint(settings))
+{
+    if (!_dir.empty() && _dir[_dir.size() - 1U] != '/' && _dir[_dir.size() - 1U] != '\\')
+        _dir += '/';
+}
+
+bool AnalysisCache::isUsable(const Settings &settings)
+{
+    if (settings.debug || settings.debugwarnings || settings.debugFalsePositive || settings.dump)
+        return false;
+
+    // Results depend on the changed lines
+    if (!settings._changedLines.empty())
+        return false;
+
+    return true;
+}
+
+unsigned long long AnalysisCache::hash(const std::string &data, unsigned long long h)
+{
+    for (std::string::size_type i = 0; i < data.size(); ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string AnalysisCache::fingerprint(const Settings &settings)
+{
+    std::ostringstream ostr;
+    ostr << "seccheck " << CPPCHECK_VERSION_STRING << '\n';
+
+    const std::set<std::string> &enabled = settings.enabled();
+    for (auto it = enabled.begin(); it != enabled.end(); ++it)
+        ostr << "enable " << *it << '\n';
+
+    ostr << "inconclusive " << settings.inconclusive << '\n'
+         << "experimental " << settings.experimental << '\n'
+         << "force " << settings._force << ' ' << settings._maxConfigs << '\n'
+         << "language " << static_cast<int>(settings.enforcedLang) << '\n'
+         << "std " << static_cast<int>(settings.standards.c) << ' ' << static_cast<int>(settings.standards.cpp) << ' ' << settings.standards.posix << '\n'
+         << "platform " << static_cast<int>(settings.platformType)
+         << ' ' << settings.sizeof_bool << ' ' << settings.sizeof_short << ' ' << settings.sizeof_int
+         << ' ' << settings.sizeof_long << ' ' << settings.sizeof_long_long << ' ' << settings.sizeof_float
+         << ' ' << settings.sizeof_double << ' ' << settings.sizeof_long_double << ' ' << settings.sizeof_wchar_t
+         << ' ' << settings.sizeof_size_t << ' ' << settings.sizeof_pointer << '\n'
+         << "checkLibrary " << settings.checkLibrary << '\n';
+
+    for (auto it = settings._basePaths.begin(); it != settings._basePaths.end(); ++it)
+        ostr << "basepath " << *it << '\n';
+
+    for (auto it = settings.rules.begin(); it != settings.rules.end(); ++it)
+        ostr << "rule " << it->tokenlist << ' ' << it->id << ' ' << it->severity << ' ' << it->pattern << ' ' << it->summary << '\n';
+
+    // Library configurations. The content is hashed so changes in a cfg invalidate the cache.
+    const std::set<std::string> &files = settings.library.files();
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        std::ifstream fin(it->c_str(), std::ios::in | std::ios::binary);
+        std::ostringstream content;
+        content << fin.rdbuf();
+        ostr << "library " << *it << ' ' << std::hex << hash(content.str()) << std::dec << '\n';
+    }
+
+    return ostr.str();
+}
+
+std::string AnalysisCache::key(const std::string &code, const std::string &filename, const std::string &cfg) const
+{
+    std::string data;
+    data.reserve(_fingerprint.size() + filename.size() + cfg.size() + code.size() + 2U);
+    data += _fingerprint;
+    data += filename;
+    data += '\n';
+    data += cfg;
+    data += '\n';
+    data += code;
+
+    // Two hashes with different offset basis => 128 bit key
+    std::ostringstream ostr;
+    ostr << std::hex;
+    ostr.width(16);
+    ostr.fill('0');
+    ostr << hash(data);
+    ostr.width(16);
+    ostr << hash(data, 0x84222325cbf29ce4ULL);
+    return ostr.str();
+}
+
+std::string AnalysisCache::filename(const std::string &key) const
+{
+    return _dir + key + ".cache";
+}
+
+bool AnalysisCache::load(const std::string &key, Entry &entry) const
+{
+    std::ifstream fin(filename(key).c_str(), std::ios::in | std::ios::binary);
+    if (!fin.is_open())
+        return false;
+
+    std::string header;
+    if (!std::getline(fin, header) || header != "seccheck-cache 3")
+        return false;
+
+    std::size_t count = 0;
+    if (!(fin >> entry.hasChecksum >> entry.checksum >> entry.checksumMessages >> count))
+        return false;
+
+    entry.messages.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string::size_type len = 0;
+        if (!(fin >> len) || fin.get() != ' ')
+            return false;
+        std::string data(len, '\0');
+        if (len > 0 && !fin.read(&data[0], (std::streamsize)len))
+            return false;
+        // deserialize() fails for messages without location even though the message is read
+        ErrorLogger::ErrorMessage msg;
+        msg.deserialize(data);
+        entry.messages.push_back(msg);
+    }
+
+    std::string::size_type len = 0;
+    if (!(fin >> len) || fin.get() != ' ')
+        return false;
+    entry.fileInfo.assign(len, '\0');
+    if (len > 0 && !fin.read(&entry.fileInfo[0], (std::streamsize)len))
+        return false;
+
+    return true;
+}
+
+void AnalysisCache::store(const std::string &key, const Entry &entry) const
+{
+    // Write to a temporary file first so a concurrent reader never sees a partial entry
+    const std::string cachefile(filename(key));
+    const std::string tempfile(cachefile + ".tmp");
+    {
+        std::ofstream fout(tempfile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!fout.is_open())
+            return;
+
+        fout << "seccheck-cache 3\n"
+             << entry.hasChecksum << ' ' << entry.checksum << ' ' << entry.checksumMessages << ' ' << entry.messages.size() << '\n';
+        for (auto it = entry.messages.begin(); it != entry.messages.end(); ++it) {
+            const std::string data(it->serialize());
+            fout << data.size() << ' ' << data << '\n';
+        }
+        fout << entry.fileInfo.size() << ' ' << entry.fileInfo << '\n';
+        if (!fout.good()) {
+            fout.close();
+            std::remove(tempfile.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(tempfile.c_str(), cachefile.c_str()) != 0) {
+        // rename does not replace existing files on all platforms
+        std::remove(cachefile.c_str());
+        if (std::rename(tempfile.c_str(), cachefile.c_str()) != 0)
+            std::remove(tempfile.c_str());
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef analysiscacheH
+#define analysiscacheH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "errorlogger.h"
+
+#include <list>
+#include <string>
+
+class Settings;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief On-disk cache of analysis results (--cache-dir).
+ *
+ * Each entry holds the messages that were reported while checking one
+ * preprocessor configuration of one file, and the file info for the whole
+ * program analysis. An entry is keyed by a hash of
+ * the preprocessed code, the file name, the configuration and a fingerprint
+ * of everything else that can change the result (seccheck version,
+ * settings and the loaded library configurations).
+ */
+class CPPCHECKLIB AnalysisCache {
+public:
+    /** @brief Cached result for one configuration */
+    class Entry {
+    public:
+        Entry() : hasChecksum(false), checksum(0), checksumMessages(0) {}
+
+        /** is checksum valid? It is only calculated when several configurations are checked */
+        bool hasChecksum;
+
+        /** token list checksum, used to skip configurations that produce the same code */
+        unsigned long long checksum;
+
+        /** number of messages that were reported before the checksum was calculated */
+        std::size_t checksumMessages;
+
+        /** reported messages, in the order they were reported */
+        std::list<ErrorLogger::ErrorMessage> messages;
+
+        /** file info for whole program analysis, see CppCheck::fileInfoToString() */
+        std::string fileInfo;
+    };
+
+    AnalysisCache(const std::string &dir, const Settings &settings);
+
+    /**
+     * @brief Can results be cached with the given settings?
+     * Debug output, dumps and results that depend on --diff are not stored
+     * in the cache so the cache is disabled when these are used.
+     */
+    static bool isUsable(const Settings &settings);
+
+    /** @brief Get cache key for the given preprocessed code */
+    std::string key(const std::string &code, const std::string &filename, const std::string &cfg) const;
+
+    /**
+     * @brief Load cached result
+     * @param key cache key
+     * @param entry the loaded entry
+     * @return true if there was a valid entry
+     */
+    bool load(const std::string &key, Entry &entry) const;
+
+    /** @brief Store result */
+    void store(const std::string &key, const Entry &entry) const;
+
+    /** @brief 64-bit FNV-1a hash */
+    static unsigned long long hash(const std::string &data, unsigned long long h = 14695981039346656037ULL);
+
+    /** @brief Fingerprint of seccheck version, settings and loaded library files */
+    static std::string fingerprint(const Settings &settings);
+
+private:
+    std::string filename(const std::string &key) const;
+
+    /** cache folder, with trailing '/' */
+    std::string _dir;
+
+    /** fingerprint of settings used to create the results */
+    const std::string _fingerprint;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // analysiscacheH
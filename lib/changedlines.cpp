@@ -0,0 +1,185 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "changedlines.h"
+#include "path.h"
+
+#include <cctype>
+
+static std::string simplifyFileName(const std::string &file)
+{
+    return Path::simplifyPath(Path::fromNativeSeparators(file));
+}
+
+static bool endsWith(const std::string &str, const std::string &end)
+{
+    return str.size() > end.size() && str[str.size() - end.size() - 1U] == '/' &&
+           str.compare(str.size() - end.size(), end.size(), end) == 0;
+}
+
+/** Parse "<start>[,<count>]" of a hunk header */
+static bool parseRange(const std::string &line, std::string::size_type &pos, unsigned int &start, unsigned int &count)
+{
+    if (pos >= line.size() || !std::isdigit(static_cast<unsigned char>(line[pos])))
+        return false;
+    start = 0;
+    while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos])))
+        start = start * 10U + (unsigned int)(line[pos++] - '0');
+    count = 1;
+    if (pos < line.size() && line[pos] == ',') {
+        ++pos;
+        if (pos >= line.size() || !std::isdigit(static_cast<unsigned char>(line[pos])))
+            return false;
+        count = 0;
+        while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos])))
+            count = count * 10U + (unsigned int)(line[pos++] - '0');
+    }
+    return true;
+}
+
+std::string ChangedLines::parseDiff(std::istream &istr)
+{
+    std::string file;
+    unsigned int newLine = 0;
+    unsigned int oldRemaining = 0;
+    unsigned int newRemaining = 0;
+
+    std::string line;
+    while (std::getline(istr, line)) {
+        if (!line.empty() && line[line.size() - 1U] == '\r')
+            line.erase(line.size() - 1U);
+
+        // Lines of a hunk
+        if (oldRemaining > 0 || newRemaining > 0) {
+            const char c = line.empty() ? ' ' : line[0];
+            if (c == '+') {
+                if (!file.empty())
+                    add(file, newLine, newLine);
+                ++newLine;
+                if (newRemaining > 0)
+                    --newRemaining;
+            } else if (c == '-') {
+                // A removed line changes the lines around it
+                if (!file.empty())
+                    add(file, newLine > 1U ? newLine - 1U : 1U, newLine);
+                if (oldRemaining > 0)
+                    --oldRemaining;
+            } else if (c == ' ') {
+                ++newLine;
+                if (oldRemaining > 0)
+                    --oldRemaining;
+                if (newRemaining > 0)
+                    --newRemaining;
+            } else if (c != '\\') {
+                return "seccheck: error: unexpected line in diff hunk: '" + line + "'.";
+            }
+            continue;
+        }
+
+        if (line.compare(0, 4, "+++ ") == 0) {
+            file = line.substr(4);
+            const std::string::size_type tab = file.find('\t');
+            if (tab != std::string::npos)
+                file.erase(tab);
+            if (file == "/dev/null")
+                file.clear();
+            else if (file.compare(0, 2, "b/") == 0)
+                file.erase(0, 2);
+        } else if (line.compare(0, 4, "@@ -") == 0) {
+            std::string::size_type pos = 4;
+            unsigned int oldStart;
+            bool valid = parseRange(line, pos, oldStart, oldRemaining) && line.compare(pos, 2, " +") == 0;
+            pos += 2;
+            valid = valid && parseRange(line, pos, newLine, newRemaining);
+            if (!valid)
+                return "seccheck: error: invalid hunk header in diff: '" + line + "'.";
+
+            // The start of an empty range is the line before it
+            if (newRemaining == 0)
+                ++newLine;
+        }
+    }
+
+    return "";
+}
+
+void ChangedLines::add(const std::string &file, unsigned int first, unsigned int last)
+{
+    Ranges &ranges = _ranges[simplifyFileName(file)];
+
+    // Extend the last range when lines are added one by one
+    if (!ranges.empty() && first >= ranges.back().first && first <= ranges.back().second + 1U) {
+        if (last > ranges.back().second)
+            ranges.back().second = last;
+        return;
+    }
+
+    // Ranges that are covered already are not added again
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        if (it->first <= first && last <= it->second)
+            return;
+    }
+    ranges.push_back(std::make_pair(first, last));
+}
+
+void ChangedLines::add(const ChangedLines &other)
+{
+    for (auto it = other._ranges.begin(); it != other._ranges.end(); ++it) {
+        for (auto r = it->second.begin(); r != it->second.end(); ++r)
+            add(it->first, r->first, r->second);
+    }
+}
+
+const ChangedLines::Ranges *ChangedLines::ranges(const std::string &file) const
+{
+    const std::string name(simplifyFileName(file));
+    auto it = _ranges.find(name);
+    if (it != _ranges.end())
+        return &it->second;
+    for (it = _ranges.begin(); it != _ranges.end(); ++it) {
+        if (endsWith(it->first, name) || endsWith(name, it->first))
+            return &it->second;
+    }
+    return nullptr;
+}
+
+bool ChangedLines::hasFile(const std::string &file) const
+{
+    return ranges(file) != nullptr;
+}
+
+bool ChangedLines::overlaps(const std::string &file, unsigned int first, unsigned int last) const
+{
+    const Ranges *r = ranges(file);
+    if (!r)
+        return false;
+    for (auto it = r->begin(); it != r->end(); ++it) {
+        if (first <= it->second && it->first <= last)
+            return true;
+    }
+    return false;
+}
+
+bool ChangedLines::overlaps(const ErrorLogger::ErrorMessage &msg) const
+{
+    for (auto it = msg._callStack.begin(); it != msg._callStack.end(); ++it) {
+        if (overlaps(it->getfile(false), it->line, it->line))
+            return true;
+    }
+    return false;
+}
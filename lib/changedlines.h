@@ -0,0 +1,84 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef changedlinesH
+#define changedlinesH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "errorlogger.h"
+
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Line ranges of files, used for checking only what a diff changed (--diff).
+ *
+ * File names are compared after the path is simplified. A file name also
+ * matches when one of the names is a path suffix of the other, so
+ * relative names in a diff match absolute names given on the command line.
+ */
+class CPPCHECKLIB ChangedLines {
+public:
+    /**
+     * @brief Add the lines that are added or removed by a unified diff.
+     * The "b/" prefix that git adds to the new file name is removed.
+     * @param istr unified diff
+     * @return error message. empty upon success
+     */
+    std::string parseDiff(std::istream &istr);
+
+    /** @brief Add the lines first..last of the file */
+    void add(const std::string &file, unsigned int first, unsigned int last);
+
+    /** @brief Add all line ranges of another object */
+    void add(const ChangedLines &other);
+
+    /** @brief Are there no line ranges? */
+    bool empty() const {
+        return _ranges.empty();
+    }
+
+    /** @brief Are there line ranges for the file? */
+    bool hasFile(const std::string &file) const;
+
+    /** @brief Do the lines first..last of the file overlap a line range? */
+    bool overlaps(const std::string &file, unsigned int first, unsigned int last) const;
+
+    /** @brief Is any location of the message in a line range? */
+    bool overlaps(const ErrorLogger::ErrorMessage &msg) const;
+
+private:
+    typedef std::vector<std::pair<unsigned int, unsigned int> > Ranges;
+
+    const Ranges *ranges(const std::string &file) const;
+
+    /** line ranges for each simplified file name */
+    std::map<std::string, Ranges> _ranges;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // changedlinesH
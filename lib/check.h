@@ -30,6 +30,8 @@
 #include <list>
 #include <set>
 
+class TokenDispatcher;
+
 /// @addtogroup Core
 /// @{
 
@@ -62,6 +64,20 @@ public:
     /** run checks, the token list is simplified */
     virtual void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) = 0;
 
+    /**
+     * @brief Register simplified checks that only look at tokens with given names.
+     * The checks add callbacks to the dispatcher instead of walking the
+     * function scopes themselves, the dispatcher owns the check instance.
+     * @return true if the checks were registered, runSimplifiedChecks() is not called then
+     */
+    virtual bool registerSimplifiedChecks(TokenDispatcher &dispatcher, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) {
+        (void)dispatcher;
+        (void)tokenizer;
+        (void)settings;
+        (void)errorLogger;
+        return false;
+    }
+
     /** get error messages */
     virtual void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const = 0;
 
@@ -90,6 +106,11 @@ public:
     public:
         FileInfo() {}
         virtual ~FileInfo() {}
+
+        /** @brief Serialize, empty if the file info can't be loaded with loadFileInfo() */
+        virtual std::string toString() const {
+            return std::string();
+        }
     };
 
     virtual FileInfo * getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const {
@@ -98,6 +119,12 @@ public:
         return nullptr;
     }
 
+    /** @brief Load file info that was serialized with FileInfo::toString() */
+    virtual FileInfo * loadFileInfo(const std::string &data) const {
+        (void)data;
+        return nullptr;
+    }
+
     virtual void analyseWholeProgram(const std::list<FileInfo*> &fileInfo, ErrorLogger &errorLogger) {
         (void)fileInfo;
         (void)errorLogger;
@@ -1448,6 +1448,7 @@ MathLib::bigint CheckBufferOverrun::countSprintfLength(const std::string &input_
             case 'X':
             case 'i':
                 i_d_x_f_found = true;
+                // fallthrough
             case 'c':
             case 'e':
             case 'E':
@@ -1909,6 +1910,40 @@ Check::FileInfo* CheckBufferOverrun::getFileInfo(const Tokenizer *tokenizer, con
     return fileInfo;
 }
 
+std::string CheckBufferOverrun::MyFileInfo::toString() const
+{
+    std::ostringstream ostr;
+    for (std::map<std::string, struct ArrayUsage>::const_iterator it = arrayUsage.begin(); it != arrayUsage.end(); ++it)
+        ostr << "u " << it->second.index << ' ' << it->second.linenr << ' ' << it->first << ' ' << it->second.fileName << '\n';
+    for (std::map<std::string, MathLib::bigint>::const_iterator it = arraySize.begin(); it != arraySize.end(); ++it)
+        ostr << "s " << it->second << ' ' << it->first << '\n';
+    return ostr.str();
+}
+
+Check::FileInfo *CheckBufferOverrun::loadFileInfo(const std::string &data) const
+{
+    MyFileInfo *fileInfo = new MyFileInfo;
+    std::istringstream istr(data);
+    std::string line;
+    while (std::getline(istr, line)) {
+        std::istringstream iline(line);
+        char type = 0;
+        std::string name;
+        if (line.compare(0, 2, "u ") == 0) {
+            struct MyFileInfo::ArrayUsage arrayUsage;
+            if (!(iline >> type >> arrayUsage.index >> arrayUsage.linenr >> name) || iline.get() != ' ')
+                continue;
+            std::getline(iline, arrayUsage.fileName);
+            fileInfo->arrayUsage[name] = arrayUsage;
+        } else if (line.compare(0, 2, "s ") == 0) {
+            MathLib::bigint size = 0;
+            if (iline >> type >> size >> name)
+                fileInfo->arraySize[name] = size;
+        }
+    }
+    return fileInfo;
+}
+
 void CheckBufferOverrun::analyseWholeProgram(const std::list<Check::FileInfo*> &fileInfo, ErrorLogger &errorLogger)
 {
     // Merge all fileInfo
@@ -217,11 +217,17 @@ public:
 
         /* key:arrayName, data:arraySize */
         std::map<std::string, MathLib::bigint>  arraySize;
+
+        /** Serialize, one "u <index> <line> <name> <file>" or "s <size> <name>" line per entry */
+        std::string toString() const;
     };
 
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const;
 
+    /** @brief Load file info that was serialized with MyFileInfo::toString() */
+    Check::FileInfo *loadFileInfo(const std::string &data) const;
+
     /** @brief Analyse all file infos for all TU */
     void analyseWholeProgram(const std::list<Check::FileInfo*> &fileInfo, ErrorLogger &errorLogger);
 
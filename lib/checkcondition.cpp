@@ -252,7 +252,7 @@ void CheckCondition::comparisonError(const Token *tok, const std::string &bitop,
     reportError(tok, Severity::style, "comparisonError", errmsg);
 }
 
-static bool isOverlappingCond(const Token * const cond1, const Token * const cond2, const std::set<std::string> &constFunctions)
+static bool isOverlappingCond(const Token * const cond1, const Token * const cond2, const std::unordered_set<std::string> &constFunctions)
 {
     if (!cond1 || !cond2)
         return false;
@@ -334,7 +334,7 @@ void CheckCondition::multiConditionError(const Token *tok, unsigned int line1)
 // Detect oppositing inner and outer conditions
 //---------------------------------------------------------------------------
 
-static bool isOppositeCond(const Token * const cond1, const Token * const cond2, const std::set<std::string> &constFunctions)
+static bool isOppositeCond(const Token * const cond1, const Token * const cond2, const std::unordered_set<std::string> &constFunctions)
 {
     if (!cond1 || !cond2)
         return false;
@@ -204,12 +204,18 @@ CheckMemoryLeak::AllocType CheckMemoryLeak::getAllocationType(const Token *tok2,
     if (callstack && std::find(callstack->begin(), callstack->end(), func) != callstack->end())
         return No;
 
-    std::list<const Function*> cs;
-    if (!callstack)
-        callstack = &cs;
+    if (callstack) {
+        callstack->push_back(func);
+        return functionReturnType(func, callstack);
+    }
 
-    callstack->push_back(func);
-    return functionReturnType(func, callstack);
+    // Without a call stack the result only depends on the function
+    auto it = _functionReturnTypes.find(func);
+    if (it == _functionReturnTypes.end()) {
+        std::list<const Function*> cs(1U, func);
+        it = _functionReturnTypes.insert(std::make_pair(func, functionReturnType(func, &cs))).first;
+    }
+    return it->second;
 }
 
 
@@ -2490,13 +2496,10 @@ bool CheckMemoryLeakStructMember::isMalloc(const Variable *variable)
 void CheckMemoryLeakStructMember::checkStructVariable(const Variable * const variable)
 {
     // This should be in the CheckMemoryLeak base class
-    static std::set<std::string> ignoredFunctions;
-    if (ignoredFunctions.empty()) {
-        ignoredFunctions.insert("if");
-        ignoredFunctions.insert("for");
-        ignoredFunctions.insert("while");
-        ignoredFunctions.insert("malloc");
-    }
+    static const char* _ignoredFunctions[] = {
+        "if", "for", "while", "malloc"
+    };
+    static const std::set<std::string> ignoredFunctions(_ignoredFunctions, _ignoredFunctions + sizeof(_ignoredFunctions)/sizeof(*_ignoredFunctions));
 
     // Is struct variable a pointer?
     if (variable->isPointer()) {
@@ -36,6 +36,7 @@
 #include "check.h"
 
 #include <list>
+#include <map>
 #include <string>
 
 class Scope;
@@ -158,6 +159,14 @@ public:
 
     /** Function allocates pointed-to argument (a la asprintf)? */
     const char *functionArgAlloc(const Function *func, unsigned int targetpar, AllocType &allocType) const;
+
+private:
+    /**
+     * Return types of functions that are called, so a function body is
+     * only analysed once no matter how many calls there are. Only results
+     * that don't depend on the call stack are saved, see getAllocationType().
+     */
+    mutable std::map<const Function *, AllocType> _functionReturnTypes;
 };
 
 /// @}
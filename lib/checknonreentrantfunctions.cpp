@@ -32,38 +32,43 @@ namespace {
 }
 
 void CheckNonReentrantFunctions::nonReentrantFunctions()
+{
+    TokenDispatcher dispatcher;
+    registerNonReentrantFunctions(dispatcher);
+    dispatcher.dispatch(_tokenizer->getSymbolDatabase());
+}
+
+void CheckNonReentrantFunctions::registerNonReentrantFunctions(TokenDispatcher &dispatcher)
 {
     if (!_settings->standards.posix || !_settings->isEnabled("portability"))
         return;
 
-    const SymbolDatabase * const symbolDatabase = _tokenizer->getSymbolDatabase();
-    const std::size_t functions = symbolDatabase->functionScopes.size();
-    for (std::size_t i = 0; i < functions; ++i) {
-        const Scope * scope = symbolDatabase->functionScopes[i];
-        for (const Token *tok = scope->classStart->next(); tok != scope->classEnd; tok = tok->next()) {
-            // Look for function invocations
-            if (tok->varId() != 0 || !tok->isName() || tok->strAt(1) != "(")
-                continue;
-
-            // Check for non-reentrant function name
-        auto it = _nonReentrantFunctions.find(tok->str());
-            if (it == _nonReentrantFunctions.end())
-                continue;
+    const TokenDispatcher::Callback callback = [this](const Token *tok) {
+        nonReentrantFunctionCall(tok);
+    };
+    for (auto it = _nonReentrantFunctions.begin(); it != _nonReentrantFunctions.end(); ++it)
+        dispatcher.addTrigger(it->first, callback);
+}
 
-            const Token *prev = tok->previous();
-            if (prev) {
-                // Ignore function definitions, class members or class definitions
-                if (prev->str() == ".")
-                    continue;
+void CheckNonReentrantFunctions::nonReentrantFunctionCall(const Token *tok)
+{
+    // Look for function invocations
+    if (tok->varId() != 0 || tok->strAt(1) != "(")
+        return;
 
-                // Check for "std" or global namespace, ignore other namespaces
-                if (prev->str() == "::" && prev->previous() && prev->previous()->str() != "std" && prev->previous()->isName())
-                    continue;
-            }
+    const Token *prev = tok->previous();
+    if (prev) {
+        // Ignore function definitions, class members or class definitions
+        if (prev->str() == ".")
+            return;
 
-            // Only affecting multi threaded code, therefore this is "portability"
-            reportError(tok, Severity::portability, "nonreentrantFunctions" + it->first, it->second);
-        }
+        // Check for "std" or global namespace, ignore other namespaces
+        if (prev->str() == "::" && prev->previous() && prev->previous()->str() != "std" && prev->previous()->isName())
+            return;
     }
+
+    // Only affecting multi threaded code, therefore this is "portability"
+    auto it = _nonReentrantFunctions.find(tok->str());
+    reportError(tok, Severity::portability, "nonreentrantFunctions" + it->first, it->second);
 }
 //---------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 
 #include "config.h"
 #include "check.h"
+#include "tokendispatcher.h"
 #include <string>
 #include <map>
 
@@ -52,10 +53,22 @@ public:
         checkNonReentrantFunctions.nonReentrantFunctions();
     }
 
+    bool registerSimplifiedChecks(TokenDispatcher &dispatcher, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) {
+        CheckNonReentrantFunctions *checkNonReentrantFunctions = new CheckNonReentrantFunctions(tokenizer, settings, errorLogger);
+        dispatcher.addCheck(checkNonReentrantFunctions);
+        checkNonReentrantFunctions->registerNonReentrantFunctions(dispatcher);
+        return true;
+    }
+
     /** Check for non reentrant functions */
     void nonReentrantFunctions();
 
 private:
+    /** add the non reentrant function names as triggers */
+    void registerNonReentrantFunctions(TokenDispatcher &dispatcher);
+
+    /** check a token with the name of a non reentrant function */
+    void nonReentrantFunctionCall(const Token *tok);
 
     /* function name / error message */
     std::map<std::string,std::string> _nonReentrantFunctions;
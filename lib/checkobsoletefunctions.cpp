@@ -32,6 +32,13 @@ namespace {
 }
 
 void CheckObsoleteFunctions::obsoleteFunctions()
+{
+    TokenDispatcher dispatcher;
+    registerObsoleteFunctions(dispatcher);
+    dispatcher.dispatch(_tokenizer->getSymbolDatabase());
+}
+
+void CheckObsoleteFunctions::registerObsoleteFunctions(TokenDispatcher &dispatcher)
 {
     if (!_settings->isEnabled("style"))
         return;
@@ -46,32 +53,48 @@ void CheckObsoleteFunctions::obsoleteFunctions()
         _obsoleteC99Functions.erase(scope->className);
     }
 
-    for (unsigned int i = 0; i < symbolDatabase->functionScopes.size(); i++) {
-        const Scope* scope = symbolDatabase->functionScopes[i];
-        for (const Token* tok = scope->classStart; tok != scope->classEnd; tok = tok->next()) {
-            if (tok->isName() && tok->varId()==Token::eVariable && (tok->next() && tok->next()->str() == "(") &&
-                (!Token::Match(tok->previous(), ".|::") || Token::simpleMatch(tok->tokAt(-2), "std ::"))) {
+    std::set<std::string> names;
+    for (auto it = _obsoleteStandardFunctions.begin(); it != _obsoleteStandardFunctions.end(); ++it)
+        names.insert(it->first);
+    if (_settings->standards.posix) {
+        for (auto it = _obsoletePosixFunctions.begin(); it != _obsoletePosixFunctions.end(); ++it)
+            names.insert(it->first);
+    }
+    if (_settings->standards.c >= Standards::C99) {
+        for (auto it = _obsoleteC99Functions.begin(); it != _obsoleteC99Functions.end(); ++it)
+            names.insert(it->first);
+    }
 
-                auto it = _obsoleteStandardFunctions.find(tok->str());
-                if (it != _obsoleteStandardFunctions.end()) {
-                    // If checking an old code base it might be uninteresting to update obsolete functions.
-                    reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
-                } else {
-                    if (_settings->standards.posix) {
-                        it = _obsoletePosixFunctions.find(tok->str());
-                        if (it != _obsoletePosixFunctions.end()) {
-                            // If checking an old code base it might be uninteresting to update obsolete functions.
-                            reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
-                        }
-                    }
-                    if (_settings->standards.c >= Standards::C99) {
-                        // alloca : this function is obsolete in C but not in C++ (#4382)
-                        it = _obsoleteC99Functions.find(tok->str());
-                        if (it != _obsoleteC99Functions.end() && !(tok->str() == "alloca" && _tokenizer->isCPP())) {
-                            reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
-                        }
-                    }
-                }
+    const TokenDispatcher::Callback callback = [this](const Token *tok) {
+        obsoleteFunctionCall(tok);
+    };
+    for (auto it = names.begin(); it != names.end(); ++it)
+        dispatcher.addTrigger(*it, callback);
+}
+
+void CheckObsoleteFunctions::obsoleteFunctionCall(const Token *tok)
+{
+    if (!(tok->varId()==Token::eVariable && (tok->next() && tok->next()->str() == "(") &&
+          (!Token::Match(tok->previous(), ".|::") || Token::simpleMatch(tok->tokAt(-2), "std ::"))))
+        return;
+
+    auto it = _obsoleteStandardFunctions.find(tok->str());
+    if (it != _obsoleteStandardFunctions.end()) {
+        // If checking an old code base it might be uninteresting to update obsolete functions.
+        reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
+    } else {
+        if (_settings->standards.posix) {
+            it = _obsoletePosixFunctions.find(tok->str());
+            if (it != _obsoletePosixFunctions.end()) {
+                // If checking an old code base it might be uninteresting to update obsolete functions.
+                reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
+            }
+        }
+        if (_settings->standards.c >= Standards::C99) {
+            // alloca : this function is obsolete in C but not in C++ (#4382)
+            it = _obsoleteC99Functions.find(tok->str());
+            if (it != _obsoleteC99Functions.end() && !(tok->str() == "alloca" && _tokenizer->isCPP())) {
+                reportError(tok, Severity::style, "obsoleteFunctions"+it->first, it->second);
             }
         }
     }
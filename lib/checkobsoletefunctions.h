@@ -24,6 +24,7 @@
 
 #include "config.h"
 #include "check.h"
+#include "tokendispatcher.h"
 #include <string>
 #include <map>
 
@@ -53,10 +54,23 @@ public:
         checkObsoleteFunctions.obsoleteFunctions();
     }
 
+    bool registerSimplifiedChecks(TokenDispatcher &dispatcher, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) {
+        CheckObsoleteFunctions *checkObsoleteFunctions = new CheckObsoleteFunctions(tokenizer, settings, errorLogger);
+        dispatcher.addCheck(checkObsoleteFunctions);
+        checkObsoleteFunctions->registerObsoleteFunctions(dispatcher);
+        return true;
+    }
+
     /** Check for obsolete functions */
     void obsoleteFunctions();
 
 private:
+    /** add the obsolete function names as triggers */
+    void registerObsoleteFunctions(TokenDispatcher &dispatcher);
+
+    /** check a token with the name of an obsolete function */
+    void obsoleteFunctionCall(const Token *tok);
+
     /* function name / error message */
     std::map<std::string, std::string> _obsoleteStandardFunctions;
     std::map<std::string, std::string> _obsoletePosixFunctions;
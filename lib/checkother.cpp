@@ -59,7 +59,7 @@ bool astIsFloat(const Token *tok, bool unknown)
 	return unknown;
 }
 
-static bool isConstExpression(const Token *tok, const std::set<std::string> &constFunctions)
+static bool isConstExpression(const Token *tok, const std::unordered_set<std::string> &constFunctions)
 {
 	if (!tok)
 		return true;
@@ -77,7 +77,7 @@ static bool isConstExpression(const Token *tok, const std::set<std::string> &con
 	return isConstExpression(tok->astOperand1(),constFunctions) && isConstExpression(tok->astOperand2(),constFunctions);
 }
 
-bool isSameExpression(const Token *tok1, const Token *tok2, const std::set<std::string> &constFunctions)
+bool isSameExpression(const Token *tok1, const Token *tok2, const std::unordered_set<std::string> &constFunctions)
 {
 	if (tok1 == nullptr && tok2 == nullptr)
 		return true;
@@ -25,11 +25,13 @@
 #include "config.h"
 #include "check.h"
 
+#include <unordered_set>
+
 class Function;
 class Variable;
 
 /** Is expressions same? */
-bool isSameExpression(const Token *tok1, const Token *tok2, const std::set<std::string> &constFunctions);
+bool isSameExpression(const Token *tok1, const Token *tok2, const std::unordered_set<std::string> &constFunctions);
 
 /** Is expression of floating point type? */
 bool astIsFloat(const Token *tok, bool unknown);
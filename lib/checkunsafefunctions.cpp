@@ -37,31 +37,10 @@ static bool isNotMemberFunction(const Token* tok)
 	return (!Token::Match(tok->previous(), ".|::") || Token::simpleMatch(tok->tokAt(-2), "std ::"));
 }
 
-/** Check for suspicious variable names. eg: 'password', 'pwd' */
-class SuspiciousNames
-{
-public:
-	SuspiciousNames()
-	{
-		_Containers.insert("password");
-		_Containers.insert("pwd");
-		_Containers.insert("passwd");
-	}
-
-	bool isBadName(const std::string& para) const
-	{
-		return _Containers.find(para) != _Containers.end();
-	}
-
-private:
-	std::set<std::string> _Containers;
+/** Suspicious variable names. eg: 'password', 'pwd' */
+static const char * const suspiciousNames[] = {
+	"password", "pwd", "passwd"
 };
-
-static bool isSuspiciousName(const std::string& para)
-{
-	static SuspiciousNames names;
-	return names.isBadName(para);
-}
 }
 
 bool CheckUnsafeFunctions::isWinExecuteFunction(const Token* tok)
@@ -79,6 +58,13 @@ static bool isFunctionCall(const Token* tok)
 }
 
 void CheckUnsafeFunctions::unsafeFunctions()
+{
+    TokenDispatcher dispatcher;
+    registerUnsafeFunctions(dispatcher);
+    dispatcher.dispatch(_tokenizer->getSymbolDatabase());
+}
+
+void CheckUnsafeFunctions::registerUnsafeFunctions(TokenDispatcher &dispatcher)
 {
     const SymbolDatabase *symbolDatabase = _tokenizer->getSymbolDatabase();
 
@@ -88,35 +74,42 @@ void CheckUnsafeFunctions::unsafeFunctions()
         _unsafeFunctions.erase(scope->className);
     }
 
-    for (unsigned int i = 0; i < symbolDatabase->functionScopes.size(); i++) {
-        const Scope* scope = symbolDatabase->functionScopes[i];
-        for (const Token* tok = scope->classStart; tok != scope->classEnd; tok = tok->next()) {
-			// Only check cpp file for unsafe functions
-            if (_tokenizer->isCPP() && isFunctionCall(tok)) {
-
-                auto it = _unsafeFunctions.find(tok->str());
-                if (it != _unsafeFunctions.end()) {
-                    // If checking an old code base it might be uninteresting to update unsafe functions.
-                    reportError(tok, Severity::style, "unsafeFunctions"+it->first, it->second);
-                }
-            }
-
-			if ((tok->type() == Token::eVariable) && isSuspiciousName(tok->str())) {
-				//
-                reportError(tok, Severity::style,
-					"suspiciousVariableName:"+tok->str(), "Suspicious variable name: "
-					+ tok->str() + " maybe identify the hard-coded password.\n"
-					+ "Hard coded passwords are like backdoor access to the system, "
-					+ "so it should not be used.");
-			}
-
-			// Noncompliant Example (operator>>())
-			// CERT INT06-CPP
-			if (tok->isOp() && tok->astOperand1() && !Token::Match(tok, ">>")) {
-
-			}
-        }
+    // Only check cpp file for unsafe functions
+    if (_tokenizer->isCPP()) {
+        const TokenDispatcher::Callback callback = [this](const Token *tok) {
+            unsafeFunctionCall(tok);
+        };
+        for (auto it = _unsafeFunctions.begin(); it != _unsafeFunctions.end(); ++it)
+            dispatcher.addTrigger(it->first, callback);
     }
+
+    const TokenDispatcher::Callback callback = [this](const Token *tok) {
+        suspiciousVariableName(tok);
+    };
+    for (std::size_t i = 0; i < (sizeof(suspiciousNames) / sizeof(*suspiciousNames)); ++i)
+        dispatcher.addTrigger(suspiciousNames[i], callback);
+}
+
+void CheckUnsafeFunctions::unsafeFunctionCall(const Token *tok)
+{
+    if (!isFunctionCall(tok))
+        return;
+
+    // If checking an old code base it might be uninteresting to update unsafe functions.
+    auto it = _unsafeFunctions.find(tok->str());
+    reportError(tok, Severity::style, "unsafeFunctions"+it->first, it->second);
+}
+
+void CheckUnsafeFunctions::suspiciousVariableName(const Token *tok)
+{
+    if (tok->type() != Token::eVariable)
+        return;
+
+    reportError(tok, Severity::style,
+                "suspiciousVariableName:"+tok->str(), "Suspicious variable name: "
+                + tok->str() + " maybe identify the hard-coded password.\n"
+                + "Hard coded passwords are like backdoor access to the system, "
+                + "so it should not be used.");
 }
 
 //---------------------------------------------------------------------------
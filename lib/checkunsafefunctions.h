@@ -23,6 +23,7 @@
 
 #include "config.h"
 #include "check.h"
+#include "tokendispatcher.h"
 #include <string>
 #include <map>
 
@@ -52,10 +53,26 @@ public:
         checkUnsafeFunctions.unsafeFunctions();
     }
 
+    bool registerSimplifiedChecks(TokenDispatcher &dispatcher, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) {
+        CheckUnsafeFunctions *checkUnsafeFunctions = new CheckUnsafeFunctions(tokenizer, settings, errorLogger);
+        dispatcher.addCheck(checkUnsafeFunctions);
+        checkUnsafeFunctions->registerUnsafeFunctions(dispatcher);
+        return true;
+    }
+
     /** Check for unsafe functions */
     void unsafeFunctions();
 
 private:
+    /** add the unsafe function names and suspicious variable names as triggers */
+    void registerUnsafeFunctions(TokenDispatcher &dispatcher);
+
+    /** check a token with the name of an unsafe function */
+    void unsafeFunctionCall(const Token *tok);
+
+    /** check a token with a suspicious variable name */
+    void suspiciousVariableName(const Token *tok);
+
     /* function name / error message */
     std::map<std::string, std::string> _unsafeFunctions;
 
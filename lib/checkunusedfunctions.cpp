@@ -23,6 +23,7 @@
 #include "token.h"
 #include "symboldatabase.h"
 #include <cctype>
+#include <sstream>
 //---------------------------------------------------------------------------
 
 
@@ -35,7 +36,31 @@ CheckUnusedFunctions CheckUnusedFunctions::instance;
 // FUNCTION USAGE - Check for unused functions etc
 //---------------------------------------------------------------------------
 
-void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings)
+void CheckUnusedFunctions::MyFileInfo::merge(const MyFileInfo &other)
+{
+    // The files are merged in any order. The definition in the first file
+    // by name is reported so the result does not depend on the order.
+    for (auto it = other.definitions.begin(); it != other.definitions.end(); ++it) {
+        auto def = definitions.find(it->first);
+        if (def == definitions.end())
+            definitions.insert(*it);
+        else if (it->second.filename < def->second.filename)
+            def->second = it->second;
+    }
+    usages.insert(other.usages.begin(), other.usages.end());
+}
+
+std::string CheckUnusedFunctions::MyFileInfo::toString() const
+{
+    std::ostringstream ostr;
+    for (auto it = definitions.begin(); it != definitions.end(); ++it)
+        ostr << "d " << it->second.lineNumber << ' ' << it->first << ' ' << it->second.filename << '\n';
+    for (auto it = usages.begin(); it != usages.end(); ++it)
+        ostr << "u " << *it << '\n';
+    return ostr.str();
+}
+
+void CheckUnusedFunctions::analyseTokens(const Tokenizer &tokenizer, const Library::FileView &fileLibrary, const Settings *settings, MyFileInfo &fileInfo)
 {
     const SymbolDatabase* symbolDatabase = tokenizer.getSymbolDatabase();
 
@@ -54,86 +79,64 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
         if (func->retDef->str() == "template")
             continue;
 
-        FunctionUsage &usage = _functions[func->name()];
-
-        if (!usage.lineNumber)
-            usage.lineNumber = func->token->linenr();
-
-        // No filename set yet..
-        if (usage.filename.empty()) {
-            usage.filename = tokenizer.list.getSourceFilePath();
-        }
-        // Multiple files => filename = "+"
-        else if (usage.filename != tokenizer.list.getSourceFilePath()) {
-            //func.filename = "+";
-            usage.usedOtherFile |= usage.usedSameFile;
+        if (fileInfo.definitions.find(func->name()) == fileInfo.definitions.end()) {
+            MyFileInfo::FunctionDefinition &def = fileInfo.definitions[func->name()];
+            def.filename = tokenizer.list.getSourceFilePath();
+            def.lineNumber = func->token->linenr();
         }
     }
 
     // Function usage..
+    std::set<std::string> &usages = fileInfo.usages;
     for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
 
         // parsing of library code to find called functions
-        if (settings->library.isexecutableblock(FileName, tok->str())) {
-            const Token * markupVarToken = tok->tokAt(settings->library.blockstartoffset(FileName));
+        if (fileLibrary.isexecutableblock(tok->str())) {
+            const Token * markupVarToken = tok->tokAt(fileLibrary.blockstartoffset());
             int scope = 0;
             bool start = true;
             // find all function calls in library code (starts with '(', not if or while etc)
             while (scope || start) {
-                if (markupVarToken->str() == settings->library.blockstart(FileName)) {
+                if (markupVarToken->str() == fileLibrary.blockstart()) {
                     scope++;
                     if (start) {
                         start = false;
                     }
-                } else if (markupVarToken->str() == settings->library.blockend(FileName))
+                } else if (markupVarToken->str() == fileLibrary.blockend())
                     scope--;
-                else if (!settings->library.iskeyword(FileName, markupVarToken->str())) {
-                    if (_functions.find(markupVarToken->str()) != _functions.end())
-                        _functions[markupVarToken->str()].usedOtherFile = true;
-                    else if (markupVarToken->next()->str() == "(") {
-                        FunctionUsage &func = _functions[markupVarToken->str()];
-                        func.filename = tokenizer.list.getSourceFilePath();
-                        if (func.filename.empty() || func.filename == "+")
-                            func.usedOtherFile = true;
-                        else
-                            func.usedSameFile = true;
-                    }
+                else if (!fileLibrary.iskeyword(markupVarToken->str())) {
+                    // the function can be defined in any file
+                    usages.insert(markupVarToken->str());
                 }
                 markupVarToken = markupVarToken->next();
             }
         }
 
-        if (!settings->library.markupFile(FileName) // only check source files
+        // Exported functions are used even if they are defined in another file
+        if (!fileLibrary.markupFile() // only check source files
             && settings->library.isexporter(tok->str()) && tok->next() != 0) {
             const Token * propToken = tok->next();
             while (propToken && propToken->str() != ")") {
-                if (settings->library.isexportedprefix(tok->str(), propToken->str())) {
-                    const Token* nextPropToken = propToken->next();
-                    const std::string& value = nextPropToken->str();
-                    if (_functions.find(value) != _functions.end()) {
-                        _functions[value].usedOtherFile = true;
-                    }
-                }
+                if (settings->library.isexportedprefix(tok->str(), propToken->str()))
+                    usages.insert(propToken->next()->str());
                 if (settings->library.isexportedsuffix(tok->str(), propToken->str())) {
-                    const Token* prevPropToken = propToken->previous();
-                    const std::string& value = prevPropToken->str();
-                    if (value != ")" && _functions.find(value) != _functions.end()) {
-                        _functions[value].usedOtherFile = true;
-                    }
+                    const std::string& value = propToken->previous()->str();
+                    if (value != ")")
+                        usages.insert(value);
                 }
                 propToken = propToken->next();
             }
         }
 
-        if (settings->library.markupFile(FileName)
-            && settings->library.isimporter(FileName, tok->str()) && tok->next()) {
+        if (fileLibrary.markupFile()
+            && fileLibrary.isimporter(tok->str()) && tok->next()) {
             const Token * propToken = tok->next();
             if (propToken->next()) {
                 propToken = propToken->next();
                 while (propToken && propToken->str() != ")") {
                     const std::string& value = propToken->str();
                     if (!value.empty()) {
-                        _functions[value].usedOtherFile = true;
+                        usages.insert(value);
                         break;
                     }
                     propToken = propToken->next();
@@ -158,7 +161,7 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
                 }
                 if (index == argIndex) {
                     value = value.substr(1, value.length() - 2);
-                    _functions[value].usedOtherFile = true;
+                    usages.insert(value);
                 }
             }
         }
@@ -194,25 +197,27 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char Fi
                 funcname = nullptr;
         }
 
-        if (funcname) {
-            FunctionUsage &func = _functions[ funcname->str()];
-
-            if (func.filename.empty() || func.filename == "+")
-                func.usedOtherFile = true;
-            else
-                func.usedSameFile = true;
-        }
+        if (funcname)
+            usages.insert(funcname->str());
     }
 }
 
-
-
+void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer, const char FileName[], const Settings *settings)
+{
+    MyFileInfo fileInfo;
+    analyseTokens(tokenizer, settings->library.fileView(FileName), settings, fileInfo);
+    _all.merge(fileInfo);
+}
 
 void CheckUnusedFunctions::check(ErrorLogger * const errorLogger)
 {
-    for (auto it = _functions.begin(); it != _functions.end(); ++it) {
-        const FunctionUsage &func = it->second;
-        if (func.usedOtherFile || func.filename.empty())
+    reportUnused(_all, errorLogger);
+}
+
+void CheckUnusedFunctions::reportUnused(const MyFileInfo &all, ErrorLogger * const errorLogger)
+{
+    for (auto it = all.definitions.begin(); it != all.definitions.end(); ++it) {
+        if (all.usages.find(it->first) != all.usages.end())
             continue;
         if (it->first == "main" ||
             it->first == "WinMain" ||
@@ -220,21 +225,7 @@ void CheckUnusedFunctions::check(ErrorLogger * const errorLogger)
             it->first == "if" ||
             (it->first.compare(0, 8, "operator") == 0 && it->first.size() > 8 && !std::isalnum(it->first[8])))
             continue;
-        if (! func.usedSameFile) {
-            std::string filename;
-            if (func.filename == "+")
-                filename = "";
-            else
-                filename = func.filename;
-            unusedFunctionError(errorLogger, filename, func.lineNumber, it->first);
-        } else if (! func.usedOtherFile) {
-            /** @todo add error message "function is only used in <file> it can be static" */
-            /*
-            std::ostringstream errmsg;
-            errmsg << "The function '" << it->first << "' is only used in the file it was declared in so it should have local linkage.";
-            _errorLogger->reportErr( errmsg.str() );
-            */
-        }
+        unusedFunctionError(errorLogger, it->second.filename, it->second.lineNumber, it->first);
     }
 }
 
@@ -259,14 +250,47 @@ void CheckUnusedFunctions::unusedFunctionError(ErrorLogger * const errorLogger,
 
 Check::FileInfo *CheckUnusedFunctions::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
-    if (settings->isEnabled("unusedFunction") && settings->_jobs == 1)
-        instance.parseTokens(*tokenizer, tokenizer->list.getFiles().front().c_str(), settings);
-    return nullptr;
+    if (!settings->isEnabled("unusedFunction"))
+        return nullptr;
+    MyFileInfo *fileInfo = new MyFileInfo;
+    analyseTokens(*tokenizer, tokenizer->list.libraryView(0), settings, *fileInfo);
+    return fileInfo;
+}
 
+Check::FileInfo *CheckUnusedFunctions::loadFileInfo(const std::string &data) const
+{
+    MyFileInfo *fileInfo = new MyFileInfo;
+    std::istringstream istr(data);
+    std::string line;
+    while (std::getline(istr, line)) {
+        if (line.compare(0, 2, "u ") == 0) {
+            fileInfo->usages.insert(line.substr(2));
+        } else if (line.compare(0, 2, "d ") == 0) {
+            // d <line> <name> <file>
+            const std::string::size_type pos1 = line.find(' ', 2);
+            const std::string::size_type pos2 = (pos1 == std::string::npos) ? pos1 : line.find(' ', pos1 + 1);
+            if (pos2 == std::string::npos)
+                continue;
+            MyFileInfo::FunctionDefinition def;
+            std::istringstream linenr(line.substr(2, pos1 - 2));
+            if (!(linenr >> def.lineNumber))
+                continue;
+            def.filename = line.substr(pos2 + 1);
+            fileInfo->definitions[line.substr(pos1 + 1, pos2 - pos1 - 1)] = def;
+        }
+    }
+    return fileInfo;
 }
 
 void CheckUnusedFunctions::analyseWholeProgram(const std::list<Check::FileInfo*> &fileInfo, ErrorLogger &errorLogger)
 {
-    (void)fileInfo;
-    instance.check(&errorLogger);
+    // Merge all fileInfo
+    MyFileInfo all;
+    for (auto it = fileInfo.begin(); it != fileInfo.end(); ++it) {
+        const MyFileInfo *fi = dynamic_cast<const MyFileInfo*>(*it);
+        if (fi)
+            all.merge(*fi);
+    }
+
+    reportUnused(all, &errorLogger);
 }
@@ -25,6 +25,10 @@
 #include "config.h"
 #include "check.h"
 
+#include <map>
+#include <set>
+#include <string>
+
 /// @addtogroup Checks
 /** @brief Check for functions never called */
 /// @{
@@ -40,6 +44,27 @@ public:
         : Check(myName(), tokenizer, settings, errorLogger) {
     }
 
+    /** @brief Function definitions and function usage of one translation unit */
+    class MyFileInfo : public Check::FileInfo {
+    public:
+        struct FunctionDefinition {
+            std::string  filename;
+            unsigned int lineNumber;
+        };
+
+        /** key: function name. The first definition in the file is kept. */
+        std::map<std::string, struct FunctionDefinition> definitions;
+
+        /** names of the used functions */
+        std::set<std::string> usages;
+
+        /** @brief Add the definitions and usages of another file */
+        void merge(const MyFileInfo &other);
+
+        /** Serialize, one "d <line> <name> <file>" or "u <name>" line per entry */
+        std::string toString() const;
+    };
+
     // Parse current tokens and determine..
     // * Check what functions are used
     // * What functions are declared
@@ -50,6 +75,9 @@ public:
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const;
 
+    /** @brief Load file info that was serialized with MyFileInfo::toString() */
+    Check::FileInfo *loadFileInfo(const std::string &data) const;
+
     /** @brief Analyse all file infos for all TU */
     void analyseWholeProgram(const std::list<Check::FileInfo*> &fileInfo, ErrorLogger &errorLogger);
 
@@ -84,18 +112,17 @@ private:
         return "Check for functions that are never called\n";
     }
 
-    class CPPCHECKLIB FunctionUsage {
-    public:
-        FunctionUsage() : lineNumber(0), usedSameFile(false), usedOtherFile(false) {
-        }
+    /**
+     * @brief Determine the function definitions and function usage of a file
+     * @param fileLibrary library settings for the file extension of the checked file
+     */
+    static void analyseTokens(const Tokenizer &tokenizer, const Library::FileView &fileLibrary, const Settings *settings, MyFileInfo &fileInfo);
 
-        std::string filename;
-        unsigned int lineNumber;
-        bool   usedSameFile;
-        bool   usedOtherFile;
-    };
+    /** @brief Report the defined functions that are not used in any file */
+    static void reportUnused(const MyFileInfo &all, ErrorLogger * const errorLogger);
 
-    std::map<std::string, FunctionUsage> _functions;
+    /** Definitions and usages of the files given to parseTokens() */
+    MyFileInfo _all;
 };
 /// @}
 //---------------------------------------------------------------------------
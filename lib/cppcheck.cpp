@@ -21,12 +21,19 @@
 #include "tokenize.h" // Tokenizer
 
 #include "check.h"
+#include "memorystream.h"
 #include "path.h"
+#include "tokendispatcher.h"
 
 #include <algorithm>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 #include "timer.h"
 #include "version.h"
 
@@ -38,20 +45,60 @@
 static const char Version[] = CPPCHECK_VERSION_STRING;
 static const char ExtraVersion[] = "";
 
-static TimerResults S_timerResults;
+namespace {
+    /** The preprocessed code of the configurations that are checked, grouped by hash */
+    class CheckedCode {
+    public:
+        /** Add code, returns false if the same code was added before */
+        bool insert(const std::string &code) {
+            std::list<std::string> &codes = _codes[std::hash<std::string>()(code)];
+            if (std::find(codes.begin(), codes.end(), code) != codes.end())
+                return false;
+            codes.push_back(code);
+            return true;
+        }
+
+    private:
+        std::map<std::size_t, std::list<std::string> > _codes;
+    };
+
+    /** Records the messages of a check, they are reported after the other checks ran */
+    class MessageRecorder : public ErrorLogger {
+    public:
+        explicit MessageRecorder(std::list<std::pair<bool, ErrorLogger::ErrorMessage> > &messages)
+            : _messages(messages) {
+        }
+
+        void reportOut(const std::string &) {}
+
+        void reportErr(const ErrorLogger::ErrorMessage &msg) {
+            _messages.push_back(std::make_pair(false, msg));
+        }
+
+        void reportInfo(const ErrorLogger::ErrorMessage &msg) {
+            _messages.push_back(std::make_pair(true, msg));
+        }
+
+    private:
+        std::list<std::pair<bool, ErrorLogger::ErrorMessage> > &_messages;
+    };
+}
+
 
 CppCheck::CppCheck(ErrorLogger &errorLogger, bool useGlobalSuppressions)
-    : _errorLogger(errorLogger), exitcode(0), _useGlobalSuppressions(useGlobalSuppressions), tooManyConfigs(false), _simplify(true)
+    : _errorLogger(errorLogger), exitcode(0), _useGlobalSuppressions(useGlobalSuppressions), tooManyConfigs(false), _simplify(true),
+      _cache(nullptr), _cacheEntry(nullptr), _deferred(nullptr), _knownChecksum(nullptr)
 {
 }
 
 CppCheck::~CppCheck()
 {
     while (!fileInfo.empty()) {
-        delete fileInfo.back();
+        delete fileInfo.back().second;
         fileInfo.pop_back();
     }
-    S_timerResults.ShowResults(_settings._showtime);
+    delete _cache;
+    _timerResults.ShowResults(_settings._showtime);
 }
 
 const char * CppCheck::version()
@@ -72,7 +119,7 @@ unsigned int CppCheck::check(const std::string &path)
 
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
-    std::istringstream iss(content);
+    MemoryStream iss(content);
     return processFile(path, iss);
 }
 
@@ -96,7 +143,7 @@ bool CppCheck::findError(std::string code, const char FileName[])
     }
 
     std::string previousCode = code;
-    std::string error = _errorList.front();
+    std::string error = _firstError;
     for (;;) {
 
         // Try to remove included files from the source
@@ -117,7 +164,7 @@ bool CppCheck::findError(std::string code, const char FileName[])
             // to previous code
             code = previousCode;
         } else {
-            error = _errorList.front();
+            error = _firstError;
         }
 
         // Add '\n' so that "\n#file" on first line would be found
@@ -145,19 +192,25 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
     if (_settings.terminated())
         return exitcode;
 
+    _libraryView = _settings.library.fileView(filename);
+    _libraryViewFile = filename;
+
     if (_settings._errorsOnly == false) {
         std::string fixedpath = Path::simplifyPath(filename);
         fixedpath = Path::toNativeSeparators(fixedpath);
         _errorLogger.reportOut(std::string("Checking ") + fixedpath + std::string("..."));
     }
 
+    if (!_cache && !_settings.cacheDir.empty() && AnalysisCache::isUsable(_settings))
+        _cache = new AnalysisCache(_settings.cacheDir, _settings);
+
     try {
         Preprocessor preprocessor(&_settings, this);
         std::list<std::string> configurations;
         std::string filedata = "";
 
         {
-            Timer t("Preprocessor::preprocess", _settings._showtime, &S_timerResults);
+            Timer t("Preprocessor::preprocess", _settings._showtime, &_timerResults);
             preprocessor.preprocess(fileStream, filedata, configurations, filename, _settings._includePaths);
         }
 
@@ -169,7 +222,7 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
         for (auto it = _settings.rules.begin(); it != _settings.rules.end(); ++it) {
             if (it->tokenlist == "define") {
                 Tokenizer tokenizer2(&_settings, this);
-                std::istringstream istr2(filedata);
+                MemoryStream istr2(filedata);
                 tokenizer2.list.createTokens(istr2, filename);
 
                 for (const Token *tok = tokenizer2.list.front(); tok; tok = tok->next()) {
@@ -200,12 +253,21 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
             }
         }
 
+        // Several configurations can be checked at the same time. Debug
+        // output and dumps are written directly so they must be serial.
+        if (_settings._configJobs > 1 && configurations.size() > 1U &&
+            !_settings.debug && !_settings.debugFalsePositive && !_settings.dump) {
+            checkConfigurations(preprocessor, filedata, configurations, filename);
+            configurations.clear();
+        }
+
         std::set<unsigned long long> checksums;
+        CheckedCode checkedCode;
         unsigned int checkCount = 0;
         for (auto it = configurations.begin(); it != configurations.end(); ++it) {
             // Check only a few configurations (default 12), after that bail out, unless --force
-            // was used.
-            if (!_settings._force && ++checkCount > _settings._maxConfigs)
+            // was used. Configurations with duplicate code are not counted.
+            if (!_settings._force && checkCount >= _settings._maxConfigs)
                 break;
 
             cfg = *it;
@@ -223,7 +285,7 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
                 cfg = _settings.userDefines + cfg;
             }
 
-            Timer t("Preprocessor::getcode", _settings._showtime, &S_timerResults);
+            Timer t("Preprocessor::getcode", _settings._showtime, &_timerResults);
             std::string codeWithoutCfg = preprocessor.getcode(filedata, cfg, filename);
             t.Stop();
 
@@ -234,7 +296,13 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
                     return exitcode;
                 }
             } else {
-                if (!checkFile(codeWithoutCfg, filename.c_str(), checksums)) {
+                // A configuration that has the same code as a previous one
+                // is skipped before it is tokenized
+                const bool duplicate = (_settings._force || _settings._maxConfigs > 1) &&
+                                       !checkedCode.insert(codeWithoutCfg);
+                if (!duplicate)
+                    ++checkCount;
+                if (duplicate || !checkFile(codeWithoutCfg, filename.c_str(), checksums)) {
                     if (_settings.isEnabled("information") && (_settings.debug || _settings._verbose))
                         purgedConfigurationMessage(filename, cfg);
                 }
@@ -247,7 +315,7 @@ unsigned int CppCheck::processFile(const std::string& filename, std::istream& fi
     }
 
     if (_settings.isEnabled("information") || _settings.checkConfiguration)
-        reportUnmatchedSuppressions(_settings.nomsg.getUnmatchedLocalSuppressions(filename, _settings._jobs == 1 && _settings.isEnabled("unusedFunction")));
+        reportUnmatchedSuppressions(_settings.nomsg.getUnmatchedLocalSuppressions(filename, _settings.isEnabled("unusedFunction")));
 
     _errorList.clear();
     return exitcode;
@@ -292,7 +360,7 @@ void CppCheck::analyseFile(std::istream &fin, const std::string &filename)
 
     // Tokenize..
     Tokenizer tokenizer(&_settings, this);
-    std::istringstream istr(code);
+    MemoryStream istr(code);
     tokenizer.tokenize(istr, filename.c_str());
     tokenizer.simplifyTokenList2();
 }
@@ -305,15 +373,56 @@ bool CppCheck::checkFile(const std::string &code, const char FileName[], std::se
     if (_settings.terminated() || _settings.checkConfiguration)
         return true;
 
+    if (!_cache)
+        return checkFileUncached(code, FileName, checksums);
+
+    Timer timer("AnalysisCache::load", _settings._showtime, &_timerResults);
+    const std::string key(_cache->key(code, FileName, cfg));
+    AnalysisCache::Entry entry;
+    const bool cached = _cache->load(key, entry);
+    timer.Stop();
+
+    if (cached) {
+        if (!replay(entry, FileName, checksums))
+            return false;
+        loadFileInfo(entry.fileInfo);
+        return true;
+    }
+
+    // The file info of this configuration is collected separately so it can be stored
+    std::list<std::pair<const Check *, Check::FileInfo *> > previousFileInfo;
+    previousFileInfo.swap(fileInfo);
+    _cacheEntry = &entry;
+    bool result;
+    try {
+        result = checkFileUncached(code, FileName, checksums);
+    } catch (...) {
+        _cacheEntry = nullptr;
+        fileInfo.splice(fileInfo.begin(), previousFileInfo);
+        throw;
+    }
+    _cacheEntry = nullptr;
+    entry.fileInfo = fileInfoToString(fileInfo);
+    fileInfo.splice(fileInfo.begin(), previousFileInfo);
+
+    // Don't store incomplete results
+    if (!_settings.terminated())
+        _cache->store(key, entry);
+
+    return result;
+}
+
+bool CppCheck::checkFileUncached(const std::string &code, const char FileName[], std::set<unsigned long long>& checksums)
+{
     Tokenizer _tokenizer(&_settings, this);
     if (_settings._showtime != SHOWTIME_NONE)
-        _tokenizer.setTimerResults(&S_timerResults);
+        _tokenizer.setTimerResults(&_timerResults);
     try {
         // Execute rules for "raw" code
         for (auto it = _settings.rules.begin(); it != _settings.rules.end(); ++it) {
             if (it->tokenlist == "raw") {
                 Tokenizer tokenizer2(&_settings, this);
-                std::istringstream istr(code);
+                MemoryStream istr(code);
                 tokenizer2.list.createTokens(istr, FileName);
                 executeRules("raw", tokenizer2);
                 break;
@@ -321,16 +430,23 @@ bool CppCheck::checkFile(const std::string &code, const char FileName[], std::se
         }
 
         // Tokenize the file
-        std::istringstream istr(code);
+        MemoryStream istr(code);
 
-        Timer timer("Tokenizer::tokenize", _settings._showtime, &S_timerResults);
+        Timer timer("Tokenizer::tokenize", _settings._showtime, &_timerResults);
         bool result = _tokenizer.tokenize(istr, FileName, cfg);
         timer.Stop();
 
         if (_settings._force || _settings._maxConfigs > 1) {
             unsigned long long checksum = _tokenizer.list.calculateChecksum();
+            if (_cacheEntry) {
+                _cacheEntry->hasChecksum = true;
+                _cacheEntry->checksum = checksum;
+                _cacheEntry->checksumMessages = _cacheEntry->messages.size();
+            }
             if (checksums.find(checksum) != checksums.end())
                 return false;
+            if (_knownChecksum && _knownChecksum(checksum))
+                return false;
             checksums.insert(checksum);
         }
 
@@ -352,41 +468,86 @@ bool CppCheck::checkFile(const std::string &code, const char FileName[], std::se
             return true;
         }
 
+        // Analyse the tokens..
+        for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
+            Check::FileInfo *fi = (*it)->getFileInfo(&_tokenizer, &_settings);
+            if (fi != nullptr)
+                fileInfo.push_back(std::make_pair(*it, fi));
+        }
+
+        // --diff: code without changes is only analysed for the whole program analysis,
+        // only the changed functions are checked.
+        if (!_settings._changedLines.empty()) {
+            const std::vector<std::string> &files = _tokenizer.list.getFiles();
+            bool changed = false;
+            for (std::size_t i = 0; i < files.size() && !changed; ++i)
+                changed = _settings._changedLines.hasFile(files[i]);
+            if (!changed)
+                return true;
+            _tokenizer.restrictFunctionScopes(_settings._changedLines, _checkedLines);
+        }
+
         // call all "runChecks" in all registered Check classes
         for (auto it = Check::instances().begin(); it != Check::instances().end(); ++it) {
             if (_settings.terminated())
                 return true;
 
-            Timer timerRunChecks((*it)->name() + "::runChecks", _settings._showtime, &S_timerResults);
+            Timer timerRunChecks((*it)->name() + "::runChecks", _settings._showtime, &_timerResults);
             (*it)->runChecks(&_tokenizer, &_settings, this);
         }
 
-        // Analyse the tokens..
-        for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-            Check::FileInfo *fi = (*it)->getFileInfo(&_tokenizer, &_settings);
-            if (fi != nullptr)
-                fileInfo.push_back(fi);
-        }
-
         executeRules("normal", _tokenizer);
 
         if (!_simplify)
             return true;
 
-        Timer timer3("Tokenizer::simplifyTokenList2", _settings._showtime, &S_timerResults);
+        Timer timer3("Tokenizer::simplifyTokenList2", _settings._showtime, &_timerResults);
         result = _tokenizer.simplifyTokenList2();
         timer3.Stop();
         if (!result)
             return true;
 
-        // call all "runSimplifiedChecks" in all registered Check classes
-        for (auto it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-            if (_settings.terminated())
-                return true;
+        if (!_settings._changedLines.empty())
+            _tokenizer.restrictFunctionScopes(_settings._changedLines, _checkedLines);
+
+        // call all "runSimplifiedChecks" in all registered Check classes. Checks
+        // that register trigger names are run together in a single pass. From
+        // the first registered check on, the messages are recorded per check
+        // so they are reported in the order of the checks.
+        std::list<std::list<std::pair<bool, ErrorLogger::ErrorMessage> > > checkMessages;
+        std::list<MessageRecorder> recorders;
+        TokenDispatcher dispatcher;
+        try {
+            for (auto it = Check::instances().begin(); it != Check::instances().end(); ++it) {
+                if (_settings.terminated())
+                    break;
 
-            Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", _settings._showtime, &S_timerResults);
-            (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+                Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", _settings._showtime, &_timerResults);
+                checkMessages.emplace_back();
+                recorders.emplace_back(checkMessages.back());
+                if ((*it)->registerSimplifiedChecks(dispatcher, &_tokenizer, &_settings, &recorders.back()))
+                    continue;
+
+                recorders.pop_back();
+                if (recorders.empty())
+                    checkMessages.pop_back();
+                _deferred = recorders.empty() ? nullptr : &checkMessages.back();
+                (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+                _deferred = nullptr;
+            }
+
+            if (!dispatcher.empty() && !_settings.terminated()) {
+                Timer timerDispatch("TokenDispatcher::dispatch", _settings._showtime, &_timerResults);
+                dispatcher.dispatch(_tokenizer.getSymbolDatabase());
+            }
+        } catch (...) {
+            _deferred = nullptr;
+            for (auto it = checkMessages.begin(); it != checkMessages.end(); ++it)
+                reportDeferred(*it);
+            throw;
         }
+        for (auto it = checkMessages.begin(); it != checkMessages.end(); ++it)
+            reportDeferred(*it);
 
         if (_settings.terminated())
             return true;
@@ -415,11 +576,256 @@ bool CppCheck::checkFile(const std::string &code, const char FileName[], std::se
                                                e.id,
                                                false);
 
-        _errorLogger.reportErr(errmsg);
+        reportErr(errmsg);
     }
     return true;
 }
 
+bool CppCheck::replay(const AnalysisCache::Entry &entry, const char FileName[], std::set<unsigned long long>& checksums)
+{
+    // Same checksum handling as when the code is tokenized: the messages
+    // reported before the checksum was calculated are always reported.
+    const bool duplicate = entry.hasChecksum && !checksums.insert(entry.checksum).second;
+    std::size_t count = duplicate ? entry.checksumMessages : entry.messages.size();
+
+    // Replay the messages, suppressions and duplicates are handled by reportErr
+    for (auto it = entry.messages.begin(); it != entry.messages.end() && count > 0; ++it, --count) {
+        ErrorLogger::ErrorMessage msg(*it);
+        msg.file0 = FileName;
+        reportErr(msg);
+    }
+    return !duplicate;
+}
+
+namespace {
+    /** Discards everything. The messages of a configuration job are recorded before they are filtered. */
+    class NullErrorLogger : public ErrorLogger {
+    public:
+        void reportOut(const std::string &) {}
+        void reportErr(const ErrorLogger::ErrorMessage &) {}
+    };
+
+    class ConfigJob {
+    public:
+        ConfigJob() : duplicate(false), cached(false), hasChecksum(false), checksum(0), failed(false) {}
+
+        ~ConfigJob() {
+            while (!fileInfo.empty()) {
+                delete fileInfo.back().second;
+                fileInfo.pop_back();
+            }
+        }
+
+        /** configuration as it is given in the "Checking" message */
+        std::string name;
+
+        /** configuration, including user defines */
+        std::string cfg;
+
+        std::string code;
+
+        /** messages reported by the preprocessor when the code was extracted */
+        std::list<std::pair<bool, ErrorLogger::ErrorMessage> > preprocessorMessages;
+
+        /** has a previous configuration the same code? */
+        bool duplicate;
+
+        /** cache key, if the cache is used */
+        std::string key;
+
+        /** is the result loaded from the cache? */
+        bool cached;
+
+        AnalysisCache::Entry result;
+
+        /** checksum, set by the thread that checks the configuration when it is calculated */
+        bool hasChecksum;
+        unsigned long long checksum;
+
+        std::list<std::pair<const Check *, Check::FileInfo *> > fileInfo;
+
+        /** has checking been stopped by an internal error? */
+        bool failed;
+        std::string error;
+    };
+}
+
+void CppCheck::checkConfigurations(Preprocessor &preprocessor, const std::string &filedata, const std::list<std::string> &configurations, const std::string &filename)
+{
+    // Extract the code for each configuration. The preprocessor messages are
+    // recorded so they can be reported in order together with the results.
+    std::list<ConfigJob> jobs;
+    CheckedCode checkedCode;
+    unsigned int checkCount = 0;
+    for (auto it = configurations.begin(); it != configurations.end(); ++it) {
+        // Check only a few configurations (default 12), after that bail out, unless --force
+        // was used. Configurations with duplicate code are not counted.
+        if (!_settings._force && checkCount >= _settings._maxConfigs)
+            break;
+
+        jobs.emplace_back();
+        ConfigJob &job = jobs.back();
+        job.name = *it;
+        job.cfg = *it;
+        if (!_settings.userDefines.empty()) {
+            if (!job.cfg.empty())
+                job.cfg = ";" + job.cfg;
+            job.cfg = _settings.userDefines + job.cfg;
+        }
+
+        Timer t("Preprocessor::getcode", _settings._showtime, &_timerResults);
+        _deferred = &job.preprocessorMessages;
+        try {
+            job.code = preprocessor.getcode(filedata, job.cfg, filename);
+        } catch (const std::runtime_error &e) {
+            job.failed = true;
+            job.error = e.what();
+        } catch (const InternalError &e) {
+            job.failed = true;
+            job.error = e.errorMessage;
+        }
+        _deferred = nullptr;
+        t.Stop();
+
+        // The following configurations are not checked after an internal error
+        if (job.failed)
+            break;
+
+        job.code += _settings.append();
+
+        job.duplicate = !checkedCode.insert(job.code);
+        if (job.duplicate) {
+            job.code.clear();
+            continue;
+        }
+        ++checkCount;
+        if (_cache) {
+            job.key = _cache->key(job.code, filename, job.cfg);
+            job.cached = _cache->load(job.key, job.result);
+        }
+    }
+
+    // Check the configurations. Each thread uses its own CppCheck instance
+    // that records the messages instead of reporting them.
+    auto nextJob = jobs.begin();
+    std::mutex jobSync;
+    auto worker = [&]() {
+        NullErrorLogger nullLogger;
+        CppCheck checker(nullLogger, _useGlobalSuppressions);
+        checker._settings = _settings;
+        checker._simplify = _simplify;
+        for (;;) {
+            ConfigJob *job;
+            {
+                std::lock_guard<std::mutex> lock(jobSync);
+                while (nextJob != jobs.end() && (nextJob->duplicate || nextJob->cached || nextJob->failed))
+                    ++nextJob;
+                if (nextJob == jobs.end())
+                    break;
+                job = &*nextJob;
+                ++nextJob;
+            }
+
+            // The configuration is not checked further if a previous
+            // configuration that has the same checksum is known already.
+            checker._knownChecksum = [&, job](unsigned long long checksum) {
+                std::lock_guard<std::mutex> lock(jobSync);
+                job->hasChecksum = true;
+                job->checksum = checksum;
+                for (auto it = jobs.begin(); &*it != job; ++it) {
+                    if (it->cached ? (it->result.hasChecksum && it->result.checksum == checksum)
+                        : (it->hasChecksum && it->checksum == checksum))
+                        return true;
+                }
+                return false;
+            };
+
+            std::set<unsigned long long> checksums;
+            checker.cfg = job->cfg;
+            checker._cacheEntry = &job->result;
+            try {
+                checker.checkFileUncached(job->code, filename.c_str(), checksums);
+            } catch (const std::runtime_error &e) {
+                job->failed = true;
+                job->error = e.what();
+            } catch (const InternalError &e) {
+                job->failed = true;
+                job->error = e.errorMessage;
+            }
+            checker._cacheEntry = nullptr;
+            checker._knownChecksum = nullptr;
+            job->fileInfo.splice(job->fileInfo.end(), checker.fileInfo);
+        }
+
+        std::lock_guard<std::mutex> lock(jobSync);
+        _timerResults.MergeResults(checker._timerResults);
+        checker._timerResults = TimerResults();
+        _checkedLines.add(checker._checkedLines);
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t threadCount = std::min<std::size_t>(_settings._configJobs, jobs.size());
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+
+    // Report the results in configuration order
+    std::set<unsigned long long> checksums;
+    for (auto job = jobs.begin(); job != jobs.end(); ++job) {
+        cfg = job->cfg;
+
+        // If only errors are printed, print filename after the check
+        if (_settings._errorsOnly == false && job != jobs.begin()) {
+            std::string fixedpath = Path::simplifyPath(filename);
+            fixedpath = Path::toNativeSeparators(fixedpath);
+            _errorLogger.reportOut("Checking " + fixedpath + ": " + job->name + "...");
+        }
+
+        reportDeferred(job->preprocessorMessages);
+
+        if (_settings.terminated())
+            break;
+
+        if (job->duplicate) {
+            if (_settings.isEnabled("information") && (_settings.debug || _settings._verbose))
+                purgedConfigurationMessage(filename, cfg);
+            continue;
+        }
+
+        // A configuration with the same code as a previous one is not
+        // checked when configurations are checked one by one, so an
+        // internal error in it is ignored.
+        if (!replay(job->result, filename.c_str(), checksums)) {
+            if (_settings.isEnabled("information") && (_settings.debug || _settings._verbose))
+                purgedConfigurationMessage(filename, cfg);
+        } else if (job->failed) {
+            internalError(filename, job->error);
+            break;
+        } else if (job->cached) {
+            loadFileInfo(job->result.fileInfo);
+        } else {
+            if (_cache)
+                job->result.fileInfo = fileInfoToString(job->fileInfo);
+            fileInfo.splice(fileInfo.end(), job->fileInfo);
+        }
+
+        if (_cache && !job->cached && !job->failed)
+            _cache->store(job->key, job->result);
+    }
+}
+
+void CppCheck::reportDeferred(const std::list<std::pair<bool, ErrorLogger::ErrorMessage> > &messages)
+{
+    for (auto msg = messages.begin(); msg != messages.end(); ++msg) {
+        if (msg->first)
+            reportInfo(msg->second);
+        else
+            reportErr(msg->second);
+    }
+}
+
 void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer)
 {
     (void)tokenlist;
@@ -580,20 +986,42 @@ void CppCheck::purgedConfigurationMessage(const std::string &file, const std::st
 
 void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-    if (!_settings.library.reportErrors(msg.file0))
+    // --diff: only report messages in the changed lines and the checked functions
+    if (!_settings._changedLines.empty() && !msg._callStack.empty() &&
+        !_settings._changedLines.overlaps(msg) && !_checkedLines.overlaps(msg))
+        return;
+
+    if (_deferred) {
+        _deferred->push_back(std::make_pair(false, msg));
+        return;
+    }
+
+    if (_cacheEntry)
+        _cacheEntry->messages.push_back(msg);
+
+    // The messages of a file nearly always have the same file0
+    if (msg.file0 != _libraryViewFile) {
+        _libraryView = _settings.library.fileView(msg.file0);
+        _libraryViewFile = msg.file0;
+    }
+    if (!_libraryView.reportErrors())
         return;
 
-    std::string errmsg = msg.toString(_settings._verbose);
-    if (errmsg.empty())
+    // Empty message
+    if (msg._callStack.empty() && msg._severity == Severity::none &&
+        (_settings._verbose ? msg.verboseMessage() : msg.shortMessage()).empty())
         return;
 
     // Alert only about unique errors
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) != _errorList.end())
+    const unsigned long long errmsg = msg.hash(_settings._verbose);
+    if (_errorList.find(errmsg) != _errorList.end())
         return;
 
     if (_settings.debugFalsePositive) {
         // Don't print out error
-        _errorList.push_back(errmsg);
+        if (_errorList.empty())
+            _firstError = msg.toString(_settings._verbose);
+        _errorList.insert(errmsg);
         return;
     }
 
@@ -615,7 +1043,7 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     if (!_settings.nofail.isSuppressed(msg._id, file, line))
         exitcode = 1;
 
-    _errorList.push_back(errmsg);
+    _errorList.insert(errmsg);
 
     _errorLogger.reportErr(msg);
 }
@@ -632,6 +1060,11 @@ void CppCheck::reportProgress(const std::string &filename, const char stage[], c
 
 void CppCheck::reportInfo(const ErrorLogger::ErrorMessage &msg)
 {
+    if (_deferred) {
+        _deferred->push_back(std::make_pair(true, msg));
+        return;
+    }
+
     // Suppressing info message?
     std::string file;
     unsigned int line(0);
@@ -671,7 +1104,64 @@ void CppCheck::getErrorMessages()
 void CppCheck::analyseWholeProgram()
 {
     // Analyse the tokens..
-    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
-        (*it)->analyseWholeProgram(fileInfo, *this);
+    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
+        std::list<Check::FileInfo*> checkFileInfo;
+        for (auto fi = fileInfo.begin(); fi != fileInfo.end(); ++fi) {
+            if (fi->first == *it)
+                checkFileInfo.push_back(fi->second);
+        }
+        (*it)->analyseWholeProgram(checkFileInfo, *this);
+    }
+}
+
+std::string CppCheck::fileInfoToString() const
+{
+    return fileInfoToString(fileInfo);
+}
+
+std::string CppCheck::fileInfoToString(const std::list<std::pair<const Check *, Check::FileInfo *> > &fileInfo)
+{
+    // <size> <check name><size> <data>
+    std::ostringstream ostr;
+    for (auto it = fileInfo.begin(); it != fileInfo.end(); ++it) {
+        const std::string data(it->second->toString());
+        if (!data.empty())
+            ostr << it->first->name().size() << ' ' << it->first->name() << data.size() << ' ' << data;
+    }
+    return ostr.str();
+}
+
+void CppCheck::loadFileInfo(const std::string &data)
+{
+    std::istringstream istr(data);
+    for (;;) {
+        std::string::size_type len = 0;
+        if (!(istr >> len) || istr.get() != ' ')
+            break;
+        std::string name(len, '\0');
+        if (len > 0 && !istr.read(&name[0], (std::streamsize)len))
+            break;
+        if (!(istr >> len) || istr.get() != ' ')
+            break;
+        std::string checkData(len, '\0');
+        if (len > 0 && !istr.read(&checkData[0], (std::streamsize)len))
+            break;
+
+        for (auto it = Check::instances().begin(); it != Check::instances().end(); ++it) {
+            if ((*it)->name() == name) {
+                Check::FileInfo *fi = (*it)->loadFileInfo(checkData);
+                if (fi)
+                    fileInfo.push_back(std::make_pair(*it, fi));
+                break;
+            }
+        }
+    }
+}
+
+void CppCheck::merge(CppCheck &other)
+{
+    _timerResults.MergeResults(other._timerResults);
+    other._timerResults = TimerResults();
+    fileInfo.splice(fileInfo.end(), other.fileInfo);
 }
 
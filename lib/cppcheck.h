@@ -25,11 +25,17 @@
 #include "settings.h"
 #include "errorlogger.h"
 #include "check.h"
+#include "analysiscache.h"
+#include "timer.h"
 
 #include <string>
 #include <list>
 #include <istream>
+#include <functional>
+#include <unordered_set>
+#include <utility>
 
+class Preprocessor;
 class Tokenizer;
 
 /// @addtogroup Core
@@ -132,6 +138,22 @@ public:
     /** analyse whole program, run this after all TUs has been scanned. */
     void analyseWholeProgram();
 
+    /**
+     * @brief Take over timer results and whole program data from another
+     * instance. This is used to combine the results of worker threads.
+     */
+    void merge(CppCheck &other);
+
+    /**
+     * @brief Serialize the whole program data of the checked files. It is
+     * loaded with loadFileInfo(), this is used to combine the results of
+     * worker processes.
+     */
+    std::string fileInfoToString() const;
+
+    /** @brief Load whole program data that was serialized with fileInfoToString() */
+    void loadFileInfo(const std::string &data);
+
 private:
 
     /** @brief There has been a internal error => Report information message */
@@ -145,9 +167,29 @@ private:
      */
     unsigned int processFile(const std::string& filename, std::istream& fileStream);
 
-    /** @brief Check file */
+    /** @brief Check file. Use cached result if possible. */
     bool checkFile(const std::string &code, const char FileName[], std::set<unsigned long long>& checksums);
 
+    /** @brief Check file, without using the cache */
+    bool checkFileUncached(const std::string &code, const char FileName[], std::set<unsigned long long>& checksums);
+
+    /**
+     * @brief Report the result of a configuration that was loaded from the
+     * cache or checked in another thread.
+     * @return false if the configuration has the same checksum as a previous one
+     */
+    bool replay(const AnalysisCache::Entry &entry, const char FileName[], std::set<unsigned long long>& checksums);
+
+    /**
+     * @brief Check the configurations in several threads (--config-jobs).
+     * The results are reported in the same order as when the
+     * configurations are checked one by one.
+     */
+    void checkConfigurations(Preprocessor &preprocessor, const std::string &filedata, const std::list<std::string> &configurations, const std::string &filename);
+
+    /** @brief Report messages that were recorded, see _deferred */
+    void reportDeferred(const std::list<std::pair<bool, ErrorLogger::ErrorMessage> > &messages);
+
     /**
      * @brief Execute rules, if any
      * @param tokenlist token list to use (normal / simple)
@@ -184,7 +226,15 @@ private:
      */
     static void replaceAll(std::string& code, const std::string &from, const std::string &to);
 
-    std::list<std::string> _errorList;
+    /** Hashes of the reported messages, see ErrorLogger::ErrorMessage::hash() */
+    std::unordered_set<unsigned long long> _errorList;
+
+    /** File name and library settings of the last message, see reportErr() */
+    std::string _libraryViewFile;
+    Library::FileView _libraryView;
+
+    /** First message, it is written in the code that --debug-fp reduces */
+    std::string _firstError;
     Settings _settings;
 
     void reportProgress(const std::string &filename, const char stage[], const std::size_t value);
@@ -209,8 +259,39 @@ private:
     /** Simplify code? true by default */
     bool _simplify;
 
-    /** File info used for whole program analysis */
-    std::list<Check::FileInfo*> fileInfo;
+    /** File info used for whole program analysis, and the check that it belongs to */
+    std::list<std::pair<const Check *, Check::FileInfo *> > fileInfo;
+
+    /** @brief Serialize file info, see fileInfoToString() */
+    static std::string fileInfoToString(const std::list<std::pair<const Check *, Check::FileInfo *> > &fileInfo);
+
+    /** Timer results (--showtime), shown when this instance is destroyed */
+    TimerResults _timerResults;
+
+    /** Analysis cache (--cache-dir), null if caching is not used */
+    AnalysisCache *_cache;
+
+    /** Result of the configuration that is checked, it is written to the cache afterwards */
+    AnalysisCache::Entry *_cacheEntry;
+
+    /**
+     * If not null, messages are recorded here instead of being reported.
+     * The flag is true for messages that were given to reportInfo().
+     */
+    std::list<std::pair<bool, ErrorLogger::ErrorMessage> > *_deferred;
+
+    /**
+     * If set, it is called when the token list checksum has been calculated.
+     * It returns true if a previous configuration has the same checksum.
+     */
+    std::function<bool(unsigned long long)> _knownChecksum;
+
+    /** lines of the function scopes that were checked with --diff */
+    ChangedLines _checkedLines;
+
+    /** disabled copy constructor and assignment operator */
+    CppCheck(const CppCheck &);
+    void operator=(const CppCheck &);
 };
 
 /// @}
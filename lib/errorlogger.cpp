@@ -334,6 +334,40 @@ std::string ErrorLogger::ErrorMessage::toString(bool verbose, const std::string
     }
 }
 
+/** 64-bit FNV-1a */
+static void hashBytes(unsigned long long &h, const char *data, std::size_t len)
+{
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+}
+
+unsigned long long ErrorLogger::ErrorMessage::hash(bool verbose) const
+{
+    // Same fields as toString(). The path separators are equal in the
+    // output because they are converted to native separators.
+    unsigned long long h = 14695981039346656037ULL;
+    for (auto it = _callStack.begin(); it != _callStack.end(); ++it) {
+        const std::string &file = it->getfile(false);
+        for (std::string::size_type i = 0; i < file.size(); ++i) {
+            const char c = (file[i] == '\\') ? '/' : file[i];
+            hashBytes(h, &c, 1U);
+        }
+        hashBytes(h, "", 1U);
+        hashBytes(h, reinterpret_cast<const char *>(&it->line), sizeof(it->line));
+    }
+    const std::size_t locations = _callStack.size();
+    hashBytes(h, reinterpret_cast<const char *>(&locations), sizeof(locations));
+    if (_severity != Severity::none) {
+        const int severity = static_cast<int>(_severity) * 2 + (_inconclusive ? 1 : 0);
+        hashBytes(h, reinterpret_cast<const char *>(&severity), sizeof(severity));
+    }
+    const std::string &msg = verbose ? _verboseMessage : _shortMessage;
+    hashBytes(h, msg.data(), msg.size());
+    return h;
+}
+
 void ErrorLogger::reportUnmatchedSuppressions(const std::list<Suppressions::SuppressionEntry> &unmatched)
 {
     // Report unmatched suppressions
@@ -220,6 +220,14 @@ public:
          */
         std::string toString(bool verbose, const std::string &outputFormat = emptyString) const;
 
+        /**
+         * Hash of the message as it is formatted by toString() without a
+         * template. Duplicate messages are detected with it, so they don't
+         * need to be formatted.
+         * @param verbose use verbose message
+         */
+        unsigned long long hash(bool verbose) const;
+
         std::string serialize() const;
         bool deserialize(const std::string &data);
 
@@ -0,0 +1,62 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headercache.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+bool HeaderCache::stamp(const std::string &filename, Stamp &s)
+{
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) != 0)
+        return false;
+    s.mtime = (long long)buf.st_mtime;
+    s.size = (long long)buf.st_size;
+    return true;
+}
+
+bool HeaderCache::get(const std::string &filename, const Stamp &s, unsigned int options, std::string &code)
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    auto it = _entries.find(std::make_pair(filename, options));
+    if (it == _entries.end() || !(it->second.stamp == s))
+        return false;
+    code = it->second.code;
+    return true;
+}
+
+void HeaderCache::put(const std::string &filename, const Stamp &s, unsigned int options, const std::string &code)
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    Entry &entry = _entries[std::make_pair(filename, options)];
+    entry.stamp = s;
+    entry.code = code;
+}
+
+void HeaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    _entries.clear();
+}
+
+HeaderCache &HeaderCache::instance()
+{
+    static HeaderCache cache;
+    return cache;
+}
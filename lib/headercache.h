@@ -0,0 +1,104 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef headercacheH
+#define headercacheH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief In-memory cache of headers that have been read by the preprocessor.
+ *
+ * Headers are read and cleaned up (comments removed, directives
+ * simplified) the same way for every file that includes them. The cleaned
+ * text is kept so each header is only read once per process. An entry is
+ * used only while the file has the same modification time and size.
+ * The cache is shared by all threads.
+ */
+class CPPCHECKLIB HeaderCache {
+public:
+    /** @brief Modification time and size of a file */
+    class Stamp {
+    public:
+        Stamp() : mtime(0), size(0) {}
+
+        bool operator==(const Stamp &other) const {
+            return mtime == other.mtime && size == other.size;
+        }
+
+        long long mtime;
+        long long size;
+    };
+
+    /** @brief Settings that change how a header is read */
+    enum Options {
+        CHECK_CONFIGURATION = 1, ///< --check-config
+        INLINE_SUPPRESSIONS = 2, ///< --inline-suppr
+        FALL_THROUGH = 4         ///< style and experimental, fall through comments are suppressions
+    };
+
+    /**
+     * @brief Get modification time and size of a file
+     * @return false if the file can't be stat'ed
+     */
+    static bool stamp(const std::string &filename, Stamp &s);
+
+    /**
+     * @brief Get cleaned text of header
+     * @param filename header filename, as it was opened
+     * @param s current stamp of the file
+     * @param options the Options the text was read with
+     * @param code the cached text
+     * @return true if there was a valid entry
+     */
+    bool get(const std::string &filename, const Stamp &s, unsigned int options, std::string &code);
+
+    /** @brief Store cleaned text of header */
+    void put(const std::string &filename, const Stamp &s, unsigned int options, const std::string &code);
+
+    /** @brief Remove all entries */
+    void clear();
+
+    /** @brief The cache that is used by the preprocessor */
+    static HeaderCache &instance();
+
+private:
+    class Entry {
+    public:
+        Stamp stamp;
+        std::string code;
+    };
+
+    std::map<std::pair<std::string, unsigned int>, Entry> _entries;
+
+    std::mutex _sync;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // headercacheH
@@ -5,7 +5,9 @@ BASEPATH = ../externals/tinyxml/
 include($$PWD/../externals/tinyxml/tinyxml.pri)
 BASEPATH = ../lib/
 INCLUDEPATH += ../externals/tinyxml
-HEADERS += $${BASEPATH}check.h \
+HEADERS += $${BASEPATH}analysiscache.h \
+           $${BASEPATH}changedlines.h \
+           $${BASEPATH}check.h \
            $${BASEPATH}check.h \
            $${BASEPATH}check64bit.h \
            $${BASEPATH}checkassert.h \
@@ -36,8 +38,10 @@ HEADERS += $${BASEPATH}check.h \
            $${BASEPATH}cppcheck.h \
            $${BASEPATH}errorlogger.h \
            $${BASEPATH}executionpath.h \
+           $${BASEPATH}headercache.h \
            $${BASEPATH}library.h \
            $${BASEPATH}mathlib.h \
+           $${BASEPATH}memorystream.h \
            $${BASEPATH}path.h \
            $${BASEPATH}preprocessor.h \
            $${BASEPATH}settings.h \
@@ -46,12 +50,17 @@ HEADERS += $${BASEPATH}check.h \
            $${BASEPATH}templatesimplifier.h \
            $${BASEPATH}timer.h \
            $${BASEPATH}token.h \
+           $${BASEPATH}tokenarena.h \
+           $${BASEPATH}tokendispatcher.h \
            $${BASEPATH}tokenize.h \
            $${BASEPATH}tokenlist.h \
+           $${BASEPATH}tokenstrings.h \
            $${BASEPATH}valueflow.h \
 
 
-SOURCES += $${BASEPATH}check.cpp \
+SOURCES += $${BASEPATH}analysiscache.cpp \
+           $${BASEPATH}changedlines.cpp \
+           $${BASEPATH}check.cpp \
            $${BASEPATH}check64bit.cpp \
            $${BASEPATH}checkassert.cpp \
            $${BASEPATH}checkautovariables.cpp \
@@ -81,6 +90,7 @@ SOURCES += $${BASEPATH}check.cpp \
            $${BASEPATH}cppcheck.cpp \
            $${BASEPATH}errorlogger.cpp \
            $${BASEPATH}executionpath.cpp \
+           $${BASEPATH}headercache.cpp \
            $${BASEPATH}library.cpp \
            $${BASEPATH}mathlib.cpp \
            $${BASEPATH}path.cpp \
@@ -91,6 +101,9 @@ SOURCES += $${BASEPATH}check.cpp \
            $${BASEPATH}templatesimplifier.cpp \
            $${BASEPATH}timer.cpp \
            $${BASEPATH}token.cpp \
+           $${BASEPATH}tokenarena.cpp \
+           $${BASEPATH}tokendispatcher.cpp \
            $${BASEPATH}tokenize.cpp \
            $${BASEPATH}tokenlist.cpp \
+           $${BASEPATH}tokenstrings.cpp \
            $${BASEPATH}valueflow.cpp
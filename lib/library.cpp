@@ -462,6 +462,33 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
     return Error(OK);
 }
 
+Library::FileView Library::fileView(const std::string &path) const
+{
+    const std::string ext = Path::getFilenameExtensionInLowerCase(path);
+    FileView view;
+    view._markup = _markupExtensions.find(ext) != _markupExtensions.end();
+
+    const auto afterCode = _processAfterCode.find(ext);
+    view._processAfterCode = (afterCode == _processAfterCode.end() || afterCode->second);
+
+    const auto reportErrors = _reporterrors.find(ext);
+    view._reportErrors = (reportErrors == _reporterrors.end() || reportErrors->second);
+
+    const auto block = _executableblocks.find(ext);
+    if (block != _executableblocks.end())
+        view._block = &block->second;
+
+    const auto keywords = _keywords.find(ext);
+    if (keywords != _keywords.end())
+        view._keywords = &keywords->second;
+
+    const auto importers = _importers.find(ext);
+    if (importers != _importers.end())
+        view._importers = &importers->second;
+
+    return view;
+}
+
 bool Library::isargvalid(const std::string &functionName, int argnr, const MathLib::bigint argvalue) const
 {
     const ArgumentChecks *ac = getarg(functionName, argnr);
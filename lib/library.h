@@ -30,6 +30,8 @@
 #include <set>
 #include <string>
 #include <list>
+#include <unordered_map>
+#include <unordered_set>
 
 class TokenList;
 namespace tinyxml2 {
@@ -60,6 +62,11 @@ public:
     Error load(const char exename [], const char path []);
     Error load(const tinyxml2::XMLDocument &doc);
 
+    /** absolute paths of the loaded library files */
+    const std::set<std::string> &files() const {
+        return _files;
+    }
+
     /** this is primarily meant for unit tests. it only returns true/false */
     bool loadxmldata(const char xmldata[], std::size_t len);
 
@@ -119,11 +126,11 @@ public:
         return _formatstr.at(funcname).second;
     }
 
-    std::set<std::string> use;
-    std::set<std::string> leakignore;
-    std::set<std::string> functionconst;
-    std::set<std::string> functionpure;
-    std::set<std::string> useretval;
+    std::unordered_set<std::string> use;
+    std::unordered_set<std::string> leakignore;
+    std::unordered_set<std::string> functionconst;
+    std::unordered_set<std::string> functionpure;
+    std::unordered_set<std::string> useretval;
 
     bool isnoreturn(const std::string &name) const {
         auto it = _noreturn.find(name);
@@ -166,7 +173,7 @@ public:
     };
 
     // function name, argument nr => argument data
-    std::map<std::string, std::map<int, ArgumentChecks> > argumentChecks;
+    std::unordered_map<std::string, std::map<int, ArgumentChecks> > argumentChecks;
 
     bool isboolargbad(const std::string &functionName, int argnr) const {
         const ArgumentChecks *arg = getarg(functionName, argnr);
@@ -217,6 +224,15 @@ public:
         return arg ? &arg->minsizes : nullptr;
     }
 
+    class FileView;
+
+    /**
+     * Resolve the markup, report and code block settings for the extension
+     * of the given file once. Use the view instead of the functions below
+     * that take a file name when the same file is queried repeatedly.
+     */
+    FileView fileView(const std::string &path) const;
+
     bool markupFile(const std::string &path) const {
         return _markupExtensions.find(Path::getFilenameExtensionInLowerCase(path)) != _markupExtensions.end();
     }
@@ -318,7 +334,7 @@ public:
         return argIndex;
     }
 
-    std::set<std::string> returnuninitdata;
+    std::unordered_set<std::string> returnuninitdata;
     std::vector<std::string> defines; // to provide some library defines
 
     struct PodType {
@@ -362,14 +378,14 @@ public:
 
     struct Platform {
         const PlatformType *platform_type(const std::string &name) const {
-            const std::map<std::string, struct PlatformType>::const_iterator it = _platform_types.find(name);
+            const auto it = _platform_types.find(name);
             return (it != _platform_types.end()) ? &(it->second) : nullptr;
         }
-        std::map<std::string, PlatformType> _platform_types;
+        std::unordered_map<std::string, PlatformType> _platform_types;
     };
 
     const PlatformType *platform_type(const std::string &name, const std::string & platform) const {
-        const std::map<std::string, Platform>::const_iterator it = platforms.find(platform);
+        const auto it = platforms.find(platform);
 
         if (it != platforms.end()) {
             const PlatformType * const type = it->second.platform_type(name);
@@ -378,7 +394,7 @@ public:
                 return type;
         }
 
-        const std::map<std::string, PlatformType>::const_iterator it2 = platform_types.find(name);
+        const auto it2 = platform_types.find(name);
 
         return (it2 != platform_types.end()) ? &(it2->second) : nullptr;
     }
@@ -440,10 +456,10 @@ private:
     };
     int allocid;
     std::set<std::string> _files;
-    std::map<std::string, int> _alloc; // allocation functions
-    std::map<std::string, int> _dealloc; // deallocation functions
-    std::map<std::string, bool> _noreturn; // is function noreturn?
-    std::set<std::string> _ignorefunction; // ignore functions/macros from a library (gtk, qt etc)
+    std::unordered_map<std::string, int> _alloc; // allocation functions
+    std::unordered_map<std::string, int> _dealloc; // deallocation functions
+    std::unordered_map<std::string, bool> _noreturn; // is function noreturn?
+    std::unordered_set<std::string> _ignorefunction; // ignore functions/macros from a library (gtk, qt etc)
     std::map<std::string, bool> _reporterrors;
     std::map<std::string, bool> _processAfterCode;
     std::set<std::string> _markupExtensions; // file extensions of markup files
@@ -451,20 +467,74 @@ private:
     std::map<std::string, CodeBlock> _executableblocks; // keywords for blocks of executable code
     std::map<std::string, ExportedFunctions> _exporters; // keywords that export variables/functions to libraries (meta-code/macros)
     std::map<std::string, std::set<std::string> > _importers; // keywords that import variables/functions
-    std::map<std::string,int> _reflection; // invocation of reflection
-    std::map<std::string, std::pair<bool, bool> > _formatstr; // Parameters for format string checking
-    std::map<std::string, struct PodType> podtypes; // pod types
-    std::map<std::string, PlatformType> platform_types; // platform independent typedefs
+    std::unordered_map<std::string, int> _reflection; // invocation of reflection
+    std::unordered_map<std::string, std::pair<bool, bool> > _formatstr; // Parameters for format string checking
+    std::unordered_map<std::string, struct PodType> podtypes; // pod types
+    std::unordered_map<std::string, PlatformType> platform_types; // platform independent typedefs
     std::map<std::string, Platform> platforms; // platform dependent typedefs
 
     const ArgumentChecks * getarg(const std::string &functionName, int argnr) const;
 
-    static int getid(const std::map<std::string,int> &data, const std::string &name) {
+    static int getid(const std::unordered_map<std::string, int> &data, const std::string &name) {
         const auto it = data.find(name);
         return (it == data.end()) ? 0 : it->second;
     }
 };
 
+/**
+ * @brief Library settings for the file extension of one file, see Library::fileView()
+ */
+class Library::FileView {
+public:
+    FileView() : _markup(false), _processAfterCode(true), _reportErrors(true), _block(nullptr), _keywords(nullptr), _importers(nullptr) {}
+
+    bool markupFile() const {
+        return _markup;
+    }
+
+    bool processMarkupAfterCode() const {
+        return _processAfterCode;
+    }
+
+    bool reportErrors() const {
+        return _reportErrors;
+    }
+
+    bool isexecutableblock(const std::string &token) const {
+        return _block && _block->isBlock(token);
+    }
+
+    int blockstartoffset() const {
+        return _block ? _block->offset() : -1;
+    }
+
+    const std::string& blockstart() const {
+        return _block ? _block->start() : emptyString;
+    }
+
+    const std::string& blockend() const {
+        return _block ? _block->end() : emptyString;
+    }
+
+    bool iskeyword(const std::string &keyword) const {
+        return _keywords && _keywords->count(keyword) > 0;
+    }
+
+    bool isimporter(const std::string &importer) const {
+        return _importers && _importers->count(importer) > 0;
+    }
+
+private:
+    friend class Library;
+
+    bool _markup;
+    bool _processAfterCode;
+    bool _reportErrors;
+    const CodeBlock *_block;
+    const std::set<std::string> *_keywords;
+    const std::set<std::string> *_importers;
+};
+
 /// @}
 //---------------------------------------------------------------------------
 #endif // libraryH
@@ -25,6 +25,102 @@
 #include <cctype>
 #include <limits>
 
+/**
+ * Convert decimal and hexadecimal numbers that fit in a bigint without using streams.
+ * @return false if the generic conversion is needed
+ */
+static bool toSimpleNumber(const std::string &str, MathLib::bigint &value)
+{
+    std::string::size_type pos = 0;
+    if (!str.empty() && (str[0] == '-' || str[0] == '+'))
+        pos = 1;
+    if (pos >= str.size() || !std::isdigit(static_cast<unsigned char>(str[pos])))
+        return false;
+
+    MathLib::biguint ret = 0;
+    const std::string::size_type start = pos;
+    if (str[pos] == '0' && pos + 1U < str.size() && (str[pos + 1U] == 'x' || str[pos + 1U] == 'X')) {
+        if (pos != 0)
+            return false;
+        pos += 2U;
+        const std::string::size_type digits = pos;
+        for (; pos < str.size() && std::isxdigit(static_cast<unsigned char>(str[pos])); ++pos) {
+            const char c = str[pos];
+            ret = ret * 16U + (std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (std::tolower(static_cast<unsigned char>(c)) - 'a' + 10));
+        }
+        if (pos == digits || pos - digits > 15U)
+            return false;
+    } else {
+        for (; pos < str.size() && std::isdigit(static_cast<unsigned char>(str[pos])); ++pos)
+            ret = ret * 10U + (str[pos] - '0');
+        // octal numbers and numbers that might overflow
+        if (pos - start > 18U || (pos - start > 1U && str[start] == '0'))
+            return false;
+    }
+    if (pos < str.size() && !MathLib::isValidSuffix(str.begin() + pos, str.end()))
+        return false;
+
+    value = (str[0] == '-') ? -static_cast<MathLib::bigint>(ret) : static_cast<MathLib::bigint>(ret);
+    return true;
+}
+
+MathLib::value::value(const std::string &s) :
+    _isInt(true), _intValue(0), _text(s)
+{
+    if (toSimpleNumber(s, _intValue))
+        return;
+    _isInt = MathLib::isInt(s);
+    if (_isInt)
+        _intValue = MathLib::toLongNumber(s);
+}
+
+MathLib::value::value(bigint v) :
+    _isInt(true), _intValue(v)
+{
+}
+
+std::string MathLib::value::str() const
+{
+    if (_isInt && _text.empty())
+        return MathLib::toString(_intValue);
+    return _text;
+}
+
+MathLib::value MathLib::value::calc(char op, const value &v1, const value &v2)
+{
+    if (v1._isInt && v2._isInt) {
+        const bigint a = v1._intValue;
+        const bigint b = v2._intValue;
+        switch (op) {
+        case '+':
+            return value(a + b);
+        case '-':
+            return value(a - b);
+        case '*':
+            return value(a * b);
+        case '/':
+            if (a == std::numeric_limits<bigint>::min())
+                throw InternalError(0, "Internal Error: Division overflow");
+            if (b == 0)
+                throw InternalError(0, "Internal Error: Division by zero");
+            return value(a / b);
+        case '%':
+            if (b == 0)
+                throw InternalError(0, "Internal Error: Division by zero");
+            return value(a % b);
+        case '&':
+            return value(a & b);
+        case '|':
+            return value(a | b);
+        case '^':
+            return value(a ^ b);
+        default:
+            break;
+        }
+    }
+    return value(MathLib::calculate(v1.str(), v2.str(), op));
+}
+
 MathLib::biguint MathLib::toULongNumber(const std::string & str)
 {
     // hexadecimal numbers:
@@ -81,6 +177,10 @@ MathLib::biguint MathLib::toULongNumber(const std::string & str)
 
 MathLib::bigint MathLib::toLongNumber(const std::string & str)
 {
+    bigint simple;
+    if (toSimpleNumber(str, simple))
+        return simple;
+
     // hexadecimal numbers:
     if (isHex(str)) {
         if (str[0] == '-') {
@@ -150,6 +250,31 @@ double MathLib::toDoubleNumber(const std::string &str)
     return ret;
 }
 
+static std::string toDecimalString(MathLib::biguint value, bool negative)
+{
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    do {
+        *--p = static_cast<char>('0' + value % 10U);
+        value /= 10U;
+    } while (value != 0);
+    if (negative)
+        *--p = '-';
+    return std::string(p, buf + sizeof(buf));
+}
+
+template<> std::string MathLib::toString(bigint value)
+{
+    if (value < 0)
+        return toDecimalString(0U - static_cast<biguint>(value), true);
+    return toDecimalString(static_cast<biguint>(value), false);
+}
+
+template<> std::string MathLib::toString(biguint value)
+{
+    return toDecimalString(value, false);
+}
+
 template<> std::string MathLib::toString(double value)
 {
     std::ostringstream result;
@@ -522,7 +647,8 @@ bool MathLib::isDec(const std::string & s)
 
 bool MathLib::isInt(const std::string & s)
 {
-    return isDec(s) || isHex(s) || isOct(s) || isBin(s);
+    bigint simple;
+    return toSimpleNumber(s, simple) || isDec(s) || isHex(s) || isOct(s) || isBin(s);
 }
 
 std::string MathLib::add(const std::string & first, const std::string & second)
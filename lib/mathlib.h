@@ -36,6 +36,35 @@ public:
     typedef long long bigint;
     typedef unsigned long long biguint;
 
+    /**
+     * @brief Value of a numeric token.
+     * The token text is converted once. Integer arithmetic is done on the
+     * converted value, floating point arithmetic is done as in MathLib::calculate().
+     */
+    class CPPCHECKLIB value {
+    public:
+        explicit value(const std::string &s);
+        explicit value(bigint v);
+
+        bool isInt() const {
+            return _isInt;
+        }
+        bigint getIntValue() const {
+            return _intValue;
+        }
+
+        /** Text of the value. Calculated integers are written as decimal numbers. */
+        std::string str() const;
+
+        /** Same result as MathLib::calculate() */
+        static value calc(char op, const value &v1, const value &v2);
+
+    private:
+        bool _isInt;
+        bigint _intValue;
+        std::string _text;
+    };
+
     static bigint toLongNumber(const std::string & str);
     static biguint toULongNumber(const std::string & str);
 
@@ -85,6 +114,8 @@ public:
 };
 
 template<> CPPCHECKLIB std::string MathLib::toString(double value); // Declare specialization to avoid linker problems
+template<> CPPCHECKLIB std::string MathLib::toString(MathLib::bigint value);
+template<> CPPCHECKLIB std::string MathLib::toString(MathLib::biguint value);
 
 /// @}
 //---------------------------------------------------------------------------
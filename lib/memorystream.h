@@ -0,0 +1,59 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef memorystreamH
+#define memorystreamH
+//---------------------------------------------------------------------------
+
+#include <istream>
+#include <streambuf>
+#include <string>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Input stream that reads a string without copying it.
+ *
+ * std::istringstream makes a copy of the string. This stream reads the
+ * characters of the string directly, so the string must not be changed
+ * or destroyed while the stream is used.
+ */
+class MemoryStream : public std::istream {
+public:
+    explicit MemoryStream(const std::string &str)
+        : std::istream(nullptr), _buffer(str.data(), str.size()) {
+        rdbuf(&_buffer);
+    }
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        Buffer(const char *data, std::size_t size) {
+            char *begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+
+    Buffer _buffer;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // memorystreamH
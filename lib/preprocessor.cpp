@@ -18,6 +18,7 @@
 
 
 #include "preprocessor.h"
+#include "headercache.h"
 #include "tokenize.h"
 #include "token.h"
 #include "path.h"
@@ -38,7 +39,7 @@ bool Preprocessor::missingSystemIncludeFlag;
 
 char Preprocessor::macroChar = char(1);
 
-Preprocessor::Preprocessor(Settings *settings, ErrorLogger *errorLogger) : _settings(settings), _errorLogger(errorLogger)
+Preprocessor::Preprocessor(Settings *settings, ErrorLogger *errorLogger) : _settings(settings), _errorLogger(errorLogger), _commentSideEffects(0)
 {
 
 }
@@ -60,14 +61,19 @@ void Preprocessor::writeError(const std::string &fileName, const unsigned int li
                            false));
 }
 
-static unsigned char readChar(std::istream &istr, unsigned int bom)
+/** Read a character from the buffer. Returns false at the end of the buffer. */
+static bool readChar(const std::string &buf, std::string::size_type &pos, unsigned int bom, unsigned char &ch)
 {
-    unsigned char ch = (unsigned char)istr.get();
+    const bool utf16 = (bom == 0xfeff || bom == 0xfffe);
+    if (pos >= buf.size() || (utf16 && pos + 1U >= buf.size()))
+        return false;
+
+    ch = (unsigned char)buf[pos++];
 
     // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
     // character is non-ASCII character then replace it with 0xff
-    if (bom == 0xfeff || bom == 0xfffe) {
-        unsigned char ch2 = (unsigned char)istr.get();
+    if (utf16) {
+        unsigned char ch2 = (unsigned char)buf[pos++];
         int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
         ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
     }
@@ -75,20 +81,31 @@ static unsigned char readChar(std::istream &istr, unsigned int bom)
     // Handling of newlines..
     if (ch == '\r') {
         ch = '\n';
-        if (bom == 0 && (char)istr.peek() == '\n')
-            (void)istr.get();
-        else if (bom == 0xfeff || bom == 0xfffe) {
-            int c1 = istr.get();
-            int c2 = istr.get();
+        if (bom == 0 && pos < buf.size() && buf[pos] == '\n')
+            ++pos;
+        else if (utf16 && pos + 1U < buf.size()) {
+            int c1 = (unsigned char)buf[pos];
+            int c2 = (unsigned char)buf[pos + 1U];
             int ch16 = (bom == 0xfeff) ? (c1<<8 | c2) : (c2<<8 | c1);
-            if (ch16 != '\n') {
-                istr.unget();
-                istr.unget();
-            }
+            if (ch16 == '\n')
+                pos += 2U;
         }
     }
 
-    return ch;
+    return true;
+}
+
+/** Read the next line of the buffer, like std::getline() does for a stream */
+static bool getline(const std::string &buf, std::string::size_type &pos, std::string &line)
+{
+    if (pos >= buf.size())
+        return false;
+    std::string::size_type end = buf.find('\n', pos);
+    if (end == std::string::npos)
+        end = buf.size();
+    line.assign(buf, pos, end - pos);
+    pos = end + 1U;
+    return true;
 }
 
 // Concatenates a list of strings, inserting a separator between parts
@@ -173,12 +190,22 @@ static std::map<std::string,std::string> getcfgmap(const std::string &cfg, const
 /** Just read the code into a string. Perform simple cleanup of the code */
 std::string Preprocessor::read(std::istream &istr, const std::string &filename)
 {
+    // Read the whole stream into one buffer. All the cleanup is done in
+    // memory, so the stream is not accessed character by character.
+    std::string buf;
+    {
+        char data[65536];
+        while (istr.read(data, sizeof(data)) || istr.gcount() > 0)
+            buf.append(data, (std::size_t)istr.gcount());
+    }
+    std::string::size_type pos = 0;
+
     // The UTF-16 BOM is 0xfffe or 0xfeff.
     unsigned int bom = 0;
-    if (istr.peek() >= 0xfe) {
-        bom = ((unsigned int)istr.get() << 8);
-        if (istr.peek() >= 0xfe)
-            bom |= (unsigned int)istr.get();
+    if (!buf.empty() && (unsigned char)buf[0] >= 0xfe) {
+        bom = ((unsigned int)(unsigned char)buf[pos++] << 8);
+        if (pos < buf.size() && (unsigned char)buf[pos] >= 0xfe)
+            bom |= (unsigned int)(unsigned char)buf[pos++];
         else
             bom = 0; // allowed boms are 0/0xfffe/0xfeff
     }
@@ -187,16 +214,18 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
         return "";
 
     if (_settings && _settings->checkConfiguration)
-        return readpreprocessor(istr,bom);
+        return readpreprocessor(buf, pos, bom);
 
     // ------------------------------------------------------------------------------------------
     //
     // handling <backslash><newline>
     // when this is encountered the <backslash><newline> will be "skipped".
     // on the next <newline>, extra newlines will be added
-    std::ostringstream code;
+    std::string result;
+    result.reserve(buf.size());
     unsigned int newlines = 0;
-    for (unsigned char ch = readChar(istr,bom); istr.good(); ch = readChar(istr,bom)) {
+    unsigned char ch;
+    while (readChar(buf, pos, bom, ch)) {
         // Replace assorted special chars with spaces..
         if (((ch & 0x80) == 0) && (ch != '\n') && (std::isspace(ch) || std::iscntrl(ch)))
             ch = ' ';
@@ -214,11 +243,11 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
 #ifdef __GNUC__
             // gcc-compatibility: ignore spaces
             for (;; spaces += ' ') {
-                chNext = (unsigned char)istr.peek();
+                chNext = (pos < buf.size()) ? (unsigned char)buf[pos] : (unsigned char)0xff;
                 if (chNext != '\n' && chNext != '\r' &&
                     (std::isspace(chNext) || std::iscntrl(chNext))) {
                     // Skip whitespace between <backslash> and <newline>
-                    (void)readChar(istr,bom);
+                    (void)readChar(buf, pos, bom, chNext);
                     continue;
                 }
 
@@ -226,26 +255,26 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
             }
 #else
             // keep spaces
-            chNext = (unsigned char)istr.peek();
+            chNext = (pos < buf.size()) ? (unsigned char)buf[pos] : (unsigned char)0xff;
 #endif
             if (chNext == '\n' || chNext == '\r') {
                 ++newlines;
-                (void)readChar(istr,bom);   // Skip the "<backslash><newline>"
+                (void)readChar(buf, pos, bom, chNext);   // Skip the "<backslash><newline>"
             } else {
-                code << "\\" << spaces;
+                result += '\\';
+                result += spaces;
             }
         } else {
-            code << char(ch);
+            result += char(ch);
 
             // if there has been <backslash><newline> sequences, add extra newlines..
             if (ch == '\n' && newlines > 0) {
-                code << std::string(newlines, '\n');
+                result.append(newlines, '\n');
                 newlines = 0;
             }
         }
     }
-    std::string result = code.str();
-    code.str("");
+    std::string().swap(buf);
 
     // ------------------------------------------------------------------------------------------
     //
@@ -256,15 +285,9 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
 
     // ------------------------------------------------------------------------------------------
     //
-    // Clean up all preprocessor statements
-    result = preprocessCleanupDirectives(result);
-    if (_settings && _settings->terminated())
-        return "";
-
-    // ------------------------------------------------------------------------------------------
-    //
-    // Clean up preprocessor #if statements with Parentheses
-    result = removeParentheses(result);
+    // Clean up all preprocessor statements and preprocessor #if statements with
+    // Parentheses. This is done in a single pass over the code.
+    result = cleanupDirectives(result, true);
     if (_settings && _settings->terminated())
         return "";
 
@@ -279,13 +302,14 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
 
 
 /** read preprocessor statements */
-std::string Preprocessor::readpreprocessor(std::istream &istr, const unsigned int bom)
+std::string Preprocessor::readpreprocessor(const std::string &buf, std::string::size_type pos, const unsigned int bom)
 {
     enum { NEWLINE, SPACE, PREPROCESSOR, BACKSLASH, OTHER } state = NEWLINE;
-    std::ostringstream code;
+    std::string code;
     unsigned int newlines = 1;
     unsigned char chPrev = ' ';
-    for (unsigned char ch = readChar(istr,bom); istr.good(); ch = readChar(istr,bom)) {
+    unsigned char ch;
+    while (readChar(buf, pos, bom, ch)) {
         // Replace assorted special chars with spaces..
         if (((ch & 0x80) == 0) && (ch != '\n') && (std::isspace(ch) || std::iscntrl(ch)))
             ch = ' ';
@@ -299,7 +323,7 @@ std::string Preprocessor::readpreprocessor(std::istream &istr, const unsigned in
         if (ch == '\n') {
             if (state != BACKSLASH) {
                 state = NEWLINE;
-                code << std::string(newlines, '\n');
+                code.append(newlines, '\n');
                 newlines = 1;
             } else {
                 ++newlines;
@@ -314,24 +338,24 @@ std::string Preprocessor::readpreprocessor(std::istream &istr, const unsigned in
                 state = SPACE;
             else if (ch == '#') {
                 state = PREPROCESSOR;
-                code << ch;
+                code += char(ch);
             } else
                 state = OTHER;
             break;
         case SPACE:
             if (ch == '#') {
                 state = PREPROCESSOR;
-                code << ch;
+                code += char(ch);
             } else if (ch != ' ')
                 state = OTHER;
             break;
         case PREPROCESSOR:
-            code << ch;
+            code += char(ch);
             if (ch == '\\')
                 state = BACKSLASH;
             break;
         case BACKSLASH:
-            code << ch;
+            code += char(ch);
             if (ch != ' ')
                 state = PREPROCESSOR;
             break;
@@ -340,90 +364,173 @@ std::string Preprocessor::readpreprocessor(std::istream &istr, const unsigned in
         };
     }
 
-    std::string result = preprocessCleanupDirectives(code.str());
-    result = removeParentheses(result);
+    std::string result = cleanupDirectives(code, true);
     return removeIf0(result);
 }
 
+/** Remove redundant parentheses from a "#if" or "#elif" line */
+static void removeParenthesesInLine(std::string &line)
+{
+    std::string::size_type pos;
+    pos = 0;
+    while ((pos = line.find(" (", pos)) != std::string::npos)
+        line.erase(pos, 1);
+    pos = 0;
+    while ((pos = line.find("( ", pos)) != std::string::npos)
+        line.erase(pos + 1, 1);
+    pos = 0;
+    while ((pos = line.find(" )", pos)) != std::string::npos)
+        line.erase(pos, 1);
+    pos = 0;
+    while ((pos = line.find(") ", pos)) != std::string::npos)
+        line.erase(pos + 1, 1);
+
+    // Remove inner parentheses "((..))"..
+    pos = 0;
+    while ((pos = line.find("((", pos)) != std::string::npos) {
+        ++pos;
+        std::string::size_type pos2 = line.find_first_of("()", pos + 1);
+        if (pos2 != std::string::npos && line[pos2] == ')') {
+            line.erase(pos2, 1);
+            line.erase(pos, 1);
+        }
+    }
+
+    // "#if(A) => #if A", but avoid "#if (defined A) || defined (B)"
+    if ((line.compare(0, 4, "#if(") == 0 || line.compare(0, 6, "#elif(") == 0) &&
+        line[line.length() - 1] == ')') {
+        int ind = 0;
+        for (std::string::size_type i = 0; i < line.length(); ++i) {
+            if (line[i] == '(')
+                ++ind;
+            else if (line[i] == ')') {
+                --ind;
+                if (ind == 0) {
+                    if (i == line.length() - 1) {
+                        line[line.find('(')] = ' ';
+                        line.erase(line.length() - 1);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (line.compare(0, 4, "#if(") == 0)
+        line.insert(3, " ");
+    else if (line.compare(0, 6, "#elif(") == 0)
+        line.insert(5, " ");
+}
+
 std::string Preprocessor::preprocessCleanupDirectives(const std::string &processedFile)
 {
-    std::ostringstream code;
-    std::istringstream sstr(processedFile);
+    return cleanupDirectives(processedFile, false);
+}
+
+std::string Preprocessor::cleanupDirectives(const std::string &processedFile, bool parentheses)
+{
+    std::string code;
+    code.reserve(processedFile.size());
+    bool hasIf = false;
 
+    std::string::size_type lineStart = 0;
     std::string line;
-    while (std::getline(sstr, line)) {
+    while (lineStart < processedFile.size()) {
+        std::string::size_type lineEnd = processedFile.find('\n', lineStart);
+        const bool lastLine = (lineEnd == std::string::npos);
+        if (lastLine)
+            lineEnd = processedFile.size();
+
         // Trim lines..
-        if (!line.empty() && line[0] == ' ')
-            line.erase(0, line.find_first_not_of(" "));
-        if (!line.empty() && line[line.size()-1] == ' ')
-            line.erase(line.find_last_not_of(" ") + 1);
+        std::string::size_type first = processedFile.find_first_not_of(' ', lineStart);
+        if (first > lineEnd)
+            first = lineEnd;
+        std::string::size_type last = lineEnd;
+        while (last > first && processedFile[last - 1U] == ' ')
+            --last;
+        lineStart = lineEnd + 1U;
+
+        // Do not mess with regular code..
+        if (first == last || processedFile[first] != '#') {
+            code.append(processedFile, first, last - first);
+            if (!lastLine)
+                code += '\n';
+            continue;
+        }
 
         // Preprocessor
-        if (!line.empty() && line[0] == '#') {
-            enum {
-                ESC_NONE,
-                ESC_SINGLE,
-                ESC_DOUBLE
-            } escapeStatus = ESC_NONE;
-
-            char prev = ' '; // hack to make it skip spaces between # and the directive
-            code << "#";
-            auto i = line.begin();
-            ++i;
-
-            // need space.. #if( => #if (
-            bool needSpace = true;
-            while (i != line.end()) {
-                // disable esc-mode
-                if (escapeStatus != ESC_NONE) {
-                    if (prev != '\\' && escapeStatus == ESC_SINGLE && *i == '\'') {
-                        escapeStatus = ESC_NONE;
-                    }
-                    if (prev != '\\' && escapeStatus == ESC_DOUBLE && *i == '"') {
-                        escapeStatus = ESC_NONE;
-                    }
-                } else {
-                    // enable esc-mode
-                    if (escapeStatus == ESC_NONE && *i == '"')
-                        escapeStatus = ESC_DOUBLE;
-                    if (escapeStatus == ESC_NONE && *i == '\'')
-                        escapeStatus = ESC_SINGLE;
-                }
-                // skip double whitespace between arguments
-                if (escapeStatus == ESC_NONE && prev == ' ' && *i == ' ') {
-                    ++i;
-                    continue;
-                }
-                // Convert #if( to "#if ("
-                if (escapeStatus == ESC_NONE) {
-                    if (needSpace) {
-                        if (*i == '(' || *i == '!')
-                            code << " ";
-                        else if (!std::isalpha((unsigned char)*i))
-                            needSpace = false;
-                    }
-                    if (*i == '#')
-                        needSpace = true;
+        line.assign(processedFile, first, last - first);
+        enum {
+            ESC_NONE,
+            ESC_SINGLE,
+            ESC_DOUBLE
+        } escapeStatus = ESC_NONE;
+
+        char prev = ' '; // hack to make it skip spaces between # and the directive
+        std::string directive("#");
+        auto i = line.begin();
+        ++i;
+
+        // need space.. #if( => #if (
+        bool needSpace = true;
+        while (i != line.end()) {
+            // disable esc-mode
+            if (escapeStatus != ESC_NONE) {
+                if (prev != '\\' && escapeStatus == ESC_SINGLE && *i == '\'') {
+                    escapeStatus = ESC_NONE;
                 }
-                code << *i;
-                if (escapeStatus != ESC_NONE && prev == '\\' && *i == '\\') {
-                    prev = ' ';
-                } else {
-                    prev = *i;
+                if (prev != '\\' && escapeStatus == ESC_DOUBLE && *i == '"') {
+                    escapeStatus = ESC_NONE;
                 }
+            } else {
+                // enable esc-mode
+                if (escapeStatus == ESC_NONE && *i == '"')
+                    escapeStatus = ESC_DOUBLE;
+                if (escapeStatus == ESC_NONE && *i == '\'')
+                    escapeStatus = ESC_SINGLE;
+            }
+            // skip double whitespace between arguments
+            if (escapeStatus == ESC_NONE && prev == ' ' && *i == ' ') {
                 ++i;
+                continue;
             }
-            if (escapeStatus != ESC_NONE) {
-                // unmatched quotes.. compiler should probably complain about this..
+            // Convert #if( to "#if ("
+            if (escapeStatus == ESC_NONE) {
+                if (needSpace) {
+                    if (*i == '(' || *i == '!')
+                        directive += ' ';
+                    else if (!std::isalpha((unsigned char)*i))
+                        needSpace = false;
+                }
+                if (*i == '#')
+                    needSpace = true;
             }
-        } else {
-            // Do not mess with regular code..
-            code << line;
+            directive += *i;
+            if (escapeStatus != ESC_NONE && prev == '\\' && *i == '\\') {
+                prev = ' ';
+            } else {
+                prev = *i;
+            }
+            ++i;
         }
-        code << (sstr.eof()?"":"\n");
+        if (escapeStatus != ESC_NONE) {
+            // unmatched quotes.. compiler should probably complain about this..
+        }
+
+        if (parentheses && (directive.compare(0, 3, "#if") == 0 || directive.compare(0, 5, "#elif") == 0)) {
+            hasIf = hasIf || directive.compare(0, 3, "#if") == 0;
+            removeParenthesesInLine(directive);
+        }
+        code += directive;
+        if (!lastLine)
+            code += '\n';
     }
 
-    return code.str();
+    // removeParentheses() terminates all lines when there is a "#if"
+    if (hasIf && !code.empty() && code[code.size() - 1U] != '\n')
+        code += '\n';
+
+    return code;
 }
 
 static bool hasbom(const std::string &str)
@@ -472,7 +579,8 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
     // when this is encountered the <backslash><newline> will be "skipped".
     // on the next <newline>, extra newlines will be added
     unsigned int newlines = 0;
-    std::ostringstream code;
+    std::string code;
+    code.reserve(str.size());
     unsigned char previous = 0;
     bool inPreprocessorLine = false;
     std::vector<std::string> suppressionIDs;
@@ -488,14 +596,15 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             errmsg << "The code contains unhandled characters " << info << ". Checking continues, but do not expect valid results.\n"
                    << "The code contains characters that are unhandled " << info << ". Neither unicode nor extended ASCII are supported. Checking continues, but do not expect valid results.";
             writeError(filename, lineno, _errorLogger, "unhandledCharacters", errmsg.str());
+            ++_commentSideEffects;
         }
 
         if (_settings && _settings->terminated())
             return "";
 
-        if (str.compare(i, 7, "#error ") == 0 || str.compare(i, 9, "#warning ") == 0) {
+        if (ch == '#' && (str.compare(i, 7, "#error ") == 0 || str.compare(i, 9, "#warning ") == 0)) {
             if (str.compare(i, 6, "#error") == 0)
-                code << "#error";
+                code += "#error";
 
             i = str.find("\n", i);
             if (i == std::string::npos)
@@ -510,7 +619,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             if (ch == ' ' && previous == ' ') {
                 // Skip double white space
             } else {
-                code << char(ch);
+                code += char(ch);
                 previous = ch;
             }
 
@@ -520,7 +629,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                     inPreprocessorLine = false;
                 ++lineno;
                 if (newlines > 0) {
-                    code << std::string(newlines, '\n');
+                    code.append(newlines, '\n');
                     newlines = 0;
                     previous = '\n';
                 }
@@ -530,7 +639,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
         }
 
         // Remove comments..
-        if (str.compare(i, 2, "//") == 0) {
+        if (ch == '/' && str.compare(i, 2, "//") == 0) {
             std::size_t commentStart = i + 2;
             i = str.find('\n', i);
             if (i == std::string::npos)
@@ -552,10 +661,10 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                 fallThroughComment = true;
             }
 
-            code << "\n";
+            code += '\n';
             previous = '\n';
             ++lineno;
-        } else if (str.compare(i, 2, "/*") == 0) {
+        } else if (ch == '/' && str.compare(i, 2, "/*") == 0) {
             std::size_t commentStart = i + 2;
             unsigned char chPrev = 0;
             ++i;
@@ -584,11 +693,11 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                         suppressionIDs.push_back(word);
                 }
             }
-        } else if ((i == 0 || std::isspace((unsigned char)str[i-1])) && str.compare(i, 5, "__asm") == 0) {
+        } else if (ch == '_' && (i == 0 || std::isspace((unsigned char)str[i-1])) && str.compare(i, 5, "__asm") == 0) {
             while (i < str.size() && (std::isalpha((unsigned char)str[i]) || str[i] == '_'))
-                code << str[i++];
+                code += str[i++];
             while (i < str.size() && std::isspace((unsigned char)str[i]))
-                code << str[i++];
+                code += str[i++];
             if (str[i] == '{') {
                 // Ticket 4873: Extract comments from the __asm / __asm__'s content
                 std::string asmBody;
@@ -600,12 +709,12 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                     }
                     asmBody += str[i++];
                 }
-                code << removeComments(asmBody, filename);
-                code << '}';
+                code += removeComments(asmBody, filename);
+                code += '}';
             } else
                 --i;
         } else if (ch == '#' && previous == '\n') {
-            code << ch;
+            code += char(ch);
             previous = ch;
             inPreprocessorLine = true;
 
@@ -613,6 +722,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             if (!suppressionIDs.empty()) {
                 if (_settings != nullptr) {
                     // Add the suppressions.
+                    ++_commentSideEffects;
                     for (std::size_t j = 0; j < suppressionIDs.size(); ++j) {
                         const std::string errmsg(_settings->nomsg.addSuppression(suppressionIDs[j], filename, lineno));
                         if (!errmsg.empty()) {
@@ -652,6 +762,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                         }
 
                         // Add the suppressions.
+                        ++_commentSideEffects;
                         for (std::size_t j = 0; j < suppressionIDs.size(); ++j) {
                             const std::string errmsg(_settings->nomsg.addSuppression(suppressionIDs[j], relativeFilename, lineno));
                             if (!errmsg.empty()) {
@@ -665,7 +776,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
 
             // String or char constants..
             if (ch == '\"' || ch == '\'') {
-                code << char(ch);
+                code += char(ch);
                 char chNext;
                 do {
                     ++i;
@@ -676,19 +787,19 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                         if (chSeq == '\n')
                             ++newlines;
                         else {
-                            code << chNext;
-                            code << chSeq;
+                            code += chNext;
+                            code += chSeq;
                             previous = static_cast<unsigned char>(chSeq);
                         }
                     } else {
-                        code << chNext;
+                        code += chNext;
                         previous = static_cast<unsigned char>(chNext);
                     }
                 } while (i < str.length() && chNext != ch && chNext != '\n');
             }
 
             // Rawstring..
-            else if (str.compare(i,2,"R\"")==0) {
+            else if (ch == 'R' && str.compare(i,2,"R\"")==0) {
                 std::string delim;
                 for (std::string::size_type i2 = i+2; i2 < str.length(); ++i2) {
                     if (i2 > 16 ||
@@ -706,50 +817,53 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                 const std::string::size_type endpos = str.find(")" + delim + "\"", i);
                 if (delim != " " && endpos != std::string::npos) {
                     unsigned int rawstringnewlines = 0;
-                    code << '\"';
+                    code += '\"';
                     for (std::string::size_type p = i + 3 + delim.size(); p < endpos; ++p) {
                         if (str[p] == '\n') {
                             rawstringnewlines++;
-                            code << "\\n";
+                            code += "\\n";
                         } else if (std::iscntrl((unsigned char)str[p]) ||
                                    std::isspace((unsigned char)str[p])) {
-                            code << " ";
+                            code += ' ';
                         } else if (str[p] == '\"' || str[p] == '\'') {
-                            code << "\\" << (char)str[p];
+                            code += '\\';
+                            code += str[p];
                         } else {
-                            code << (char)str[p];
+                            code += str[p];
                         }
                     }
-                    code << "\"";
+                    code += '\"';
                     if (rawstringnewlines > 0)
-                        code << std::string(rawstringnewlines, '\n');
+                        code.append(rawstringnewlines, '\n');
                     i = endpos + delim.size() + 1;
                 } else {
-                    code << "R";
+                    code += 'R';
                     previous = 'R';
                 }
             } else {
-                code << char(ch);
+                code += char(ch);
                 previous = ch;
             }
         }
     }
 
-    return code.str();
+    return code;
 }
 
 std::string Preprocessor::removeIf0(const std::string &code)
 {
-    std::ostringstream ret;
-    std::istringstream istr(code);
+    std::string ret;
+    ret.reserve(code.size());
+    std::string::size_type pos = 0;
     std::string line;
-    while (std::getline(istr,line)) {
-        ret << line << "\n";
+    while (getline(code, pos, line)) {
+        ret += line;
+        ret += '\n';
         if (line == "#if 0") {
             // goto the end of the '#if 0' block
             unsigned int level = 1;
             bool in = false;
-            while (level > 0 && std::getline(istr,line)) {
+            while (level > 0 && getline(code, pos, line)) {
                 if (line.compare(0,3,"#if") == 0)
                     ++level;
                 else if (line == "#endif")
@@ -758,19 +872,21 @@ std::string Preprocessor::removeIf0(const std::string &code)
                     if (level == 1)
                         in = true;
                 } else {
-                    if (in)
-                        ret << line << "\n";
-                    else
+                    if (in) {
+                        ret += line;
+                        ret += '\n';
+                    } else
                         // replace code within '#if 0' block with empty lines
-                        ret << "\n";
+                        ret += '\n';
                     continue;
                 }
 
-                ret << line << "\n";
+                ret += line;
+                ret += '\n';
             }
         }
     }
-    return ret.str();
+    return ret;
 }
 
 
@@ -779,65 +895,18 @@ std::string Preprocessor::removeParentheses(const std::string &str)
     if (str.find("\n#if") == std::string::npos && str.compare(0, 3, "#if") != 0)
         return str;
 
-    std::istringstream istr(str);
-    std::ostringstream ret;
+    std::string ret;
+    ret.reserve(str.size());
+    std::string::size_type pos = 0;
     std::string line;
-    while (std::getline(istr, line)) {
-        if (line.compare(0, 3, "#if") == 0 || line.compare(0, 5, "#elif") == 0) {
-            std::string::size_type pos;
-            pos = 0;
-            while ((pos = line.find(" (", pos)) != std::string::npos)
-                line.erase(pos, 1);
-            pos = 0;
-            while ((pos = line.find("( ", pos)) != std::string::npos)
-                line.erase(pos + 1, 1);
-            pos = 0;
-            while ((pos = line.find(" )", pos)) != std::string::npos)
-                line.erase(pos, 1);
-            pos = 0;
-            while ((pos = line.find(") ", pos)) != std::string::npos)
-                line.erase(pos + 1, 1);
-
-            // Remove inner parentheses "((..))"..
-            pos = 0;
-            while ((pos = line.find("((", pos)) != std::string::npos) {
-                ++pos;
-                std::string::size_type pos2 = line.find_first_of("()", pos + 1);
-                if (pos2 != std::string::npos && line[pos2] == ')') {
-                    line.erase(pos2, 1);
-                    line.erase(pos, 1);
-                }
-            }
-
-            // "#if(A) => #if A", but avoid "#if (defined A) || defined (B)"
-            if ((line.compare(0, 4, "#if(") == 0 || line.compare(0, 6, "#elif(") == 0) &&
-                line[line.length() - 1] == ')') {
-                int ind = 0;
-                for (std::string::size_type i = 0; i < line.length(); ++i) {
-                    if (line[i] == '(')
-                        ++ind;
-                    else if (line[i] == ')') {
-                        --ind;
-                        if (ind == 0) {
-                            if (i == line.length() - 1) {
-                                line[line.find('(')] = ' ';
-                                line.erase(line.length() - 1);
-                            }
-                            break;
-                        }
-                    }
-                }
-            }
-
-            if (line.compare(0, 4, "#if(") == 0)
-                line.insert(3, " ");
-            else if (line.compare(0, 6, "#elif(") == 0)
-                line.insert(5, " ");
-        }
-        ret << line << "\n";
+    while (getline(str, pos, line)) {
+        if (line.compare(0, 3, "#if") == 0 || line.compare(0, 5, "#elif") == 0)
+            removeParenthesesInLine(line);
+        ret += line;
+        ret += '\n';
     }
 
-    return ret.str();
+    return ret;
 }
 
 
@@ -1018,10 +1087,11 @@ void Preprocessor::preprocess(std::istream &srcCodeStream, std::string &processe
 
     // Replace "defined A" with "defined(A)"
     {
-        std::istringstream istr(processedFile);
-        std::ostringstream ostr;
+        std::string ostr;
+        ostr.reserve(processedFile.size());
+        std::string::size_type filePos = 0;
         std::string line;
-        while (std::getline(istr, line)) {
+        while (getline(processedFile, filePos, line)) {
             if (line.compare(0, 4, "#if ") == 0 || line.compare(0, 6, "#elif ") == 0) {
                 std::string::size_type pos = 0;
                 while ((pos = line.find(" defined ")) != std::string::npos) {
@@ -1036,9 +1106,10 @@ void Preprocessor::preprocess(std::istream &srcCodeStream, std::string &processe
                         return;
                 }
             }
-            ostr << line << "\n";
+            ostr += line;
+            ostr += '\n';
         }
-        processedFile = ostr.str();
+        processedFile.swap(ostr);
     }
 
     std::map<std::string, std::string> defs(getcfgmap(_settings ? _settings->userDefines : emptyString, _settings, filename));
@@ -1090,10 +1161,11 @@ void Preprocessor::handleUndef(std::list<std::string> &configurations) const
 }
 
 // Get the DEF in this line: "#ifdef DEF"
-std::string Preprocessor::getdef(std::string line, bool def)
+std::string Preprocessor::getdef(const std::string &directive, bool def)
 {
-    if (line.empty() || line[0] != '#')
+    if (directive.empty() || directive[0] != '#')
         return "";
+    std::string line(directive);
 
     // If def is true, the line must start with "#ifdef"
     if (def && line.compare(0, 7, "#ifdef ") != 0 && line.compare(0, 4, "#if ") != 0
@@ -1725,7 +1797,47 @@ void Preprocessor::simplifyCondition(const std::map<std::string, std::string> &c
         condition = "0";
 }
 
-bool Preprocessor::match_cfg_def(std::map<std::string, std::string> cfg, std::string def)
+/** Add the names in str that are defined in cfg, and the names in their values, to names */
+static void addConditionNames(const std::map<std::string, std::string> &cfg, const std::string &str, std::set<std::string> &names)
+{
+    std::string::size_type pos = 0;
+    while (pos < str.size()) {
+        if (!std::isalnum((unsigned char)str[pos]) && str[pos] != '_') {
+            ++pos;
+            continue;
+        }
+        const std::string::size_type start = pos;
+        while (pos < str.size() && (std::isalnum((unsigned char)str[pos]) || str[pos] == '_'))
+            ++pos;
+        const auto it = cfg.find(str.substr(start, pos - start));
+        if (it != cfg.end() && names.insert(it->first).second)
+            addConditionNames(cfg, it->second, names);
+    }
+}
+
+bool Preprocessor::match_cfg_def(const std::map<std::string, std::string> &cfg, const std::string &def)
+{
+    // The result only depends on the macros that the condition uses,
+    // directly or through the values of other macros
+    std::set<std::string> names;
+    addConditionNames(cfg, def, names);
+    std::string key(def);
+    for (auto it = names.begin(); it != names.end(); ++it)
+        key += "\n" + *it + "=" + cfg.find(*it)->second;
+
+    const auto cached = _conditionResults.find(key);
+    if (cached != _conditionResults.end())
+        return cached->second;
+
+    std::map<std::string, std::string> usedCfg;
+    for (auto it = names.begin(); it != names.end(); ++it)
+        usedCfg.insert(*cfg.find(*it));
+    const bool result = evaluateCondition(usedCfg, def);
+    _conditionResults[key] = result;
+    return result;
+}
+
+bool Preprocessor::evaluateCondition(std::map<std::string, std::string> cfg, std::string def)
 {
     /*
         std::cout << "cfg: \"";
@@ -1760,7 +1872,8 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
     // For the error report
     unsigned int lineno = 0;
 
-    std::ostringstream ret;
+    std::string ret;
+    ret.reserve(filedata.size());
 
     bool match = true;
     std::list<bool> matching_ifdef;
@@ -1772,9 +1885,9 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
     std::stack<std::string> filenames;
     filenames.push(filename);
     std::stack<unsigned int> lineNumbers;
-    std::istringstream istr(filedata);
+    std::string::size_type filePos = 0;
     std::string line;
-    while (std::getline(istr, line)) {
+    while (getline(filedata, filePos, line)) {
         ++lineno;
 
         if (_settings && _settings->terminated())
@@ -1784,9 +1897,9 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
 
         if (line.compare(0, 11, "#pragma asm") == 0) 
 		{
-            ret << "\n";
+            ret += '\n';
             bool found_end = false;
-            while (getline(istr, line)) 
+            while (getline(filedata, filePos, line)) 
 			{
                 if (line.compare(0, 14, "#pragma endasm") == 0) 
 				{
@@ -1794,7 +1907,7 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
                     break;
                 }
 
-                ret << "\n";
+                ret += '\n';
             }
 			
             if (!found_end)
@@ -1810,11 +1923,11 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
                 tokenizer.tokenize(tempIstr, "", "", true);
                 if (Token::Match(tokenizer.tokens(), "( %var% = %any% )")) 
 				{
-                    ret << "asm(" << tokenizer.tokens()->strAt(1) << ");";
+                    ret += "asm(" + tokenizer.tokens()->strAt(1) + ");";
                 }
             }
 
-            ret << "\n";
+            ret += '\n';
 
             continue;
         }
@@ -2023,14 +2136,15 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
             line = "";
         }
 
-        ret << line << "\n";
+        ret += line;
+        ret += '\n';
     }
 
-    if (!validateCfg(ret.str(), cfg)) {
+    if (!validateCfg(ret, cfg)) {
         return "";
     }
 
-    return expandMacros(ret.str(), filename, cfg, _errorLogger);
+    return expandMacros(ret, filename, cfg, _errorLogger, &_macroDefinitions);
 }
 
 void Preprocessor::error(const std::string &filename, unsigned int linenr, const std::string &msg)
@@ -2110,6 +2224,34 @@ static bool openHeader(std::string &filename, const std::list<std::string> &incl
 }
 
 
+std::string Preprocessor::readHeader(std::istream &istr, const std::string &filename)
+{
+    // settings that change how the comments are handled
+    unsigned int options = 0;
+    if (_settings) {
+        if (_settings->checkConfiguration)
+            options |= HeaderCache::CHECK_CONFIGURATION;
+        if (_settings->_inlineSuppressions)
+            options |= HeaderCache::INLINE_SUPPRESSIONS;
+        if (_settings->isEnabled("style") && _settings->experimental)
+            options |= HeaderCache::FALL_THROUGH;
+    }
+    HeaderCache::Stamp stamp;
+    const bool cacheable = HeaderCache::stamp(filename, stamp);
+
+    std::string code;
+    if (cacheable && HeaderCache::instance().get(filename, stamp, options, code))
+        return code;
+
+    const unsigned int sideEffects = _commentSideEffects;
+    code = read(istr, filename);
+
+    if (cacheable && sideEffects == _commentSideEffects && !(_settings && _settings->terminated()))
+        HeaderCache::instance().put(filename, stamp, options, code);
+
+    return code;
+}
+
 std::string Preprocessor::handleIncludes(const std::string &code, const std::string &filePath, const std::list<std::string> &includePaths, std::map<std::string,std::string> &defs, std::set<std::string> &pragmaOnce, std::list<std::string> includes)
 {
     std::string path;
@@ -2134,11 +2276,12 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
     if (_errorLogger)
         _errorLogger->reportProgress(filePath, "Preprocessor (handleIncludes)", 0);
 
-    std::ostringstream ostr;
-    std::istringstream istr(code);
+    std::string ostr;
+    ostr.reserve(code.size());
+    std::string::size_type filePos = 0;
     std::string line;
     bool suppressCurrentCodePath = false;
-    while (std::getline(istr,line)) {
+    while (getline(code, filePos, line)) {
         ++linenr;
 
         if (_settings && _settings->terminated())
@@ -2272,7 +2415,7 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
 
                 const HeaderTypes headerType = getHeaderFileName(filename);
                 if (headerType == NoHeader) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2287,13 +2430,13 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
                                    filename,
                                    headerType
                                   );
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
                 // Prevent that files are recursively included
                 if (std::find(includes.begin(), includes.end(), filename) != includes.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2301,25 +2444,25 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
 
                 // Don't include header if it's already included and contains #pragma once
                 if (pragmaOnce.find(filename) != pragmaOnce.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
-                ostr << "#file \"" << filename << "\"\n"
-                     << handleIncludes(read(fin, filename), filename, includePaths, defs, pragmaOnce, includes) << std::endl
-                     << "#endfile\n";
+                ostr += "#file \"" + filename + "\"\n";
+                ostr += handleIncludes(readHeader(fin, filename), filename, includePaths, defs, pragmaOnce, includes);
+                ostr += "\n#endfile\n";
                 continue;
             }
 
             if (!suppressCurrentCodePath)
-                ostr << line;
+                ostr += line;
         }
 
         // A line has been read..
-        ostr << "\n";
+        ostr += '\n';
     }
 
-    return ostr.str();
+    return ostr;
 }
 
 
@@ -2383,7 +2526,7 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
             }
 
             handledFiles.insert(tempFile);
-            processedFile = Preprocessor::read(fin, filename);
+            processedFile = readHeader(fin, filename);
             fin.close();
         }
 
@@ -2608,7 +2751,7 @@ private:
 
     /** @brief expand inner macro */
     std::vector<std::string> expandInnerMacros(const std::vector<std::string> &params1,
-            const std::map<std::string, PreprocessorMacro *> &macros) const {
+            const std::map<std::string, const PreprocessorMacro *> &macros) const {
         std::string innerMacroName;
 
         // Is there an inner macro..
@@ -2646,7 +2789,7 @@ private:
                         const PreprocessorMacro *innerMacro = it->second;
 
                         std::string innercode;
-                        std::map<std::string,PreprocessorMacro *> innermacros = macros;
+                        std::map<std::string, const PreprocessorMacro *> innermacros = macros;
                         innermacros.erase(innerMacroName);
                         innerMacro->code(innerparams, innermacros, innercode);
                         params2[ipar] = innercode;
@@ -2738,7 +2881,7 @@ public:
      * @param macrocode output string
      * @return true if the expanding was successful
      */
-    bool code(const std::vector<std::string> &params2, const std::map<std::string, PreprocessorMacro *> &macros, std::string &macrocode) const {
+    bool code(const std::vector<std::string> &params2, const std::map<std::string, const PreprocessorMacro *> &macros, std::string &macrocode) const {
         if (_nopar || (_params.empty() && _variadic)) {
             macrocode = _macro.substr(1 + _macro.find(")"));
             if (macrocode.empty())
@@ -2867,34 +3010,36 @@ public:
 /**
  * Get data from a input string. This is an extended version of std::getline.
  * The std::getline only get a single line at a time. It can therefore happen that it
- * contains a partial statement. This function ensures that the returned data
- * doesn't end in the middle of a statement. The "getlines" name indicate that
+ * contains a partial macro call. This function ensures that the returned data
+ * doesn't end in the middle of a macro call. The "getlines" name indicate that
  * this function will return multiple lines if needed.
- * @param istr input stream
+ * @param code input code
+ * @param pos position in code, updated to the start of the next data
  * @param line output data
  * @return success
  */
-static bool getlines(std::istream &istr, std::string &line)
+static bool getlines(const std::string &code, std::string::size_type &pos, std::string &line)
 {
-    if (!istr.good())
+    if (pos >= code.size())
         return false;
     line = "";
     int parlevel = 0;
-    for (char ch = (char)istr.get(); istr.good(); ch = (char)istr.get()) {
+    while (pos < code.size()) {
+        const char ch = code[pos++];
         if (ch == '\'' || ch == '\"') {
             line += ch;
             char c = 0;
-            while (istr.good() && c != ch) {
+            while (c != ch) {
                 if (c == '\\') {
-                    c = (char)istr.get();
-                    if (!istr.good())
+                    if (pos >= code.size())
                         return true;
+                    c = code[pos++];
                     line += c;
                 }
 
-                c = (char)istr.get();
-                if (!istr.good())
+                if (pos >= code.size())
                     return true;
+                c = code[pos++];
                 if (c == '\n' && line.compare(0, 1, "#") == 0)
                     return true;
                 line += c;
@@ -2909,7 +3054,16 @@ static bool getlines(std::istream &istr, std::string &line)
             if (line.compare(0, 1, "#") == 0)
                 return true;
 
-            if (istr.peek() == '#') {
+            if (pos < code.size() && code[pos] == '#') {
+                line += ch;
+                return true;
+            }
+
+            // Split long statements at line ends that are not within a
+            // macro call, so the macros are expanded in short lines. A
+            // macro call can continue on the next line only if it starts
+            // with '(' or the next line is empty.
+            if (parlevel <= 0 && pos < code.size() && code[pos] != '(' && code[pos] != '\n' && code[pos] != ' ') {
                 line += ch;
                 return true;
             }
@@ -2994,13 +3148,40 @@ void Preprocessor::validateCfgError(const std::string &cfg, const std::string &m
     _errorLogger->reportInfo(errmsg);
 }
 
-std::string Preprocessor::expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger)
+static void deleteMacros(std::map<std::string, PreprocessorMacro *> &definitions)
+{
+    for (auto it = definitions.begin(); it != definitions.end(); ++it)
+        delete it->second;
+    definitions.clear();
+}
+
+Preprocessor::~Preprocessor()
+{
+    deleteMacros(_macroDefinitions);
+}
+
+/** Get the macro of a definition. The macro is only parsed if it is not in the definitions yet. */
+static PreprocessorMacro *getMacro(std::map<std::string, PreprocessorMacro *> &definitions, const std::string &def)
+{
+    PreprocessorMacro *&macro = definitions[def];
+    if (!macro)
+        macro = new PreprocessorMacro(def);
+    return macro;
+}
+
+std::string Preprocessor::expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger,
+                                       std::map<std::string, PreprocessorMacro *> *definitions)
 {
     // Search for macros and expand them..
     // --------------------------------------------
 
+    // The parsed macros are owned by the definitions
+    std::map<std::string, PreprocessorMacro *> localDefinitions;
+    if (!definitions)
+        definitions = &localDefinitions;
+
     // Available macros (key=macroname, value=macro).
-    std::map<std::string, PreprocessorMacro *> macros;
+    std::map<std::string, const PreprocessorMacro *> macros;
 
     {
         // fill up "macros" with user defined macros
@@ -3009,8 +3190,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
             std::string s = it->first;
             if (!it->second.empty())
                 s += " " + it->second;
-            PreprocessorMacro *macro = new PreprocessorMacro(s);
-            macros[it->first] = macro;
+            macros[it->first] = getMacro(*definitions, s);
         }
     }
 
@@ -3020,25 +3200,22 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
     // linenr, filename
     std::stack< std::pair<unsigned int, std::string> > fileinfo;
 
-    // output stream
-    std::ostringstream ostr;
+    // output
+    std::string ostr;
+    ostr.reserve(code.size());
 
     // read code..
-    std::istringstream istr(code);
+    std::string::size_type codePos = 0;
     std::string line;
-    while (getlines(istr, line)) {
+    while (getlines(code, codePos, line)) {
         // defining a macro..
         if (line.compare(0, 8, "#define ") == 0) {
-            PreprocessorMacro *macro = new PreprocessorMacro(line.substr(8));
+            const PreprocessorMacro *macro = getMacro(*definitions, line.substr(8));
             if (macro->name().empty() || macro->name() == "NULL") {
-                delete macro;
+                // ignore
             } else if (macro->name() == "BOOST_FOREACH") {
                 // BOOST_FOREACH is currently too complex to parse, so skip it.
-                delete macro;
             } else {
-                auto it = macros.find(macro->name());
-                if (it != macros.end())
-                    delete it->second;
                 macros[macro->name()] = macro;
             }
             line = "\n";
@@ -3046,11 +3223,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
 
         // undefining a macro..
         else if (line.compare(0, 7, "#undef ") == 0) {
-            auto it = macros.find(line.substr(7));
-            if (it != macros.end()) {
-                delete it->second;
-                macros.erase(it);
-            }
+            macros.erase(line.substr(7));
             line = "\n";
         }
 
@@ -3119,9 +3292,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
                                    "noQuoteCharPair",
                                    std::string("No pair for character (") + ch + "). Can't process file. File is either invalid or unicode, which is currently not supported.");
 
-                        for (auto it = macros.begin(); it != macros.end(); ++it)
-                            delete it->second;
-                        macros.clear();
+                        deleteMacros(localDefinitions);
                         return "";
                     }
 
@@ -3198,9 +3369,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
                                    "syntaxError",
                                    std::string("Syntax error. Not enough parameters for macro '") + macro->name() + "'.");
 
-                        for (auto iter = macros.begin(); iter != macros.end(); ++iter)
-                            delete iter->second;
-                        macros.clear();
+                        deleteMacros(localDefinitions);
                         return "";
                     }
 
@@ -3302,7 +3471,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
         }
 
         // the line has been processed in various ways. Now add it to the output stream
-        ostr << line;
+        ostr += line;
 
         // update linenr
         for (std::string::size_type p = 0; p < line.length(); ++p) {
@@ -3311,11 +3480,9 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
         }
     }
 
-    for (auto it = macros.begin(); it != macros.end(); ++it)
-        delete it->second;
-    macros.clear();
+    deleteMacros(localDefinitions);
 
-    return ostr.str();
+    return ostr;
 }
 
 
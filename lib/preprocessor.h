@@ -29,6 +29,7 @@
 #include "config.h"
 
 class ErrorLogger;
+class PreprocessorMacro;
 class Settings;
 
 /// @addtogroup Core
@@ -55,6 +56,7 @@ public:
     static char macroChar;
 
     Preprocessor(Settings *settings = nullptr, ErrorLogger *errorLogger = nullptr);
+    ~Preprocessor();
 
     static bool missingIncludeFlag;
     static bool missingSystemIncludeFlag;
@@ -94,8 +96,8 @@ public:
     /** Just read the code into a string. Perform simple cleanup of the code */
     std::string read(std::istream &istr, const std::string &filename);
 
-    /** read preprocessor statements into a string. */
-    static std::string readpreprocessor(std::istream &istr, const unsigned int bom);
+    /** read preprocessor statements of the buffer, starting at pos, into a string. */
+    static std::string readpreprocessor(const std::string &buf, std::string::size_type pos, const unsigned int bom);
 
     /** should __cplusplus be defined? */
     static bool cplusplus(const Settings *settings, const std::string &filename);
@@ -157,9 +159,12 @@ public:
      * @param filename filename of source file
      * @param cfg user given -D configuration
      * @param errorLogger Error logger to write errors to (if any)
+     * @param definitions macros that have been parsed already, by their definition.
+     * New macros are added. If this is null the macros are parsed again.
      * @return the expanded string
      */
-    static std::string expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger);
+    static std::string expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger,
+                                    std::map<std::string, PreprocessorMacro *> *definitions = nullptr);
 
     /**
      * Remove comments from code. This should only be called from read().
@@ -190,6 +195,15 @@ public:
      */
     static std::string preprocessCleanupDirectives(const std::string &processedFile);
 
+    /**
+     * clean up #-preprocessor lines, and optionally remove redundant parentheses
+     * from the conditions. Same as removeParentheses(preprocessCleanupDirectives(..))
+     * but the code is only scanned once.
+     * @param processedFile The data to be processed
+     * @param parentheses remove redundant parentheses
+     */
+    static std::string cleanupDirectives(const std::string &processedFile, bool parentheses);
+
     /**
      * Returns the string between double quote characters or \< \> characters.
      * @param str e.g. \code#include "menu.h"\endcode or \code#include <menu.h>\endcode
@@ -209,7 +223,7 @@ private:
      */
     static std::string removeSpaceNearNL(const std::string &str);
 
-    static std::string getdef(std::string line, bool def);
+    static std::string getdef(const std::string &directive, bool def);
 
 public:
 
@@ -226,12 +240,13 @@ public:
     static void removeAsm(std::string &str);
 
     /**
-     * Evaluate condition 'numerically'
+     * Evaluate condition 'numerically'. The results are remembered, a
+     * condition is evaluated again only if a macro it uses has changed.
      * @param cfg configuration
      * @param def condition
      * @return result when evaluating the condition
      */
-    bool match_cfg_def(std::map<std::string, std::string> cfg, std::string def);
+    bool match_cfg_def(const std::map<std::string, std::string> &cfg, const std::string &def);
 
     static void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings);
 
@@ -252,6 +267,18 @@ public:
     }
 
 private:
+    /**
+     * Evaluate condition 'numerically', without using the remembered results
+     * @param cfg configuration
+     * @param def condition
+     * @return result when evaluating the condition
+     */
+    bool evaluateCondition(std::map<std::string, std::string> cfg, std::string def);
+
+    /** disabled copy constructor and assignment operator */
+    Preprocessor(const Preprocessor &);
+    void operator=(const Preprocessor &);
+
     void missingInclude(const std::string &filename, unsigned int linenr, const std::string &header, HeaderTypes headerType);
 
     void error(const std::string &filename, unsigned int linenr, const std::string &msg);
@@ -269,11 +296,37 @@ private:
      */
     void handleIncludes(std::string &code, const std::string &filePath, const std::list<std::string> &includePaths);
 
+    /**
+     * Read header. The result is taken from the HeaderCache if the header
+     * has been read before.
+     * @param istr opened header file
+     * @param filename header filename
+     */
+    std::string readHeader(std::istream &istr, const std::string &filename);
+
     Settings *_settings;
     ErrorLogger *_errorLogger;
 
+    /**
+     * Number of errors and inline suppressions that removeComments() has
+     * reported. Code that causes such side effects is not cached.
+     */
+    unsigned int _commentSideEffects;
+
     /** filename for cpp/c file - useful when reporting errors */
     std::string file0;
+
+    /**
+     * Macros of the #define lines, by definition. They are parsed once and
+     * shared by all configurations of the file.
+     */
+    std::map<std::string, PreprocessorMacro *> _macroDefinitions;
+
+    /**
+     * Results of match_cfg_def(). The key is the condition and the values
+     * of the macros that it uses.
+     */
+    std::map<std::string, bool> _conditionResults;
 };
 
 /// @}
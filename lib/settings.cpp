@@ -38,6 +38,10 @@ Settings::Settings()
       _relativePaths(false),
       _xml(false), _xml_version(1),
       _jobs(1),
+      _executor(Process),
+      _configJobs(1),
+      _symbolDatabaseJobs(1),
+      _templateCacheSize(500000),
       _loadAverage(0),
       _exitCode(0),
       _showtime(SHOWTIME_NONE),
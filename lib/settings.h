@@ -26,6 +26,7 @@
 #include <string>
 #include <set>
 #include "config.h"
+#include "changedlines.h"
 #include "library.h"
 #include "suppressions.h"
 #include "standards.h"
@@ -118,6 +119,27 @@ public:
         time. Default is 1. (-j N) */
     unsigned int _jobs;
 
+    /** @brief Parallelization used when several jobs are used */
+    enum ExecutorType { Process, Thread };
+
+    /** @brief Check files in child processes or in threads (--executor=..).
+        Threads are used on platforms without fork(). */
+    ExecutorType _executor;
+
+    /** @brief How many threads should check the preprocessor configurations
+        of one file at the same time. Default is 1. (--config-jobs=N) */
+    unsigned int _configJobs;
+
+    /** @brief How many threads should analyse the function bodies when
+        the symbol database of a file is created. Default is 1.
+        (--symboldatabase-jobs=N) */
+    unsigned int _symbolDatabaseJobs;
+
+    /** @brief How many tokens of template expansions are kept to be reused
+        in other configurations and files. Default is 500000, 0 disables
+        the cache. (--template-cache-size=N) */
+    unsigned int _templateCacheSize;
+
     /** @brief Load average value */
     unsigned int _loadAverage;
 
@@ -142,6 +164,13 @@ public:
     /** @brief get append code (--append) */
     const std::string &append() const;
 
+    /** @brief Folder where analysis results are cached (--cache-dir) */
+    std::string cacheDir;
+
+    /** @brief Only check the functions that overlap these lines (--diff).
+        Files without changes are only analysed for whole program checks. */
+    ChangedLines _changedLines;
+
     /** @brief Maximum number of configurations to check before bailing.
         Default is 12. (--max-configs=N) */
     unsigned int _maxConfigs;
@@ -165,6 +194,11 @@ public:
      */
     std::string addEnabled(const std::string &str);
 
+    /** @brief Get ids of the enabled extra checks */
+    const std::set<std::string> &enabled() const {
+        return _enabled;
+    }
+
     /**
      * @brief Disables all severities, except from error.
      */
@@ -22,7 +22,6 @@
 
 #include <algorithm>
 #include <sstream>
-#include <stack>
 #include <cctype>   // std::isdigit, std::isalnum, etc
 
 std::string Suppressions::parseFile(std::istream &istr)
@@ -94,64 +93,82 @@ std::string Suppressions::addSuppressionLine(const std::string &line)
     return "";
 }
 
-bool Suppressions::FileMatcher::match(const std::string &pattern, const std::string &name)
+void Suppressions::FileMatcher::compileGlobs()
 {
-    const char *p = pattern.c_str();
-    const char *n = name.c_str();
-    std::stack<std::pair<const char *, const char *> > backtrack;
-
-    for (;;) {
-        bool matching = true;
-        while (*p != '\0' && matching) {
-            switch (*p) {
-            case '*':
-                // Step forward until we match the next character after *
-                while (*n != '\0' && *n != p[1]) {
-                    n++;
-                }
-                if (*n != '\0') {
-                    // If this isn't the last possibility, save it for later
-                    backtrack.push(std::make_pair(p, n));
-                }
-                break;
-            case '?':
-                // Any character matches unless we're at the end of the name
-                if (*n != '\0') {
-                    n++;
-                } else {
-                    matching = false;
-                }
-                break;
-            default:
-                // Non-wildcard characters match literally
-                if (*n == *p) {
-                    n++;
-                } else {
-                    matching = false;
-                }
-                break;
+    _globNodes.assign(1U, GlobNode());
+    _globNames.clear();
+    for (auto g = _globs.begin(); g != _globs.end(); ++g) {
+        std::size_t node = 0;
+        for (auto c = g->first.begin(); c != g->first.end(); ++c) {
+            std::size_t next;
+            if (*c == '*')
+                next = _globNodes[node].star;
+            else if (*c == '?')
+                next = _globNodes[node].any;
+            else {
+                const auto it = _globNodes[node].next.find(*c);
+                next = (it == _globNodes[node].next.end()) ? 0 : it->second;
             }
-            p++;
+            if (next == 0) {
+                next = _globNodes.size();
+                _globNodes.push_back(GlobNode());
+                _globNodes[next].isStar = (*c == '*');
+                if (*c == '*')
+                    _globNodes[node].star = next;
+                else if (*c == '?')
+                    _globNodes[node].any = next;
+                else
+                    _globNodes[node].next[*c] = next;
+            }
+            node = next;
         }
+        _globNodes[node].globs.push_back(_globNames.size());
+        _globNames.push_back(g->first);
+    }
+    _step.assign(_globNodes.size(), 0);
+    _currentStep = 0;
+}
 
-        // If we haven't failed matching and we've reached the end of the name, then success
-        if (matching && *n == '\0') {
-            return true;
-        }
+void Suppressions::FileMatcher::addActive(std::size_t node, std::vector<std::size_t> &active)
+{
+    while (_step[node] != _currentStep) {
+        _step[node] = _currentStep;
+        active.push_back(node);
+        node = _globNodes[node].star;
+        if (node == 0)
+            break;
+    }
+}
 
-        // If there are no other paths to try, then fail
-        if (backtrack.empty()) {
-            return false;
+void Suppressions::FileMatcher::matchGlobs(const std::string &name, std::vector<std::size_t> &globs)
+{
+    if (_globNodes.empty())
+        compileGlobs();
+
+    // All globs are matched at once, the active nodes are the positions in
+    // the globs that match the name so far
+    _active.clear();
+    ++_currentStep;
+    addActive(0, _active);
+    for (auto c = name.begin(); c != name.end() && !_active.empty(); ++c) {
+        _nextActive.clear();
+        ++_currentStep;
+        for (auto n = _active.begin(); n != _active.end(); ++n) {
+            const GlobNode &node = _globNodes[*n];
+            if (node.isStar)
+                addActive(*n, _nextActive);
+            if (node.any)
+                addActive(node.any, _nextActive);
+            const auto next = node.next.find(*c);
+            if (next != node.next.end())
+                addActive(next->second, _nextActive);
         }
-
-        // Restore pointers from backtrack stack
-        p = backtrack.top().first;
-        n = backtrack.top().second;
-        backtrack.pop();
-
-        // Advance name pointer by one because the current position didn't work
-        n++;
+        _active.swap(_nextActive);
     }
+
+    for (auto n = _active.begin(); n != _active.end(); ++n)
+        globs.insert(globs.end(), _globNodes[*n].globs.begin(), _globNodes[*n].globs.end());
+    std::sort(globs.begin(), globs.end());
 }
 
 std::string Suppressions::FileMatcher::addFile(const std::string &name, unsigned int line)
@@ -166,8 +183,10 @@ std::string Suppressions::FileMatcher::addFile(const std::string &name, unsigned
             }
         }
         _globs[name][line] = false;
+        _globNodes.clear();
     } else if (name.empty()) {
         _globs["*"][0U] = false;
+        _globNodes.clear();
     } else {
         _files[Path::simplifyPath(name)][line] = false;
     }
@@ -179,18 +198,22 @@ bool Suppressions::FileMatcher::isSuppressed(const std::string &file, unsigned i
     if (isSuppressedLocal(file, line))
         return true;
 
-    for (auto g = _globs.begin(); g != _globs.end(); ++g) {
-        if (match(g->first, file)) {
-            auto l = g->second.find(0U);
-            if (l != g->second.end()) {
-                l->second = true;
-                return true;
-            }
-            l = g->second.find(line);
-            if (l != g->second.end()) {
-                l->second = true;
-                return true;
-            }
+    if (_globs.empty())
+        return false;
+
+    std::vector<std::size_t> globs;
+    matchGlobs(file, globs);
+    for (auto i = globs.begin(); i != globs.end(); ++i) {
+        std::map<unsigned int, bool> &lines = _globs[_globNames[*i]];
+        auto l = lines.find(0U);
+        if (l != lines.end()) {
+            l->second = true;
+            return true;
+        }
+        l = lines.find(line);
+        if (l != lines.end()) {
+            l->second = true;
+            return true;
         }
     }
 
@@ -243,26 +266,26 @@ std::string Suppressions::addSuppression(const std::string &errorId, const std::
 
 bool Suppressions::isSuppressed(const std::string &errorId, const std::string &file, unsigned int line)
 {
-    if (errorId != "unmatchedSuppression" && _suppressions.find("*") != _suppressions.end())
-        if (_suppressions["*"].isSuppressed(file, line))
+    if (errorId != "unmatchedSuppression") {
+        auto all = _suppressions.find("*");
+        if (all != _suppressions.end() && all->second.isSuppressed(file, line))
             return true;
+    }
 
-    if (_suppressions.find(errorId) == _suppressions.end())
-        return false;
-
-    return _suppressions[errorId].isSuppressed(file, line);
+    auto it = _suppressions.find(errorId);
+    return it != _suppressions.end() && it->second.isSuppressed(file, line);
 }
 
 bool Suppressions::isSuppressedLocal(const std::string &errorId, const std::string &file, unsigned int line)
 {
-    if (errorId != "unmatchedSuppression" && _suppressions.find("*") != _suppressions.end())
-        if (_suppressions["*"].isSuppressedLocal(file, line))
+    if (errorId != "unmatchedSuppression") {
+        auto all = _suppressions.find("*");
+        if (all != _suppressions.end() && all->second.isSuppressedLocal(file, line))
             return true;
+    }
 
-    if (_suppressions.find(errorId) == _suppressions.end())
-        return false;
-
-    return _suppressions[errorId].isSuppressedLocal(file, line);
+    auto it = _suppressions.find(errorId);
+    return it != _suppressions.end() && it->second.isSuppressedLocal(file, line);
 }
 
 std::list<Suppressions::SuppressionEntry> Suppressions::getUnmatchedLocalSuppressions(const std::string &file, bool unusedFunctionChecking) const
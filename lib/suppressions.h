@@ -24,6 +24,8 @@
 #include <string>
 #include <istream>
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "config.h"
 
 /// @addtogroup Core
@@ -36,19 +38,55 @@ private:
         friend class Suppressions;
     private:
         /** @brief List of filenames suppressed, bool flag indicates whether suppression matched. */
-        std::map<std::string, std::map<unsigned int, bool> > _files;
+        std::unordered_map<std::string, std::map<unsigned int, bool> > _files;
         /** @brief List of globs suppressed, bool flag indicates whether suppression matched. */
         std::map<std::string, std::map<unsigned int, bool> > _globs;
 
         /**
-         * @brief Match a name against a glob pattern.
-         * @param pattern The glob pattern to match.
-         * @param name The filename to match against the glob pattern.
-         * @return match success
+         * @brief Node of the automaton that matches a name against all globs at once.
+         * The globs are stored in a trie, a '*' node matches any number of characters.
          */
-        static bool match(const std::string &pattern, const std::string &name);
+        struct GlobNode {
+            GlobNode() : any(0), star(0), isStar(false) {}
+
+            /** next node for a literal character */
+            std::map<char, std::size_t> next;
+            /** next node for '?', 0 if there is none */
+            std::size_t any;
+            /** next node for '*', 0 if there is none */
+            std::size_t star;
+            /** is this the node after a '*'? */
+            bool isStar;
+            /** the globs that end in this node, index in _globNames */
+            std::vector<std::size_t> globs;
+        };
+
+        /** @brief Compiled globs, node 0 is the start. It is empty when the globs must be compiled. */
+        std::vector<GlobNode> _globNodes;
+        /** @brief The compiled globs, in the order of _globs */
+        std::vector<std::string> _globNames;
+        /** @brief Active nodes while a name is matched, and the step that added a node */
+        std::vector<std::size_t> _active;
+        std::vector<std::size_t> _nextActive;
+        std::vector<std::size_t> _step;
+        std::size_t _currentStep;
+
+        /** @brief Build the automaton from _globs */
+        void compileGlobs();
+
+        /** @brief Add node, and the '*' node after it that also matches zero characters */
+        void addActive(std::size_t node, std::vector<std::size_t> &active);
+
+        /**
+         * @brief Match a name against all globs.
+         * @param name The filename to match
+         * @param globs The matching globs, index in _globNames in ascending order
+         */
+        void matchGlobs(const std::string &name, std::vector<std::size_t> &globs);
 
     public:
+        FileMatcher() : _currentStep(0) {}
+
         /**
          * @brief Add a file or glob (and line number).
          * @param name File name or glob pattern
@@ -28,6 +28,53 @@
 #include <ostream>
 #include <climits>
 #include <iostream>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+//---------------------------------------------------------------------------
+
+/**
+ * Call work(i) for each i in [0, count) in up to 'jobs' threads. If work()
+ * throws, the remaining items are skipped and the exception is rethrown in
+ * the calling thread.
+ */
+template<class Work>
+static void forEachInThreads(std::size_t count, unsigned int jobs, const Work &work)
+{
+    if (jobs <= 1U || count <= 1U) {
+        for (std::size_t i = 0; i < count; ++i)
+            work(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorSync;
+    auto worker = [&]() {
+        try {
+            for (std::size_t i = next++; i < count; i = next++)
+                work(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorSync);
+            if (!error)
+                error = std::current_exception();
+            next = count;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t threadCount = std::min<std::size_t>(jobs, count);
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
 
 //---------------------------------------------------------------------------
 
@@ -120,11 +167,9 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 // fill typeList...
                 if (new_scope->isClassOrStruct() || new_scope->type == Scope::eUnion) {
                     Type* new_type = findType(tok->next(), scope);
-                    if (!new_type) {
-                        typeList.push_back(Type(new_scope->classDef, new_scope, scope));
-                        new_type = &typeList.back();
-                        scope->definedTypes.push_back(new_type);
-                    } else
+                    if (!new_type)
+                        new_type = addType(Type(new_scope->classDef, new_scope, scope), scope);
+                    else
                         new_type->classScope = new_scope;
                     new_scope->definedType = new_type;
                 }
@@ -149,7 +194,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 }
 
                 // make the new scope the current scope
-                scope->nestedList.push_back(new_scope);
+                scope->addNestedScope(new_scope);
                 scope = new_scope;
 
                 tok = tok2;
@@ -178,7 +223,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = &scopeList.back();
 
             tok = tok2;
@@ -189,8 +234,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                  tok->strAt(-1) != "friend") {
             if (!findType(tok->next(), scope)) {
                 // fill typeList..
-                typeList.push_back(Type(tok, 0, scope));
-                scope->definedTypes.push_back(&typeList.back());
+                addType(Type(tok, 0, scope), scope);
             }
             tok = tok->tokAt(2);
         }
@@ -230,9 +274,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 varNameTok = varNameTok->next();
             }
 
-            typeList.push_back(Type(tok, new_scope, scope));
-            new_scope->definedType = &typeList.back();
-            scope->definedTypes.push_back(&typeList.back());
+            new_scope->definedType = addType(Type(tok, new_scope, scope), scope);
 
             scope->addVariable(varNameTok, tok, tok, access[scope], new_scope->definedType, scope);
 
@@ -248,7 +290,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -268,9 +310,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             new_scope->classStart = tok2;
             new_scope->classEnd = tok2->link();
 
-            typeList.push_back(Type(tok, new_scope, scope));
-            new_scope->definedType = &typeList.back();
-            scope->definedTypes.push_back(&typeList.back());
+            new_scope->definedType = addType(Type(tok, new_scope, scope), scope);
 
             // make sure we have valid code
             if (!new_scope->classEnd) {
@@ -279,7 +319,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -740,7 +780,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                         scopeList.push_back(Scope(this, tok, scope, Scope::eTry, tok1));
 
                     tok = tok1;
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                 } else if (Token::Match(tok, "if|for|while|catch|switch (") && Token::simpleMatch(tok->next()->link(), ") {")) {
                     const Token *tok1 = tok->next()->link()->next();
@@ -755,7 +795,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                     } else // if (tok->str() == "switch")
                         scopeList.push_back(Scope(this, tok, scope, Scope::eSwitch, tok1));
 
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                     if (scope->type == Scope::eFor)
                         scope->checkVariable(tok->tokAt(2), Local); // check for variable declaration and add it to new scope if found
@@ -765,11 +805,11 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 } else if (tok->str() == "{" && !tok->previous()->varId()) {
                     if (tok->strAt(-1) == ")" && tok->linkAt(-1)->strAt(-1) == "]") {
                         scopeList.push_back(Scope(this, tok->linkAt(-1)->linkAt(-1), scope, Scope::eLambda, tok));
-                        scope->nestedList.push_back(&scopeList.back());
+                        scope->addNestedScope(&scopeList.back());
                         scope = &scopeList.back();
                     } else if (!Token::Match(tok->previous(), "=|,|(|return") && !(tok->strAt(-1) == ")" && Token::Match(tok->linkAt(-1)->previous(), "=|,|(|return"))) {
                         scopeList.push_back(Scope(this, tok, scope, Scope::eUnconditional, tok));
-                        scope->nestedList.push_back(&scopeList.back());
+                        scope->addNestedScope(&scopeList.back());
                         scope = &scopeList.back();
                     } else {
                         tok = tok->link();
@@ -811,11 +851,24 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
         }
     }
 
-    // fill in variable info
+    // The function bodies are analysed in several threads
+    // (--symboldatabase-jobs). Debug messages are reported in token
+    // order, so they need a single thread.
+    const unsigned int jobs = _settings->debugwarnings ? 1U : _settings->_symbolDatabaseJobs;
+
+    // fill in variable info. The local variables of the executable scopes
+    // only depend on the types and namespaces that are known now.
+    std::vector<Scope *> executableScopes;
     for (auto it = scopeList.begin(); it != scopeList.end(); ++it) {
         // find variables
-        it->getVariableList();
+        if (it->isExecutable())
+            executableScopes.push_back(&*it);
+        else
+            it->getVariableList();
     }
+    forEachInThreads(executableScopes.size(), jobs, [&](std::size_t i) {
+        executableScopes[i]->getVariableList();
+    });
 
     // fill in function arguments
     for (auto it = scopeList.begin(); it != scopeList.end(); ++it) {
@@ -1113,13 +1166,36 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
         }
     }
 
-    // Set function call pointers
-    for (const Token* tok = _tokenizer->list.front(); tok != _tokenizer->list.back(); tok = tok->next()) {
-        if (Token::Match(tok, "%var% (")) {
-            if (!tok->function() && tok->varId() == 0)
-                const_cast<Token *>(tok)->function(findFunction(tok));
+    // Split the token list after function bodies into parts that are
+    // annotated in separate threads. A token is only compared with tokens
+    // of its own statement, so the result does not depend on the split.
+    std::vector<const Token *> parts(1, _tokenizer->list.front());
+    if (jobs > 1U) {
+        std::size_t tokenCount = 0;
+        for (const Token* tok = _tokenizer->list.front(); tok != _tokenizer->list.back(); tok = tok->next())
+            ++tokenCount;
+        const std::size_t partSize = tokenCount / (4U * jobs) + 1U;
+        std::size_t size = 0;
+        for (const Token* tok = _tokenizer->list.front(); tok != _tokenizer->list.back(); tok = tok->next()) {
+            if (++size >= partSize && tok->str() == "}" && tok->scope() &&
+                tok->scope()->type == Scope::eFunction && tok == tok->scope()->classEnd &&
+                !tok->scope()->nestedIn->isExecutable()) {
+                parts.push_back(tok->next());
+                size = 0;
+            }
         }
     }
+    parts.push_back(_tokenizer->list.back());
+
+    // Set function call pointers
+    forEachInThreads(parts.size() - 1U, jobs, [&](std::size_t part) {
+        for (const Token* tok = parts[part]; tok != parts[part + 1U]; tok = tok->next()) {
+            if (Token::Match(tok, "%var% (")) {
+                if (!tok->function() && tok->varId() == 0)
+                    const_cast<Token *>(tok)->function(findFunction(tok));
+            }
+        }
+    });
 
     // Set C++ 11 delegate constructor function call pointers
     for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
@@ -1143,63 +1219,74 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     }
 
     // Set variable pointers
-    for (const Token* tok = _tokenizer->list.front(); tok != _tokenizer->list.back(); tok = tok->next()) {
-        if (tok->varId())
-            const_cast<Token *>(tok)->variable(getVariableFromVarId(tok->varId()));
-
-        // Set Token::variable pointer for array member variable
-        // Since it doesn't point at a fixed location it doesn't have varid
-        if (tok->variable() != nullptr &&
-            tok->variable()->typeScope() &&
-            Token::Match(tok, "%var% [|.")) {
-
-            Token *tok2 = tok->next();
-            // Locate "]"
-            if (tok->next()->str() == "[") {
-                while (tok2 && tok2->str() == "[")
-                    tok2 = tok2->link()->next();
-            }
-
-            Token *membertok = nullptr;
-            if (Token::Match(tok2, ". %var%"))
-                membertok = tok2->next();
-            else if (Token::Match(tok2, ") . %var%") && tok->strAt(-1) == "(")
-                membertok = tok2->tokAt(2);
-
-            if (membertok) {
-                const Variable *var = tok->variable();
-                if (var && var->typeScope()) {
-                    const Variable *membervar = var->typeScope()->getVariable(membertok->str());
-                    if (membervar)
-                        membertok->variable(membervar);
+    forEachInThreads(parts.size() - 1U, jobs, [&](std::size_t part) {
+        for (const Token* tok = parts[part]; tok != parts[part + 1U]; tok = tok->next()) {
+            if (tok->varId())
+                const_cast<Token *>(tok)->variable(getVariableFromVarId(tok->varId()));
+
+            // Set Token::variable pointer for array member variable
+            // Since it doesn't point at a fixed location it doesn't have varid
+            if (tok->variable() != nullptr &&
+                tok->variable()->typeScope() &&
+                Token::Match(tok, "%var% [|.")) {
+
+                Token *tok2 = tok->next();
+                // Locate "]"
+                if (tok->next()->str() == "[") {
+                    while (tok2 && tok2->str() == "[")
+                        tok2 = tok2->link()->next();
                 }
-            }
-        }
 
-        // check for function returning record type
-        // func(...).var
-        // func(...)[...].var
-        else if (tok->function() && tok->next()->str() == "(" &&
-                 (Token::Match(tok->next()->link(), ") . %var% !!(") ||
-                  (Token::Match(tok->next()->link(), ") [") && Token::Match(tok->next()->link()->next()->link(), "] . %var% !!(")))) {
-            const Type *type = tok->function()->retType;
-            if (type) {
-                Token *membertok;
-                if (tok->next()->link()->next()->str() == ".")
-                    membertok = tok->next()->link()->next()->next();
-                else
-                    membertok = tok->next()->link()->next()->link()->next()->next();
-                const Variable *membervar = membertok->variable();
-                if (!membervar) {
-                    if (type->classScope) {
-                        membervar = type->classScope->getVariable(membertok->str());
+                Token *membertok = nullptr;
+                if (Token::Match(tok2, ". %var%"))
+                    membertok = tok2->next();
+                else if (Token::Match(tok2, ") . %var%") && tok->strAt(-1) == "(")
+                    membertok = tok2->tokAt(2);
+
+                if (membertok) {
+                    const Variable *var = tok->variable();
+                    if (var && var->typeScope()) {
+                        const Variable *membervar = var->typeScope()->getVariable(membertok->str());
                         if (membervar)
                             membertok->variable(membervar);
                     }
                 }
             }
+
+            // check for function returning record type
+            // func(...).var
+            // func(...)[...].var
+            else if (tok->function() && tok->next()->str() == "(" &&
+                     (Token::Match(tok->next()->link(), ") . %var% !!(") ||
+                      (Token::Match(tok->next()->link(), ") [") && Token::Match(tok->next()->link()->next()->link(), "] . %var% !!(")))) {
+                const Type *type = tok->function()->retType;
+                if (type) {
+                    Token *membertok;
+                    if (tok->next()->link()->next()->str() == ".")
+                        membertok = tok->next()->link()->next()->next();
+                    else
+                        membertok = tok->next()->link()->next()->link()->next()->next();
+                    const Variable *membervar = membertok->variable();
+                    if (!membervar) {
+                        if (type->classScope) {
+                            membervar = type->classScope->getVariable(membertok->str());
+                            if (membervar)
+                                membertok->variable(membervar);
+                        }
+                    }
+                }
+            }
         }
-    }
+    });
+}
+
+Type *SymbolDatabase::addType(const Type &type, Scope *scope)
+{
+    typeList.push_back(type);
+    Type *newType = &typeList.back();
+    _typesByName[newType->name()].push_back(newType);
+    scope->addDefinedType(newType);
+    return newType;
 }
 
 SymbolDatabase::~SymbolDatabase()
@@ -1757,7 +1844,7 @@ void SymbolDatabase::addNewFunction(Scope **scope, const Token **tok)
             return;
         }
 
-        (*scope)->nestedList.push_back(new_scope);
+        (*scope)->addNestedScope(new_scope);
         *scope = new_scope;
         *tok = tok1;
     } else {
@@ -2876,33 +2963,37 @@ bool Scope::isVariableDeclaration(const Token* tok, const Token*& vartok, const
 
 const Type* SymbolDatabase::findVariableType(const Scope *start, const Token *typeTok) const
 {
-    for (auto type = typeList.begin(); type != typeList.end(); ++type) {
-        // do the names match?
-        if (type->name() == typeTok->str()) {
-            // check if type does not have a namespace
-            if (typeTok->strAt(-1) != "::") {
-                const Scope *parent = start;
+    // the types with a matching name
+    const auto types = _typesByName.find(typeTok->str());
+    if (types == _typesByName.end())
+        return nullptr;
 
-                // check if in same namespace
-                while (parent) {
-                    // out of line class function belongs to class
-                    if (parent->type == Scope::eFunction && parent->functionOf)
-                        parent = parent->functionOf;
-                    else if (parent != type->enclosingScope)
-                        parent = parent->nestedIn;
-                    else
-                        break;
-                }
+    for (auto it = types->second.begin(); it != types->second.end(); ++it) {
+        const Type *type = *it;
 
-                if (type->enclosingScope == parent)
-                    return &(*type);
-            }
+        // check if type does not have a namespace
+        if (typeTok->strAt(-1) != "::") {
+            const Scope *parent = start;
 
-            // type has a namespace
-            else {
-                // FIXME check if namespace path matches supplied path
-                return &(*type);
+            // check if in same namespace
+            while (parent) {
+                // out of line class function belongs to class
+                if (parent->type == Scope::eFunction && parent->functionOf)
+                    parent = parent->functionOf;
+                else if (parent != type->enclosingScope)
+                    parent = parent->nestedIn;
+                else
+                    break;
             }
+
+            if (type->enclosingScope == parent)
+                return type;
+        }
+
+        // type has a namespace
+        else {
+            // FIXME check if namespace path matches supplied path
+            return type;
         }
     }
 
@@ -3192,43 +3283,33 @@ const Scope *SymbolDatabase::findScopeByName(const std::string& name) const
 
 Scope *Scope::findInNestedList(const std::string & name)
 {
-    for (auto it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
-    return 0;
+    const auto it = _nestedScopes.find(name);
+    return (it != _nestedScopes.end()) ? it->second : nullptr;
 }
 
 //---------------------------------------------------------------------------
 
 const Scope *Scope::findRecordInNestedList(const std::string & name) const
 {
-    for (auto it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name && (*it)->type != eFunction)
-            return (*it);
-    }
-    return 0;
+    const auto it = _nestedRecords.find(name);
+    return (it != _nestedRecords.end()) ? it->second : nullptr;
 }
 
 //---------------------------------------------------------------------------
 
 const Type* Scope::findType(const std::string & name) const
 {
-    for (auto it = definedTypes.begin(); it != definedTypes.end(); ++it) {
-        if ((*it)->name() == name)
-            return (*it);
-    }
-    return 0;
+    const auto it = _definedTypeMap.find(name);
+    return (it != _definedTypeMap.end()) ? it->second : nullptr;
 }
 
 //---------------------------------------------------------------------------
 
 Scope *Scope::findInNestedListRecursive(const std::string & name)
 {
-    for (auto it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
+    Scope *nested = findInNestedList(name);
+    if (nested)
+        return nested;
 
     for (auto it = nestedList.begin(); it != nestedList.end(); ++it) {
         Scope *child = (*it)->findInNestedListRecursive(name);
@@ -27,6 +27,7 @@
 #include <set>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 
 #include "config.h"
 #include "token.h"
@@ -773,6 +774,26 @@ public:
         functionMap.insert(make_pair(back->tokenDef->str(), back));
     }
 
+    /**
+     * @brief add a scope to nestedList
+     * @param scope nested scope
+     */
+    void addNestedScope(Scope *scope) {
+        nestedList.push_back(scope);
+        _nestedScopes.insert(std::make_pair(scope->className, scope));
+        if (scope->type != eFunction)
+            _nestedRecords.insert(std::make_pair(scope->className, scope));
+    }
+
+    /**
+     * @brief add a type to definedTypes
+     * @param definedType_ type that is defined in this scope
+     */
+    void addDefinedType(Type *definedType_) {
+        definedTypes.push_back(definedType_);
+        _definedTypeMap.insert(std::make_pair(definedType_->name(), definedType_));
+    }
+
     /**
      * @brief get the number of nested scopes that are not functions
      *
@@ -811,6 +832,15 @@ private:
     bool isVariableDeclaration(const Token* tok, const Token*& vartok, const Token*& typetok) const;
 
     void findFunctionInBase(const std::string & name, size_t args, std::vector<const Function *> & matches) const;
+
+    /** first scope in nestedList with a given name */
+    std::unordered_map<std::string, Scope *> _nestedScopes;
+
+    /** first scope in nestedList with a given name that is not a function */
+    std::unordered_map<std::string, Scope *> _nestedRecords;
+
+    /** first type in definedTypes with a given name */
+    std::unordered_map<std::string, Type *> _definedTypeMap;
 };
 
 class CPPCHECKLIB SymbolDatabase {
@@ -858,10 +888,7 @@ public:
     }
 
     bool isClassOrStruct(const std::string &type) const {
-        for (auto i = typeList.begin(); i != typeList.end(); ++i)
-            if (i->name() == type)
-                return true;
-        return false;
+        return _typesByName.find(type) != _typesByName.end();
     }
 
     const Variable *getVariableFromVarId(std::size_t varId) const {
@@ -895,6 +922,8 @@ private:
     const Scope *findNamespace(const Token * tok, const Scope * scope) const;
     Function *findFunctionInScope(const Token *func, const Scope *ns);
 
+    /** @brief add a type to typeList and to the definedTypes of the scope it is defined in */
+    Type *addType(const Type &type, Scope *scope);
 
     const Tokenizer *_tokenizer;
     const Settings *_settings;
@@ -905,6 +934,9 @@ private:
 
     /** list for missing types */
     std::list<Type> _blankTypes;
+
+    /** the types in typeList with a given name, in typeList order */
+    std::unordered_map<std::string, std::vector<const Type *> > _typesByName;
 };
 //---------------------------------------------------------------------------
 #endif // symboldatabaseH
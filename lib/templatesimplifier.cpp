@@ -22,9 +22,12 @@
 #include "tokenize.h"
 #include "errorlogger.h"
 #include "settings.h"
+#include "timer.h"
 #include <algorithm>
 #include <sstream>
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
 #include <stack>
 #include <vector>
@@ -712,22 +715,33 @@ int TemplateSimplifier::getTemplateNamePosition(const Token *tok)
 }
 
 
-void TemplateSimplifier::expandTemplate(
-    TokenList& tokenlist,
+namespace {
+    /** The "}" where the copying of a template part stops */
+    const Token *templatePartEnd(const Token *tok)
+    {
+        while (tok && tok->str() != "{") {
+            if (Token::Match(tok, "(|["))
+                tok = tok->link();
+            tok = tok->next();
+        }
+        return tok ? tok->link() : nullptr;
+    }
+}
+
+std::vector<const Token *> TemplateSimplifier::templateParts(
+    const TokenList& tokenlist,
     const Token *tok,
     const std::string &name,
-    std::vector<const Token *> &typeParametersInDeclaration,
-    const std::string &newName,
-    std::vector<const Token *> &typesUsedInTemplateInstantiation,
-    std::list<Token *> &templateInstantiations)
+    std::size_t numberOfParameters)
 {
+    std::vector<const Token *> parts;
     bool inTemplateDefinition=false;
     std::vector<const Token *> localTypeParametersInDeclaration;
     for (const Token *tok3 = tokenlist.front(); tok3; tok3 = tok3 ? tok3->next() : nullptr) {
         if (tok3->str()=="template") {
             if (tok3->next() && tok3->next()->str()=="<") {
                 TemplateParametersInDeclaration(tok3->tokAt(2), localTypeParametersInDeclaration);
-                if (localTypeParametersInDeclaration.size() != typeParametersInDeclaration.size())
+                if (localTypeParametersInDeclaration.size() != numberOfParameters)
                     inTemplateDefinition = false; // Partial specialization
                 else
                     inTemplateDefinition = true;
@@ -737,23 +751,49 @@ void TemplateSimplifier::expandTemplate(
         if (Token::Match(tok3, "{|(|["))
             tok3 = tok3->link();
 
+        // Start of template..
+        if (tok3 == tok)
+            parts.push_back(tok3);
+
+        // member function implemented outside class definition
+        else if (inTemplateDefinition &&
+                 TemplateSimplifier::instantiateMatch(tok3, name, numberOfParameters, ":: ~| %var% ("))
+            parts.push_back(tok3);
+
+        // not part of template.. go on to next token
+        else
+            continue;
+
+        tok3 = templatePartEnd(tok3);
+    }
+    return parts;
+}
+
+void TemplateSimplifier::expandTemplate(
+    TokenList& tokenlist,
+    const std::vector<const Token *> &templateParts,
+    const Token *tok,
+    const std::string &name,
+    std::vector<const Token *> &typeParametersInDeclaration,
+    const std::string &newName,
+    std::vector<const Token *> &typesUsedInTemplateInstantiation,
+    std::list<Token *> &templateInstantiations)
+{
+    for (auto part = templateParts.begin(); part != templateParts.end(); ++part) {
+        const Token *tok3 = *part;
+
         // Start of template..
         if (tok3 == tok) {
             tok3 = tok3->next();
         }
 
         // member function implemented outside class definition
-        else if (inTemplateDefinition &&
-                 TemplateSimplifier::instantiateMatch(tok3, name, typeParametersInDeclaration.size(), ":: ~| %var% (")) {
+        else {
             tokenlist.addtoken(newName, tok3->linenr(), tok3->fileIndex());
             while (tok3 && tok3->str() != "::")
                 tok3 = tok3->next();
         }
 
-        // not part of template.. go on to next token
-        else
-            continue;
-
         int indentlevel = 0;
         std::stack<Token *> brackets; // holds "(", "[" and "{" tokens
 
@@ -838,6 +878,212 @@ void TemplateSimplifier::expandTemplate(
     }
 }
 
+namespace {
+    /**
+     * Text of the tokens in the parts of a template, with everything that
+     * is copied into an expansion. The tokens are added to partTokens so
+     * it can be seen when the template is changed.
+     */
+    std::string templateText(const TokenList &tokenlist,
+                             const std::vector<const Token *> &templateParts,
+                             const std::vector<const Token *> &typeParametersInDeclaration,
+                             std::set<const Token *> &partTokens)
+    {
+        std::ostringstream ostr;
+        for (auto it = typeParametersInDeclaration.begin(); it != typeParametersInDeclaration.end(); ++it)
+            ostr << (*it)->str() << ' ';
+        for (auto part = templateParts.begin(); part != templateParts.end(); ++part) {
+            const Token *end = templatePartEnd(*part);
+            // a ";" after the body is copied too
+            if (Token::simpleMatch(end, "} ;"))
+                end = end->next();
+            unsigned int fileIndex = ~0U;
+            ostr << '\n';
+            for (const Token *tok = *part; tok; tok = tok->next()) {
+                partTokens.insert(tok);
+                if (tok->fileIndex() != fileIndex) {
+                    fileIndex = tok->fileIndex();
+                    ostr << '\n' << tokenlist.file(tok) << '\n';
+                }
+                ostr << tok->str() << ' ' << tok->originalName() << ' ' << tok->flags() << ' ' << tok->linenr() << ' ';
+                if (tok == end)
+                    break;
+            }
+        }
+        return ostr.str();
+    }
+
+    /** Template arguments, as they are copied into the expansion */
+    std::string templateArguments(const std::string &newName, const std::vector<const Token *> &typesUsedInTemplateInstantiation)
+    {
+        std::ostringstream ostr;
+        ostr << newName;
+        for (auto it = typesUsedInTemplateInstantiation.begin(); it != typesUsedInTemplateInstantiation.end(); ++it) {
+            ostr << '\n';
+            unsigned int typeindentlevel = 0;
+            for (const Token *typetok = *it;
+                 typetok && (typeindentlevel>0 || !Token::Match(typetok, ",|>|>>"));
+                 typetok = typetok->next()) {
+                if (Token::Match(typetok, "%var% <") && TemplateSimplifier::templateParameters(typetok->next()) > 0)
+                    ++typeindentlevel;
+                else if (typeindentlevel > 0 && typetok->str() == ">")
+                    --typeindentlevel;
+                else if (typeindentlevel > 0 && typetok->str() == ">>") {
+                    if (typeindentlevel == 1)
+                        break;
+                    typeindentlevel -= 2;
+                }
+                ostr << typetok->str() << ' ' << typetok->originalName() << ' ' << typetok->flags() << ' ';
+            }
+        }
+        return ostr.str();
+    }
+
+    /** Save the tokens after 'last' as a cached expansion */
+    std::shared_ptr<const TemplateExpansionCache::Expansion> saveExpansion(const TokenList &tokenlist,
+            const Token *last,
+            const std::set<const Token *> &instantiations,
+            const std::shared_ptr<const std::string> &text,
+            std::clock_t clocks)
+    {
+        std::shared_ptr<TemplateExpansionCache::Expansion> expansion(new TemplateExpansionCache::Expansion);
+        expansion->templateText = text;
+        expansion->clocks = clocks;
+        std::map<const Token *, int> index;
+        std::map<unsigned int, unsigned int> files;
+        for (const Token *tok = last ? last->next() : tokenlist.front(); tok; tok = tok->next()) {
+            index[tok] = (int)expansion->tokens.size();
+            TemplateExpansionCache::ExpandedToken expanded;
+            expanded.str = tok->str();
+            expanded.originalName = tok->originalName();
+            const auto file = files.find(tok->fileIndex());
+            if (file == files.end()) {
+                expanded.file = (unsigned int)expansion->files.size();
+                files[tok->fileIndex()] = expanded.file;
+                expansion->files.push_back(tokenlist.file(tok));
+            } else
+                expanded.file = file->second;
+            expanded.flags = tok->flags();
+            expanded.linenr = tok->linenr();
+            expanded.link = 0;
+            expanded.instantiation = instantiations.find(tok) != instantiations.end();
+            if (tok->link()) {
+                const auto link = index.find(tok->link());
+                if (link != index.end()) {
+                    expanded.link = link->second - index[tok];
+                    expansion->tokens[link->second].link = -expanded.link;
+                }
+            }
+            expansion->tokens.push_back(expanded);
+        }
+        return expansion;
+    }
+
+    /** Append the tokens of a cached expansion */
+    void replayExpansion(TokenList &tokenlist,
+                         const TemplateExpansionCache::Expansion &expansion,
+                         std::list<Token *> &templateInstantiations)
+    {
+        std::vector<unsigned int> files;
+        for (auto it = expansion.files.begin(); it != expansion.files.end(); ++it)
+            files.push_back(tokenlist.appendFileIfNew(*it));
+
+        std::vector<Token *> added;
+        added.reserve(expansion.tokens.size());
+        for (auto it = expansion.tokens.begin(); it != expansion.tokens.end(); ++it) {
+            tokenlist.addtoken(it->str, it->linenr, files[it->file]);
+            Token * const tok = tokenlist.back();
+            if (!it->originalName.empty())
+                tok->originalName(it->originalName);
+            tok->flags(it->flags);
+            if (it->link < 0)
+                Token::createMutualLinks(added[added.size() + it->link], tok);
+            if (it->instantiation)
+                templateInstantiations.push_back(tok);
+            added.push_back(tok);
+        }
+    }
+}
+
+TemplateExpansionCache::TemplateExpansionCache(std::size_t maxTokens)
+    : _tokens(0)
+    , _maxTokens(maxTokens)
+{
+}
+
+std::shared_ptr<const TemplateExpansionCache::Expansion> TemplateExpansionCache::get(const Key &key, const std::string &templateText)
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    auto it = _entries.find(key);
+    if (it == _entries.end() || *it->second.expansion->templateText != templateText)
+        return std::shared_ptr<const Expansion>();
+    _order.splice(_order.begin(), _order, it->second.position);
+    return it->second.expansion;
+}
+
+void TemplateExpansionCache::put(const Key &key, const std::shared_ptr<const Expansion> &expansion)
+{
+    const std::size_t tokens = expansion->tokens.size();
+    if (tokens > _maxTokens)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sync);
+    if (_entries.find(key) != _entries.end())
+        return;
+
+    makeRoom(tokens);
+
+    _order.push_front(key);
+    Entry &entry = _entries[key];
+    entry.expansion = expansion;
+    entry.position = _order.begin();
+    _tokens += tokens;
+}
+
+std::size_t TemplateExpansionCache::size()
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    return _entries.size();
+}
+
+std::size_t TemplateExpansionCache::tokens()
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    return _tokens;
+}
+
+void TemplateExpansionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    _entries.clear();
+    _order.clear();
+    _tokens = 0;
+}
+
+void TemplateExpansionCache::setMaxTokens(std::size_t maxTokens)
+{
+    std::lock_guard<std::mutex> lock(_sync);
+    _maxTokens = maxTokens;
+    makeRoom(0);
+}
+
+void TemplateExpansionCache::makeRoom(std::size_t tokens)
+{
+    while (!_order.empty() && _tokens + tokens > _maxTokens) {
+        auto it = _entries.find(_order.back());
+        _tokens -= it->second.expansion->tokens.size();
+        _entries.erase(it);
+        _order.pop_back();
+    }
+}
+
+TemplateExpansionCache &TemplateExpansionCache::instance()
+{
+    static TemplateExpansionCache cache;
+    return cache;
+}
+
+
 static bool isLowerThanOr(const Token* lower)
 {
     return lower->isAssignmentOp() || Token::Match(lower, "}|;|(|[|]|)|,|?|:|%oror%|&&|return|throw|case");
@@ -910,6 +1156,14 @@ static std::string ShiftUInt(const char cop, const Token* left, const Token* rig
     return "";
 }
 
+/** Is the result of "num1 / num2" a whole number? */
+static bool isWholeNumberDivision(const std::string &num1, const std::string &num2)
+{
+    const MathLib::value v1(num1);
+    const MathLib::value v2(num2);
+    return num1 == MathLib::value::calc('*', v2, MathLib::value::calc('/', v1, v2)).str();
+}
+
 bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
 {
     bool ret = false;
@@ -917,7 +1171,7 @@ bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
     while (tok->tokAt(4) && tok->next()->isNumber() && tok->tokAt(3)->isNumber()) { // %any% %num% %any% %num% %any%
         const Token* op = tok->tokAt(2);
         const Token* after = tok->tokAt(4);
-        if (Token::Match(tok, "* %num% /") && (tok->strAt(3) != "0") && tok->next()->str() == MathLib::multiply(tok->strAt(3), MathLib::divide(tok->next()->str(), tok->strAt(3)))) {
+        if (Token::Match(tok, "* %num% /") && (tok->strAt(3) != "0") && isWholeNumberDivision(tok->next()->str(), tok->strAt(3))) {
             // Division where result is a whole number
         } else if (!((op->str() == "*" && (isLowerThanMulDiv(tok) || tok->str() == "*") && isLowerEqualThanMulDiv(after)) || // associative
                      (Token::Match(op, "[/%]") && isLowerThanMulDiv(tok) && isLowerEqualThanMulDiv(after)) || // NOT associative
@@ -956,7 +1210,7 @@ bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
             tok->str(MathLib::subtract(tok->str(), tok->strAt(2)));
         else {
             try {
-                tok->str(MathLib::calculate(tok->str(), tok->strAt(2), op->str()[0]));
+                tok->str(MathLib::value::calc(op->str()[0], MathLib::value(tok->str()), MathLib::value(tok->strAt(2))).str());
             } catch (InternalError &e) {
                 e.token = tok;
                 throw;
@@ -1121,12 +1375,13 @@ bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
             }
 
             if (Token::Match(tok, "%num% %comp% %num%") &&
-                MathLib::isInt(tok->str()) &&
-                MathLib::isInt(tok->strAt(2))) {
-                if (Token::Match(tok->previous(), "(|&&|%oror%") && Token::Match(tok->tokAt(3), ")|&&|%oror%|?")) {
-                    const MathLib::bigint op1(MathLib::toLongNumber(tok->str()));
+                Token::Match(tok->previous(), "(|&&|%oror%") && Token::Match(tok->tokAt(3), ")|&&|%oror%|?")) {
+                const MathLib::value v1(tok->str());
+                const MathLib::value v2(tok->strAt(2));
+                if (v1.isInt() && v2.isInt()) {
+                    const MathLib::bigint op1(v1.getIntValue());
                     const std::string &cmp(tok->next()->str());
-                    const MathLib::bigint op2(MathLib::toLongNumber(tok->strAt(2)));
+                    const MathLib::bigint op2(v2.getIntValue());
 
                     std::string result;
 
@@ -1152,7 +1407,7 @@ bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
         }
         // Division where result is a whole number
         else if (Token::Match(tok->previous(), "* %num% /") &&
-                 tok->str() == MathLib::multiply(tok->strAt(2), MathLib::divide(tok->str(), tok->strAt(2)))) {
+                 isWholeNumberDivision(tok->str(), tok->strAt(2))) {
             tok->deleteNext(2);
         }
 
@@ -1181,7 +1436,9 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
     const Settings *_settings,
     const Token *tok,
     std::list<Token *> &templateInstantiations,
-    std::set<std::string> &expandedtemplates)
+    std::set<std::string> &expandedtemplates,
+    TimerResultsIntf *timerResults,
+    TemplateExpansionCache *cache)
 {
     // this variable is not used at the moment. The intention was to
     // allow continuous instantiations until all templates has been expanded
@@ -1211,6 +1468,21 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
     const bool isfunc(tok->strAt(namepos + 1) == "(");
 
+    // parts of the template that are copied, located at the first expansion
+    std::vector<const Token *> parts;
+    bool locatedParts = false;
+
+    // text of the parts and its hash, they are made again when the parts are changed
+    std::shared_ptr<const std::string> text;
+    std::size_t hash = 0;
+    bool hashed = false;
+    std::set<const Token *> partTokens;
+
+    if (!cache)
+        cache = &TemplateExpansionCache::instance();
+
+    const bool showtime = timerResults && _settings->_showtime != SHOWTIME_NONE;
+
     // locate template usage..
     std::string::size_type amountOftemplateInstantiations = templateInstantiations.size();
     unsigned int recursiveCount = 0;
@@ -1220,7 +1492,8 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
     for (auto iter2 = templateInstantiations.begin(); iter2 != templateInstantiations.end(); ++iter2) {
         if (amountOftemplateInstantiations != templateInstantiations.size()) {
             amountOftemplateInstantiations = templateInstantiations.size();
-            simplifyCalculations(tokenlist.front());
+            if (simplifyCalculations(tokenlist.front()))
+                hashed = false;
             ++recursiveCount;
             if (recursiveCount > 100) {
                 // bail out..
@@ -1298,7 +1571,41 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
         if (expandedtemplates.find(newName) == expandedtemplates.end()) {
             expandedtemplates.insert(newName);
-            TemplateSimplifier::expandTemplate(tokenlist, tok,name,typeParametersInDeclaration,newName,typesUsedInTemplateInstantiation,templateInstantiations);
+            const std::clock_t start = std::clock();
+            if (!locatedParts) {
+                parts = TemplateSimplifier::templateParts(tokenlist, tok, name, typeParametersInDeclaration.size());
+                locatedParts = true;
+            }
+            if (!hashed) {
+                partTokens.clear();
+                text.reset(new std::string(templateText(tokenlist, parts, typeParametersInDeclaration, partTokens)));
+                hash = std::hash<std::string>()(*text);
+                hashed = true;
+            }
+            const TemplateExpansionCache::Key key(hash, templateArguments(newName, typesUsedInTemplateInstantiation));
+            const std::shared_ptr<const TemplateExpansionCache::Expansion> cached(cache->get(key, *text));
+            if (cached) {
+                replayExpansion(tokenlist, *cached, templateInstantiations);
+                if (showtime) {
+                    // report the time it would have taken to expand the template again
+                    const std::clock_t clocks = std::clock() - start;
+                    timerResults->AddResults("TemplateSimplifier::expandTemplate (saved by cache)",
+                                             cached->clocks > clocks ? cached->clocks - clocks : 0);
+                }
+            } else {
+                const Token * const last = tokenlist.back();
+                const std::size_t numberOfInstantiations = templateInstantiations.size();
+                TemplateSimplifier::expandTemplate(tokenlist, parts, tok,name,typeParametersInDeclaration,newName,typesUsedInTemplateInstantiation,templateInstantiations);
+                const std::clock_t clocks = std::clock() - start;
+
+                auto newInstantiation = templateInstantiations.begin();
+                std::advance(newInstantiation, numberOfInstantiations);
+                const std::set<const Token *> instantiations(newInstantiation, templateInstantiations.end());
+                std::shared_ptr<const TemplateExpansionCache::Expansion> expansion(saveExpansion(tokenlist, last, instantiations, text, clocks));
+                cache->put(key, expansion);
+                if (showtime)
+                    timerResults->AddResults("TemplateSimplifier::expandTemplate", clocks);
+            }
             instantiated = true;
         }
 
@@ -1339,8 +1646,14 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
                 // Foo < int >  =>  Foo<int>
                 if (tok5 && tok5->str() == ">" && typeCountInInstantiation == typesUsedInTemplateInstantiation.size()) {
                     tok4->str(newName);
-                    for (Token *tok6 = tok4->next(); tok6 != tok5; tok6 = tok6->next()) {
-                        if (tok6->isName())
+                    for (Token *tok6 = tok4; tok6 != tok5; tok6 = tok6->next()) {
+                        if (hashed && partTokens.find(tok6) != partTokens.end())
+                            hashed = false;
+                        // a member implemented outside the class is no longer a part of the template
+                        const auto part = std::find(parts.begin(), parts.end(), tok6);
+                        if (part != parts.end())
+                            parts.erase(part);
+                        if (tok6 != tok4 && tok6->isName())
                             templateInstantiations.remove(tok6);
                     }
                     removeTokens.push_back(std::pair<Token*,Token*>(tok4, tok5->next()));
@@ -1366,7 +1679,9 @@ void TemplateSimplifier::simplifyTemplates(
     TokenList& tokenlist,
     ErrorLogger* errorlogger,
     const Settings *_settings,
-    bool &_codeWithTemplates
+    bool &_codeWithTemplates,
+    TimerResultsIntf *timerResults,
+    TemplateExpansionCache *cache
 )
 {
 
@@ -1413,7 +1728,9 @@ void TemplateSimplifier::simplifyTemplates(
                                 _settings,
                                 *iter1,
                                 templateInstantiations,
-                                expandedtemplates);
+                                expandedtemplates,
+                                timerResults,
+                                cache);
             if (instantiated)
                 templates2.push_back(*iter1);
         }
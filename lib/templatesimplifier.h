@@ -22,9 +22,14 @@
 #define templatesimplifierH
 //---------------------------------------------------------------------------
 
+#include <ctime>
 #include <set>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 #include "config.h"
 
@@ -32,11 +37,100 @@ class Token;
 class TokenList;
 class ErrorLogger;
 class Settings;
+class TimerResultsIntf;
 
 
 /// @addtogroup Core
 /// @{
 
+/**
+ * @brief In-memory cache of template expansions.
+ *
+ * An expansion only depends on the tokens of the template (the
+ * declaration and the members that are implemented outside the class)
+ * and on the template arguments. The expanded tokens are kept so an
+ * instantiation is only copied once, also when the template is seen
+ * again in another configuration or in another file that includes it.
+ * The cache holds at most a given number of tokens; the least recently
+ * used expansions are removed first. It can be shared by threads.
+ * The key has a hash of the template tokens, the tokens themselves are
+ * compared when an expansion is found so a hash collision is a miss.
+ */
+class CPPCHECKLIB TemplateExpansionCache {
+public:
+    /** @brief A token of an expansion */
+    class ExpandedToken {
+    public:
+        std::string str;
+        std::string originalName;
+        unsigned int file;  ///< index in Expansion::files
+        unsigned int flags;
+        unsigned int linenr;
+        int link;           ///< offset to the linked token, 0 if there is no link
+        bool instantiation; ///< is this a template usage that should be simplified?
+    };
+
+    /** @brief Expanded tokens of one instantiation */
+    class Expansion {
+    public:
+        Expansion() : clocks(0) {}
+
+        std::vector<ExpandedToken> tokens;
+        std::vector<std::string> files;
+        std::shared_ptr<const std::string> templateText; ///< the template tokens the expansion was made from
+        std::clock_t clocks; ///< time it took to expand the template
+    };
+
+    /** @brief Hash of the template tokens, and the template arguments */
+    typedef std::pair<std::size_t, std::string> Key;
+
+    /** @param maxTokens the most tokens that are kept */
+    explicit TemplateExpansionCache(std::size_t maxTokens = 500000);
+
+    /** @brief Get expansion of the given template text, null if there is none */
+    std::shared_ptr<const Expansion> get(const Key &key, const std::string &templateText);
+
+    /** @brief Store expansion */
+    void put(const Key &key, const std::shared_ptr<const Expansion> &expansion);
+
+    /** @brief Number of entries */
+    std::size_t size();
+
+    /** @brief Number of tokens in all entries */
+    std::size_t tokens();
+
+    /** @brief Remove all entries */
+    void clear();
+
+    /** @brief Change the most tokens that are kept, entries are removed if needed */
+    void setMaxTokens(std::size_t maxTokens);
+
+    /** @brief The cache that is used by default, it is shared by all threads */
+    static TemplateExpansionCache &instance();
+
+private:
+    typedef std::list<Key> Order;
+
+    class Entry {
+    public:
+        std::shared_ptr<const Expansion> expansion;
+        Order::iterator position;  ///< position in _order
+    };
+
+    std::map<Key, Entry> _entries;
+
+    /** keys, the most recently used first */
+    Order _order;
+
+    /** remove the least recently used entries until there is room for the given tokens */
+    void makeRoom(std::size_t tokens);
+
+    std::size_t _tokens;
+    std::size_t _maxTokens;
+
+    std::mutex _sync;
+};
+
 /** @brief Simplify templates from the preprocessed and partially simplified code. */
 class CPPCHECKLIB TemplateSimplifier {
     TemplateSimplifier();
@@ -108,8 +202,28 @@ public:
      */
     static int getTemplateNamePosition(const Token *tok);
 
+    /**
+     * Locate the parts of a template that are copied when it is expanded.
+     * @param tokenlist token list
+     * @param tok the ">" token at the end of the template parameters
+     * @param name name of template
+     * @param numberOfParameters number of template parameters
+     * @return the template declaration (tok) and the names of the members
+     * that are implemented outside the class definition
+     */
+    static std::vector<const Token *> templateParts(
+        const TokenList& tokenlist,
+        const Token *tok,
+        const std::string &name,
+        std::size_t numberOfParameters);
+
+    /**
+     * Copy a template and replace the template parameters. The parts of the
+     * template are located with templateParts().
+     */
     static void expandTemplate(
         TokenList& tokenlist,
+        const std::vector<const Token *> &templateParts,
         const Token *tok,
         const std::string &name,
         std::vector<const Token *> &typeParametersInDeclaration,
@@ -139,6 +253,8 @@ public:
      * @param tok token where the template declaration begins
      * @param templateInstantiations a list of template usages (not necessarily just for this template)
      * @param expandedtemplates all templates that has been expanded so far. The full names are stored.
+     * @param timerResults expansion counts and times are added here for --showtime
+     * @param cache expansions are reused from here, null => TemplateExpansionCache::instance()
      * @return true if the template was instantiated
      */
     static bool simplifyTemplateInstantiations(
@@ -147,7 +263,9 @@ public:
         const Settings *_settings,
         const Token *tok,
         std::list<Token *> &templateInstantiations,
-        std::set<std::string> &expandedtemplates);
+        std::set<std::string> &expandedtemplates,
+        TimerResultsIntf *timerResults = nullptr,
+        TemplateExpansionCache *cache = nullptr);
 
     /**
      * Simplify templates
@@ -155,12 +273,16 @@ public:
      * @param errorlogger error logger
      * @param _settings settings
      * @param _codeWithTemplates output parameter that is set if code contains templates
+     * @param timerResults expansion counts and times are added here for --showtime
+     * @param cache expansions are reused from here, null => TemplateExpansionCache::instance()
      */
     static void simplifyTemplates(
         TokenList& tokenlist,
         ErrorLogger* errorlogger,
         const Settings *_settings,
-        bool &_codeWithTemplates);
+        bool &_codeWithTemplates,
+        TimerResultsIntf *timerResults = nullptr,
+        TemplateExpansionCache *cache = nullptr);
 
     /**
      * Simplify constant calculations such as "1+2" => "3"
@@ -23,7 +23,6 @@
 /*
     TODO:
     - rename "file" to "single"
-    - synchronise map access in multithreaded mode or disable timing
     - add unit tests
         - for --showtime (needs input file)
         - for Timer* classes
@@ -39,7 +38,7 @@ namespace {
 
 void TimerResults::ShowResults(SHOWTIME_MODES mode) const
 {
-    if (mode == SHOWTIME_NONE)
+    if (mode == SHOWTIME_NONE || _results.empty())
         return;
 
     std::cout << std::endl;
@@ -69,6 +68,15 @@ void TimerResults::AddResults(const std::string& str, std::clock_t clocks)
     _results[str]._numberOfResults++;
 }
 
+void TimerResults::MergeResults(const TimerResults &other)
+{
+    for (auto it = other._results.begin(); it != other._results.end(); ++it) {
+        TimerResultsData &data = _results[it->first];
+        data._clocks += it->second._clocks;
+        data._numberOfResults += it->second._numberOfResults;
+    }
+}
+
 Timer::Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults)
     : _str(str)
     , _timerResults(timerResults)
@@ -62,6 +62,9 @@ public:
     void ShowResults(SHOWTIME_MODES mode) const;
     virtual void AddResults(const std::string& str, std::clock_t clocks);
 
+    /** @brief Add the results of another TimerResults (from another thread) */
+    void MergeResults(const TimerResults &other);
+
 private:
     std::map<std::string, struct TimerResultsData> _results;
 };
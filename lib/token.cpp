@@ -17,6 +17,7 @@
  */
 
 #include "token.h"
+#include "tokenarena.h"
 #include "errorlogger.h"
 #include "check.h"
 #include "settings.h"
@@ -35,6 +36,9 @@
 
 Token::Token(Token **t) :
     tokensBack(t),
+    _arena(nullptr),
+    _strId(TokenStrings::None),
+    _index(0),
     _next(0),
     _previous(0),
     _link(0),
@@ -58,8 +62,31 @@ Token::~Token()
     delete _originalName;
 }
 
+Token *Token::create(Token **tokensBack, TokenArena *arena)
+{
+    if (!arena)
+        return new Token(tokensBack);
+
+    Token *tok = new (arena->allocate()) Token(tokensBack);
+    tok->_arena = arena;
+    return tok;
+}
+
+void Token::destroy(Token *tok)
+{
+    TokenArena * const arena = tok->_arena;
+    if (arena) {
+        tok->~Token();
+        arena->deallocate(tok);
+    } else {
+        delete tok;
+    }
+}
+
 void Token::update_property_info()
 {
+    _strId = TokenStrings::id(_str);
+
     if (!_str.empty()) {
         if (_str == "true" || _str == "false")
             _type = eBoolean;
@@ -156,7 +183,7 @@ void Token::deleteNext(unsigned long index)
     while (_next && index) {
         Token *n = _next;
         _next = n->next();
-        delete n;
+        destroy(n);
         --index;
     }
 
@@ -172,6 +199,7 @@ void Token::swapWithNext()
         Token temp(0);
 
         temp._str = _next->_str;
+        temp._strId = _next->_strId;
         temp._type = _next->_type;
         temp._flags = _next->_flags;
         temp._varId = _next->_varId;
@@ -180,10 +208,10 @@ void Token::swapWithNext()
         temp._scope = _next->_scope;
         temp._function = _next->_function;
         temp._originalName = _next->_originalName;
-        temp.values = _next->values;
         temp._progressValue = _next->_progressValue;
 
         _next->_str = _str;
+        _next->_strId = _strId;
         _next->_type = _type;
         _next->_flags = _flags;
         _next->_varId = _varId;
@@ -192,10 +220,10 @@ void Token::swapWithNext()
         _next->_scope = _scope;
         _next->_function = _function;
         _next->_originalName = _originalName;
-        _next->values = values;
         _next->_progressValue = _progressValue;
 
         _str = temp._str;
+        _strId = temp._strId;
         _type = temp._type;
         _flags = temp._flags;
         _varId = temp._varId;
@@ -204,7 +232,7 @@ void Token::swapWithNext()
         _scope = temp._scope;
         _function = temp._function;
         _originalName = temp._originalName;
-        values = temp.values;
+        values.swap(_next->values);
         _progressValue = temp._progressValue;
     }
 }
@@ -213,6 +241,7 @@ void Token::deleteThis()
 {
     if (_next) { // Copy next to this and delete next
         _str = _next->_str;
+        _strId = _next->_strId;
         _type = _next->_type;
         _flags = _next->_flags;
         _varId = _next->_varId;
@@ -226,13 +255,14 @@ void Token::deleteThis()
             _originalName = _next->_originalName;
             _next->_originalName = nullptr;
         }
-        values = _next->values;
+        values.swap(_next->values);
         if (_link)
             _link->link(this);
 
         deleteNext();
     } else if (_previous && _previous->_previous) { // Copy previous to this and delete previous
         _str = _previous->_str;
+        _strId = _previous->_strId;
         _type = _previous->_type;
         _flags = _previous->_flags;
         _varId = _previous->_varId;
@@ -246,7 +276,7 @@ void Token::deleteThis()
             _originalName = _previous->_originalName;
             _previous->_originalName = nullptr;
         }
-        values = _previous->values;
+        values.swap(_previous->values);
         if (_link)
             _link->link(this);
 
@@ -254,7 +284,7 @@ void Token::deleteThis()
         _previous = _previous->_previous;
         _previous->_next = this;
 
-        delete toDelete;
+        destroy(toDelete);
     } else {
         // We are the last token in the list, we can't delete
         // ourselves, so just make us empty
@@ -292,7 +322,7 @@ void Token::replace(Token *replaceThis, Token *start, Token *end)
         tok->_progressValue = replaceThis->_progressValue;
 
     // Delete old token, which is replaced
-    delete replaceThis;
+    destroy(replaceThis);
 }
 
 const Token *Token::tokAt(int index) const
@@ -869,7 +899,7 @@ void Token::insertToken(const std::string &tokenStr, bool prepend)
     if (_str.empty())
         newToken = this;
     else
-        newToken = new Token(tokensBack);
+        newToken = create(tokensBack, _arena);
     newToken->str(tokenStr);
     newToken->_linenr = _linenr;
     newToken->_fileIndex = _fileIndex;
@@ -908,7 +938,7 @@ void Token::insertToken(const std::string &tokenStr, const std::string &original
     if (_str.empty())
         newToken = this;
     else
-        newToken = new Token(tokensBack);
+        newToken = create(tokensBack, _arena);
     newToken->str(tokenStr);
     if (!originalNameStr.empty())
         newToken->originalName(originalNameStr);
@@ -1345,7 +1375,7 @@ const Token *Token::getValueTokenMinStrSize() const
 {
     const Token *ret = nullptr;
     std::size_t minsize = ~0U;
-    std::list<ValueFlow::Value>::const_iterator it;
+    ValueFlow::ValueList::const_iterator it;
     for (it = values.begin(); it != values.end(); ++it) {
         if (it->tokvalue && it->tokvalue->type() == Token::eString) {
             std::size_t size = getStrSize(it->tokvalue);
@@ -1362,7 +1392,7 @@ const Token *Token::getValueTokenMaxStrLength() const
 {
     const Token *ret = nullptr;
     std::size_t maxlength = 0U;
-    std::list<ValueFlow::Value>::const_iterator it;
+    ValueFlow::ValueList::const_iterator it;
     for (it = values.begin(); it != values.end(); ++it) {
         if (it->tokvalue && it->tokvalue->type() == Token::eString) {
             std::size_t length = getStrLength(it->tokvalue);
@@ -1386,7 +1416,7 @@ const Token *Token::getValueTokenDeadPointer() const
 {
     const Scope * const functionscope = getfunctionscope(this->scope());
 
-    std::list<ValueFlow::Value>::const_iterator it;
+    ValueFlow::ValueList::const_iterator it;
     for (it = values.begin(); it != values.end(); ++it) {
         // Is this a pointer alias?
         if (!it->tokvalue || it->tokvalue->str() != "&")
@@ -1420,3 +1450,10 @@ void Token::assignProgressValues(Token *tok)
     for (Token *tok2 = tok; tok2; tok2 = tok2->next())
         tok2->_progressValue = count++ * 100 / total_count;
 }
+
+void Token::assignIndexes(Token *tok)
+{
+    unsigned int index = 0;
+    for (Token *tok2 = tok; tok2; tok2 = tok2->next())
+        tok2->_index = index++;
+}
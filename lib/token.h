@@ -28,11 +28,13 @@
 #include "config.h"
 #include "valueflow.h"
 #include "mathlib.h"
+#include "tokenstrings.h"
 
 class Scope;
 class Function;
 class Variable;
 class Settings;
+class TokenArena;
 
 /// @addtogroup Core
 /// @{
@@ -51,6 +53,9 @@ class CPPCHECKLIB Token {
 private:
     Token **tokensBack;
 
+    /** arena the token is allocated in, null if it is allocated with new */
+    TokenArena *_arena;
+
     // Not implemented..
     Token();
     Token(const Token &);
@@ -69,6 +74,22 @@ public:
     explicit Token(Token **tokensBack);
     ~Token();
 
+    /**
+     * @brief Create a token.
+     * Tokens that are inserted after it are allocated in the same arena.
+     * @param tokensBack pointer to the last token of the list, can be null
+     * @param arena the arena to allocate the token in. If it is null the token is allocated with new.
+     */
+    static Token *create(Token **tokensBack, TokenArena *arena);
+
+    /** @brief Destroy a token that was allocated by create() or new */
+    static void destroy(Token *tok);
+
+    /** @brief The arena the token is allocated in, null if it is allocated with new */
+    TokenArena *arena() const {
+        return _arena;
+    }
+
     template<typename T>
     void str(T&& s) {
         _str = s;
@@ -87,6 +108,14 @@ public:
         return _str;
     }
 
+    /**
+     * @brief Fixed id of the token string.
+     * Keywords, operators and punctuators have an id, other strings have TokenStrings::None.
+     */
+    TokenStrings::Id strId() const {
+        return _strId;
+    }
+
     /**
      * Unlink and delete the next 'index' tokens.
      */
@@ -635,6 +664,17 @@ public:
     /** Calculate progress values for all tokens */
     static void assignProgressValues(Token *tok);
 
+    /** Get position in token list, see assignIndexes() */
+    unsigned int index() const {
+        return _index;
+    }
+
+    /**
+     * Number the tokens from tok to the end of the token list. The numbers
+     * are valid until tokens are added, removed or moved.
+     */
+    static void assignIndexes(Token *tok);
+
     /**
      * @return the first token of the next argument. Does only work on argument
      * lists. Requires that Tokenizer::createLinks2() has been called before.
@@ -676,7 +716,7 @@ public:
     }
 
     /** Values of token */
-    std::list<ValueFlow::Value> values;
+    ValueFlow::ValueList values;
 
     const ValueFlow::Value * getValue(const MathLib::bigint val) const {
         for (auto it = values.begin(); it != values.end(); ++it) {
@@ -738,6 +778,12 @@ private:
 
     std::string _str;
 
+    /** fixed id of _str, updated by update_property_info() */
+    TokenStrings::Id _strId;
+
+    /** position in token list, set by assignIndexes() */
+    unsigned int _index;
+
     Token *_next;
     Token *_previous;
     Token *_link;
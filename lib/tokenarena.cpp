@@ -0,0 +1,69 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tokenarena.h"
+
+#include <new>
+
+// Blocks come from operator new, which returns memory that is suitably
+// aligned for any object. Slots are multiples of this alignment.
+static const std::size_t SlotAlignment = 2U * sizeof(void *);
+
+TokenArena::TokenArena(std::size_t slotSize)
+    : _free(nullptr),
+      _slotSize((slotSize + SlotAlignment - 1U) / SlotAlignment * SlotAlignment),
+      _used(SlotsPerBlock)
+{
+}
+
+TokenArena::~TokenArena()
+{
+    release();
+}
+
+void *TokenArena::allocate()
+{
+    if (_free) {
+        FreeSlot *slot = _free;
+        _free = slot->next;
+        return slot;
+    }
+
+    if (_used == SlotsPerBlock) {
+        _blocks.push_back(static_cast<char *>(::operator new(_slotSize * SlotsPerBlock)));
+        _used = 0;
+    }
+
+    return _blocks.back() + _slotSize * _used++;
+}
+
+void TokenArena::deallocate(void *p)
+{
+    FreeSlot *slot = static_cast<FreeSlot *>(p);
+    slot->next = _free;
+    _free = slot;
+}
+
+void TokenArena::release()
+{
+    for (auto it = _blocks.begin(); it != _blocks.end(); ++it)
+        ::operator delete(*it);
+    _blocks.clear();
+    _free = nullptr;
+    _used = SlotsPerBlock;
+}
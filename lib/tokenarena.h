@@ -0,0 +1,85 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef tokenarenaH
+#define tokenarenaH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstddef>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Slab allocator for the tokens of a TokenList.
+ *
+ * Memory is allocated in blocks of many slots of the same size. Freed
+ * slots are kept in a free list and reused. All blocks are released at
+ * once by release() or when the arena is destroyed. The arena only
+ * handles memory, objects must be destroyed before their slot is freed.
+ */
+class CPPCHECKLIB TokenArena {
+public:
+    explicit TokenArena(std::size_t slotSize);
+    ~TokenArena();
+
+    /** @brief Allocate memory for one object */
+    void *allocate();
+
+    /** @brief Put a slot in the free list */
+    void deallocate(void *p);
+
+    /** @brief Release all blocks. Slots that are in use become invalid. */
+    void release();
+
+    /** @brief Number of allocated blocks */
+    std::size_t blocks() const {
+        return _blocks.size();
+    }
+
+    /** @brief Number of slots in each block */
+    static const std::size_t SlotsPerBlock = 512U;
+
+private:
+    /** a free slot holds the pointer to the next free slot */
+    struct FreeSlot {
+        FreeSlot *next;
+    };
+
+    /** Disable copy constructor and assignment operator, no implementation */
+    TokenArena(const TokenArena &);
+    TokenArena &operator=(const TokenArena &);
+
+    std::vector<char *> _blocks;
+
+    FreeSlot *_free;
+
+    /** slot size, rounded up so every slot is aligned */
+    const std::size_t _slotSize;
+
+    /** number of slots in the last block that have been handed out */
+    std::size_t _used;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // tokenarenaH
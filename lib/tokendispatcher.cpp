@@ -0,0 +1,60 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tokendispatcher.h"
+#include "check.h"
+#include "symboldatabase.h"
+#include "token.h"
+
+TokenDispatcher::~TokenDispatcher()
+{
+    for (auto it = _checks.begin(); it != _checks.end(); ++it)
+        delete *it;
+}
+
+void TokenDispatcher::addTrigger(const std::string &name, const Callback &callback)
+{
+    _triggers[name].push_back(callback);
+}
+
+void TokenDispatcher::addCheck(Check *check)
+{
+    _checks.push_back(check);
+}
+
+void TokenDispatcher::dispatch(const SymbolDatabase *symbolDatabase) const
+{
+    if (_triggers.empty())
+        return;
+
+    const std::size_t functions = symbolDatabase->functionScopes.size();
+    for (std::size_t i = 0; i < functions; ++i) {
+        const Scope * scope = symbolDatabase->functionScopes[i];
+        for (const Token *tok = scope->classStart; tok != scope->classEnd; tok = tok->next()) {
+            if (!tok->isName())
+                continue;
+
+            auto it = _triggers.find(tok->str());
+            if (it == _triggers.end())
+                continue;
+
+            for (auto callback = it->second.begin(); callback != it->second.end(); ++callback)
+                (*callback)(tok);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef tokendispatcherH
+#define tokendispatcherH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Check;
+class SymbolDatabase;
+class Token;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Run several checks in a single pass over the function scopes.
+ *
+ * Checks that only look at tokens with certain names (function calls,
+ * variable names) register these names as triggers together with a
+ * callback. dispatch() walks the tokens of all function scopes once and
+ * calls the callbacks of each name token that is a trigger, in the order
+ * they were added.
+ */
+class CPPCHECKLIB TokenDispatcher {
+public:
+    typedef std::function<void(const Token *)> Callback;
+
+    TokenDispatcher() {}
+    ~TokenDispatcher();
+
+    /** @brief Call callback for each name token in a function scope whose str() is name */
+    void addTrigger(const std::string &name, const Callback &callback);
+
+    /** @brief Take ownership of a check instance, it is deleted with the dispatcher */
+    void addCheck(Check *check);
+
+    /** @brief Are there any triggers? */
+    bool empty() const {
+        return _triggers.empty();
+    }
+
+    /** @brief Walk the function scopes once and call the callbacks of the triggers */
+    void dispatch(const SymbolDatabase *symbolDatabase) const;
+
+private:
+    /** Disable copy constructor and assignment operator, no implementation */
+    TokenDispatcher(const TokenDispatcher &);
+    TokenDispatcher &operator=(const TokenDispatcher &);
+
+    /** callbacks for each trigger name */
+    std::unordered_map<std::string, std::vector<Callback> > _triggers;
+
+    /** check instances used by the callbacks */
+    std::list<Check *> _checks;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // tokendispatcherH
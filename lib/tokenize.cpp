@@ -27,6 +27,7 @@
 #include "templatesimplifier.h"
 #include "timer.h"
 
+#include <atomic>
 #include <cstring>
 #include <sstream>
 #include <cassert>
@@ -43,7 +44,8 @@ list(0),
     _symbolDatabase(0),
     _varId(0),
     _codeWithTemplates(false), //is there any templates?
-    m_timerResults(nullptr)
+    m_timerResults(nullptr),
+    m_templateExpansionCache(nullptr)
 #ifdef MAXTIME
     ,maxtime(std::time(0) + MAXTIME)
 #endif
@@ -57,7 +59,8 @@ list(settings),
     _symbolDatabase(0),
     _varId(0),
     _codeWithTemplates(false), //is there any templates?
-    m_timerResults(nullptr)
+    m_timerResults(nullptr),
+    m_templateExpansionCache(nullptr)
 #ifdef MAXTIME
     ,maxtime(std::time(0) + MAXTIME)
 #endif
@@ -390,7 +393,7 @@ static Token *splitDefinitionFromTypedef(Token *tok)
             if (Token::Match(tok1->next(), "%type%"))
                 name = tok1->next()->str();
             else { // create a unique name
-                static unsigned int count = 0;
+                static std::atomic<unsigned int> count(0);
                 name = "Unnamed" + MathLib::toString(count++);
             }
             tok->next()->insertToken(name);
@@ -1617,9 +1620,12 @@ bool Tokenizer::tokenize(std::istream &code,
 
     _configuration = configuration;
 
-    if (!list.createTokens(code, Path::getRelativePath(Path::simplifyPath(FileName), _settings->_basePaths))) {
-        cppcheckError(0);
-        return false;
+    {
+        Timer t("Tokenizer::tokenize::createTokens", _settings->_showtime, m_timerResults);
+        if (!list.createTokens(code, Path::getRelativePath(Path::simplifyPath(FileName), _settings->_basePaths))) {
+            cppcheckError(0);
+            return false;
+        }
     }
 
     if (simplifyTokenList1(FileName)) {
@@ -2285,11 +2291,20 @@ void Tokenizer::simplifyTemplates()
         }
     }
 
+    // The shared cache is bounded by the settings
+    TemplateExpansionCache *cache = m_templateExpansionCache;
+    if (!cache) {
+        cache = &TemplateExpansionCache::instance();
+        cache->setMaxTokens(_settings->_templateCacheSize);
+    }
+
     TemplateSimplifier::simplifyTemplates(
         list,
         _errorLogger,
         _settings,
-        _codeWithTemplates);
+        _codeWithTemplates,
+        m_timerResults,
+        cache);
 }
 //---------------------------------------------------------------------------
 
@@ -3565,7 +3580,12 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
             ;
 
     // Handle templates..
-    simplifyTemplates();
+    if (m_timerResults) {
+        Timer t("Tokenizer::tokenize::simplifyTemplates", _settings->_showtime, m_timerResults);
+        simplifyTemplates();
+    } else {
+        simplifyTemplates();
+    }
 
     // The simplifyTemplates have inner loops
     if (_settings->terminated())
@@ -10142,6 +10162,25 @@ void Tokenizer::deleteSymbolDatabase()
     _symbolDatabase = 0;
 }
 
+void Tokenizer::restrictFunctionScopes(const ChangedLines &changedLines, ChangedLines &checkedLines)
+{
+    if (!_symbolDatabase)
+        return;
+
+    std::vector<const Scope *> &functionScopes = _symbolDatabase->functionScopes;
+    std::vector<const Scope *> changed;
+    for (std::size_t i = 0; i < functionScopes.size(); ++i) {
+        const Scope *scope = functionScopes[i];
+        const Token *start = scope->classDef ? scope->classDef : scope->classStart;
+        const std::string &file = list.file(start);
+        if (changedLines.overlaps(file, start->linenr(), scope->classEnd->linenr())) {
+            changed.push_back(scope);
+            checkedLines.add(file, start->linenr(), scope->classEnd->linenr());
+        }
+    }
+    functionScopes.swap(changed);
+}
+
 static bool operatorEnd(const Token * tok)
 {
     if (tok && tok->str() == ")") {
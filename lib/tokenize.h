@@ -30,9 +30,11 @@
 #include <list>
 #include <ctime>
 
+class ChangedLines;
 class Settings;
 class SymbolDatabase;
 class TimerResults;
+class TemplateExpansionCache;
 
 /// @addtogroup Core
 /// @{
@@ -48,6 +50,11 @@ public:
         m_timerResults = tr;
     }
 
+    /** Use another cache than the process-wide one for template expansions */
+    void setTemplateExpansionCache(TemplateExpansionCache *cache) {
+        m_templateExpansionCache = cache;
+    }
+
     /** Is the code C. Used for bailouts */
     bool isC() const {
         return list.isC();
@@ -716,6 +723,15 @@ public:
     void createSymbolDatabase();
     void deleteSymbolDatabase();
 
+    /**
+     * @brief Remove the function scopes that don't overlap the changed lines
+     * from the symbol database (--diff). Checks that iterate over the
+     * function scopes only check the changed functions then.
+     * @param changedLines changed lines
+     * @param checkedLines the lines of the remaining function scopes are added here
+     */
+    void restrictFunctionScopes(const ChangedLines &changedLines, ChangedLines &checkedLines);
+
     void printDebugOutput() const;
 
     void dump(std::ostream &out) const;
@@ -834,6 +850,11 @@ private:
      * TimerResults
      */
     TimerResults *m_timerResults;
+
+    /**
+     * Cache for template expansions, null => TemplateExpansionCache::instance()
+     */
+    TemplateExpansionCache *m_templateExpansionCache;
 #ifdef MAXTIME
     /** Tokenizer maxtime */
     std::time_t maxtime;
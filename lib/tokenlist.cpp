@@ -40,6 +40,7 @@ static const unsigned int AST_MAX_DEPTH = 50U;
 TokenList::TokenList(const Settings* settings) :
     _front(0),
     _back(0),
+    _arena(sizeof(Token)),
     _settings(settings),
     _isC(false),
     _isCPP(false)
@@ -66,10 +67,20 @@ const std::string& TokenList::getSourceFilePath() const
 // Deallocate lists..
 void TokenList::deallocateTokens()
 {
-    deleteTokens(_front);
+    // The tokens in the arena are destroyed and then all memory is released at once
+    for (Token *tok = _front; tok;) {
+        Token * const next = tok->next();
+        if (tok->arena() == &_arena)
+            tok->~Token();
+        else
+            Token::destroy(tok);
+        tok = next;
+    }
+    _arena.release();
     _front = 0;
     _back = 0;
     _files.clear();
+    _libraryViews.clear();
 }
 
 unsigned int TokenList::appendFileIfNew(const std::string &fileName)
@@ -81,6 +92,7 @@ unsigned int TokenList::appendFileIfNew(const std::string &fileName)
 
     // The "_files" vector remembers what files have been tokenized..
     _files.push_back(Path::simplifyPath(fileName));
+    _libraryViews.push_back(_settings ? _settings->library.fileView(fileName) : Library::FileView());
 
     // Update _isC and _isCPP properties
     if (_files.size() == 1) { // Update only useful if first file added to _files
@@ -99,7 +111,7 @@ void TokenList::deleteTokens(Token *tok)
 {
     while (tok) {
         Token *next = tok->next();
-        delete tok;
+        Token::destroy(tok);
         tok = next;
     }
 }
@@ -143,7 +155,7 @@ void TokenList::addtoken(const std::string & str, const unsigned int lineno, con
     if (_back) {
         _back->insertToken(str2);
     } else {
-        _front = new Token(&_back);
+        _front = Token::create(&_back, &_arena);
         _back = _front;
         _back->str(str2);
     }
@@ -162,7 +174,7 @@ void TokenList::addtoken(const Token * tok, const unsigned int lineno, const uns
     if (_back) {
         _back->insertToken(tok->str(), tok->originalName());
     } else {
-        _front = new Token(&_back);
+        _front = Token::create(&_back, &_arena);
         _back = _front;
         _back->str(tok->str());
         if (!tok->originalName().empty())
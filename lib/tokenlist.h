@@ -24,6 +24,8 @@
 #include <string>
 #include <vector>
 #include "config.h"
+#include "library.h"
+#include "tokenarena.h"
 
 class Token;
 class Settings;
@@ -106,6 +108,14 @@ public:
         return _files;
     }
 
+    /**
+     * Get the Library settings for a file, resolved once when the file is added
+     * @param fileIndex index in the getFiles() vector
+     */
+    const Library::FileView& libraryView(unsigned int fileIndex) const {
+        return _libraryViews[fileIndex];
+    }
+
     /**
      * get filename for given token
      * @param tok The given token
@@ -141,9 +151,15 @@ private: /// private
     /** Token list */
     Token *_front, *_back;
 
+    /** memory for the tokens */
+    TokenArena _arena;
+
     /** filenames for the tokenized source code (source + included) */
     std::vector<std::string> _files;
 
+    /** Library settings for each file in _files */
+    std::vector<Library::FileView> _libraryViews;
+
     /** settings */
     const Settings* _settings;
 
@@ -0,0 +1,65 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tokenstrings.h"
+
+#include <unordered_map>
+
+static const std::string strings[] = {
+    "",
+#define TOKEN_STRING(name, str) str,
+    TOKEN_STRINGS
+#undef TOKEN_STRING
+};
+
+namespace {
+    class Table {
+    public:
+        Table() : maxLength(0) {
+            for (unsigned int i = 1; i < TokenStrings::Count; ++i) {
+                ids[strings[i]] = static_cast<TokenStrings::Id>(i);
+                if (strings[i].size() > maxLength)
+                    maxLength = strings[i].size();
+            }
+        }
+
+        std::unordered_map<std::string, TokenStrings::Id> ids;
+        std::string::size_type maxLength;
+    };
+}
+
+// The table is never changed after it is built, so it can be used by several threads
+static const Table &getTable()
+{
+    static const Table table;
+    return table;
+}
+
+TokenStrings::Id TokenStrings::id(const std::string &str)
+{
+    const Table &table = getTable();
+    if (str.empty() || str.size() > table.maxLength || str[0] == '"' || str[0] == '\'')
+        return None;
+    const auto it = table.ids.find(str);
+    return it == table.ids.end() ? None : it->second;
+}
+
+const std::string &TokenStrings::str(Id id)
+{
+    return strings[id < Count ? id : None];
+}
@@ -0,0 +1,176 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef tokenstringsH
+#define tokenstringsH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <string>
+
+/**
+ * Token strings that have a fixed id. tools/matchcompiler.py reads this
+ * list, so keep one entry per line. New entries can be added anywhere.
+ */
+#define TOKEN_STRINGS \
+    TOKEN_STRING(Asm, "asm") \
+    TOKEN_STRING(Auto, "auto") \
+    TOKEN_STRING(Bool, "bool") \
+    TOKEN_STRING(Break, "break") \
+    TOKEN_STRING(Case, "case") \
+    TOKEN_STRING(Catch, "catch") \
+    TOKEN_STRING(Char, "char") \
+    TOKEN_STRING(Class, "class") \
+    TOKEN_STRING(Const, "const") \
+    TOKEN_STRING(ConstCast, "const_cast") \
+    TOKEN_STRING(Continue, "continue") \
+    TOKEN_STRING(Default, "default") \
+    TOKEN_STRING(Delete, "delete") \
+    TOKEN_STRING(Do, "do") \
+    TOKEN_STRING(Double, "double") \
+    TOKEN_STRING(DynamicCast, "dynamic_cast") \
+    TOKEN_STRING(Else, "else") \
+    TOKEN_STRING(Enum, "enum") \
+    TOKEN_STRING(Explicit, "explicit") \
+    TOKEN_STRING(Extern, "extern") \
+    TOKEN_STRING(False, "false") \
+    TOKEN_STRING(Float, "float") \
+    TOKEN_STRING(For, "for") \
+    TOKEN_STRING(Friend, "friend") \
+    TOKEN_STRING(Goto, "goto") \
+    TOKEN_STRING(If, "if") \
+    TOKEN_STRING(Inline, "inline") \
+    TOKEN_STRING(Int, "int") \
+    TOKEN_STRING(Long, "long") \
+    TOKEN_STRING(Mutable, "mutable") \
+    TOKEN_STRING(Namespace, "namespace") \
+    TOKEN_STRING(New, "new") \
+    TOKEN_STRING(Nullptr, "nullptr") \
+    TOKEN_STRING(Operator, "operator") \
+    TOKEN_STRING(Private, "private") \
+    TOKEN_STRING(Protected, "protected") \
+    TOKEN_STRING(Public, "public") \
+    TOKEN_STRING(Register, "register") \
+    TOKEN_STRING(ReinterpretCast, "reinterpret_cast") \
+    TOKEN_STRING(Return, "return") \
+    TOKEN_STRING(Short, "short") \
+    TOKEN_STRING(Signed, "signed") \
+    TOKEN_STRING(Sizeof, "sizeof") \
+    TOKEN_STRING(Static, "static") \
+    TOKEN_STRING(StaticCast, "static_cast") \
+    TOKEN_STRING(Struct, "struct") \
+    TOKEN_STRING(Switch, "switch") \
+    TOKEN_STRING(Template, "template") \
+    TOKEN_STRING(This, "this") \
+    TOKEN_STRING(Throw, "throw") \
+    TOKEN_STRING(True, "true") \
+    TOKEN_STRING(Try, "try") \
+    TOKEN_STRING(Typedef, "typedef") \
+    TOKEN_STRING(Typename, "typename") \
+    TOKEN_STRING(Union, "union") \
+    TOKEN_STRING(Unsigned, "unsigned") \
+    TOKEN_STRING(Using, "using") \
+    TOKEN_STRING(Virtual, "virtual") \
+    TOKEN_STRING(Void, "void") \
+    TOKEN_STRING(Volatile, "volatile") \
+    TOKEN_STRING(While, "while") \
+    TOKEN_STRING(Std, "std") \
+    TOKEN_STRING(LParen, "(") \
+    TOKEN_STRING(RParen, ")") \
+    TOKEN_STRING(LBrace, "{") \
+    TOKEN_STRING(RBrace, "}") \
+    TOKEN_STRING(LBracket, "[") \
+    TOKEN_STRING(RBracket, "]") \
+    TOKEN_STRING(Semicolon, ";") \
+    TOKEN_STRING(Comma, ",") \
+    TOKEN_STRING(Dot, ".") \
+    TOKEN_STRING(Arrow, "->") \
+    TOKEN_STRING(Scope, "::") \
+    TOKEN_STRING(Colon, ":") \
+    TOKEN_STRING(Question, "?") \
+    TOKEN_STRING(Assign, "=") \
+    TOKEN_STRING(Equal, "==") \
+    TOKEN_STRING(NotEqual, "!=") \
+    TOKEN_STRING(Less, "<") \
+    TOKEN_STRING(LessEqual, "<=") \
+    TOKEN_STRING(Greater, ">") \
+    TOKEN_STRING(GreaterEqual, ">=") \
+    TOKEN_STRING(Plus, "+") \
+    TOKEN_STRING(Minus, "-") \
+    TOKEN_STRING(Star, "*") \
+    TOKEN_STRING(Slash, "/") \
+    TOKEN_STRING(Percent, "%") \
+    TOKEN_STRING(Amp, "&") \
+    TOKEN_STRING(Pipe, "|") \
+    TOKEN_STRING(Caret, "^") \
+    TOKEN_STRING(Tilde, "~") \
+    TOKEN_STRING(Not, "!") \
+    TOKEN_STRING(AndAnd, "&&") \
+    TOKEN_STRING(OrOr, "||") \
+    TOKEN_STRING(ShiftLeft, "<<") \
+    TOKEN_STRING(ShiftRight, ">>") \
+    TOKEN_STRING(Increment, "++") \
+    TOKEN_STRING(Decrement, "--") \
+    TOKEN_STRING(PlusAssign, "+=") \
+    TOKEN_STRING(MinusAssign, "-=") \
+    TOKEN_STRING(StarAssign, "*=") \
+    TOKEN_STRING(SlashAssign, "/=") \
+    TOKEN_STRING(PercentAssign, "%=") \
+    TOKEN_STRING(AmpAssign, "&=") \
+    TOKEN_STRING(PipeAssign, "|=") \
+    TOKEN_STRING(CaretAssign, "^=") \
+    TOKEN_STRING(ShiftLeftAssign, "<<=") \
+    TOKEN_STRING(ShiftRightAssign, ">>=") \
+    TOKEN_STRING(Hash, "#") \
+    TOKEN_STRING(Ellipsis, "...") \
+    TOKEN_STRING(Zero, "0") \
+    TOKEN_STRING(One, "1")
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Fixed ids for common token strings.
+ *
+ * Keywords, operators and punctuators get a pre-assigned id that is
+ * stored in each Token. Comparing ids is cheaper than comparing strings,
+ * and tools/matchcompiler.py uses them in the compiled match functions.
+ * Other strings have the id None.
+ */
+class CPPCHECKLIB TokenStrings {
+public:
+    enum Id {
+        None = 0,
+#define TOKEN_STRING(name, str) name,
+        TOKEN_STRINGS
+#undef TOKEN_STRING
+        Count
+    };
+
+    /** @brief Id of a token string, None if it has no fixed id */
+    static Id id(const std::string &str);
+
+    /** @brief String of an id, empty for None */
+    static const std::string &str(Id id);
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // tokenstringsH
@@ -23,7 +23,85 @@
 #include "symboldatabase.h"
 #include "token.h"
 #include "tokenlist.h"
+
+#include <algorithm>
+#include <new>
 #include <stack>
+#include <utility>
+#include <vector>
+
+namespace {
+    /**
+     * The tokens of each variable in token list order. They are collected
+     * once so a range of code can be searched for a variable without
+     * walking the tokens in between. Token::index() must be up to date.
+     */
+    class VariableTokens {
+    public:
+        explicit VariableTokens(TokenList *tokenlist) : _tokens(1U), _indexes(1U) {
+            for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
+                const unsigned int varid = tok->varId();
+                if (varid == 0U)
+                    continue;
+                if (varid >= _tokens.size()) {
+                    _tokens.resize(varid + 1U);
+                    _indexes.resize(varid + 1U);
+                }
+                _tokens[varid].push_back(tok);
+                _indexes[varid].push_back(tok->index());
+            }
+        }
+
+        typedef std::vector<Token *>::const_iterator const_iterator;
+
+        /**
+         * Get the tokens of the variable from start up to but not including
+         * end, like a loop from start while tok != end. end=nullptr => until
+         * the end of the token list.
+         */
+        std::pair<const_iterator, const_iterator> range(const Token *start, const Token *end, unsigned int varid) const {
+            if (varid >= _tokens.size())
+                varid = 0U;
+            const std::vector<Token *> &tokens = _tokens[varid];
+            if (!start)
+                return std::make_pair(tokens.end(), tokens.end());
+            const std::vector<unsigned int> &indexes = _indexes[varid];
+            const auto first = std::lower_bound(indexes.begin(), indexes.end(), start->index());
+            const auto last = (!end || end->index() < start->index()) ?
+                              indexes.end() :
+                              std::lower_bound(first, indexes.end(), end->index());
+            return std::make_pair(tokens.begin() + (first - indexes.begin()), tokens.begin() + (last - indexes.begin()));
+        }
+
+        /**
+         * Is it faster to walk the tokens from start to end than to search
+         * the tokens of the variable?
+         */
+        static bool isShort(const Token *start, const Token *end) {
+            return start && end && start->index() <= end->index() && end->index() - start->index() < 64U;
+        }
+
+        /** First token of the variable from start up to but not including end */
+        const Token *find(const Token *start, const Token *end, unsigned int varid) const {
+            if (isShort(start, end)) {
+                for (const Token *tok = start; tok != end; tok = tok->next()) {
+                    if (tok->varId() == varid)
+                        return tok;
+                }
+                return nullptr;
+            }
+            const std::pair<const_iterator, const_iterator> tokens = range(start, end, varid);
+            return (tokens.first == tokens.second) ? nullptr : *tokens.first;
+        }
+
+    private:
+        /** tokens for each varid. varid 0 has no tokens. */
+        std::vector<std::vector<Token *> > _tokens;
+
+        /** Token::index() of the tokens, for searching without dereferencing them */
+        std::vector<std::vector<unsigned int> > _indexes;
+    };
+}
 
 static void execute(const Token *expr,
                     std::map<unsigned int, MathLib::bigint> * const programMemory,
@@ -93,6 +171,34 @@ static bool bailoutFunctionPar(const Token *tok, const ValueFlow::Value &value,
     return arg && !arg->isConst() && arg->isReference();
 }
 
+/**
+ * Can execute() calculate the expression when all variables have known
+ * values? If it can't, the condition is never known to be true or false
+ * and the program memory does not need to be collected. && is handled
+ * like conditionIsFalse() does. Keep this in sync with execute().
+ */
+static bool canExecute(const Token *expr)
+{
+    if (!expr)
+        return false;
+    if (expr->isNumber())
+        return !MathLib::isFloat(expr->str());
+    if (expr->varId() > 0)
+        return true;
+    if (expr->isComparisonOp() || (expr->str() == "," && expr->astOperand1() && expr->astOperand2()) ||
+        (expr->isArithmeticalOp() && expr->astOperand1() && expr->astOperand2()))
+        return canExecute(expr->astOperand1()) && canExecute(expr->astOperand2());
+    if (expr->str() == "=")
+        return canExecute(expr->astOperand2()) && expr->astOperand1() && expr->astOperand1()->varId();
+    if (Token::Match(expr, "++|--"))
+        return expr->astOperand1() && expr->astOperand1()->varId();
+    if (expr->str() == "&&")
+        return canExecute(expr->astOperand1()) || canExecute(expr->astOperand2());
+    if (Token::Match(expr, "%oror%|!"))
+        return canExecute(expr->astOperand1());
+    return false;
+}
+
 /**
  * Is condition always false when variable has given value?
  * \param condition   top ast token in condition
@@ -107,6 +213,8 @@ static bool conditionIsFalse(const Token *condition, const std::map<unsigned int
         const bool result2 = result1 ? true : conditionIsFalse(condition->astOperand2(), programMemory);
         return result2;
     }
+    if (!canExecute(condition))
+        return false;
     std::map<unsigned int, MathLib::bigint> progmem(programMemory);
     MathLib::bigint result = 0;
     bool error = false;
@@ -128,6 +236,8 @@ static bool conditionIsTrue(const Token *condition, const std::map<unsigned int,
         const bool result2 = result1 ? true : conditionIsTrue(condition->astOperand2(), programMemory);
         return result2;
     }
+    if (!canExecute(condition))
+        return false;
     std::map<unsigned int, MathLib::bigint> progmem(programMemory);
     bool error = false;
     MathLib::bigint result = 0;
@@ -135,6 +245,14 @@ static bool conditionIsTrue(const Token *condition, const std::map<unsigned int,
     return !error && result == 1;
 }
 
+/** Can conditionIsTrue() return true for some program memory? */
+static bool conditionCanBeTrue(const Token *condition)
+{
+    if (condition && condition->str() == "||")
+        return conditionCanBeTrue(condition->astOperand1()) || conditionCanBeTrue(condition->astOperand2());
+    return canExecute(condition);
+}
+
 /**
  * Get program memory by looking backwards from given token.
  */
@@ -252,19 +370,32 @@ static bool isReturn(const Token *tok)
     return false;
 }
 
-static bool isVariableChanged(const Token *start, const Token *end, const unsigned int varid)
+/** Is the variable changed at the token? */
+static bool isVariableChanged(const Token *tok)
 {
-    for (const Token *tok = start; tok != end; tok = tok->next()) {
-        if (tok->varId() == varid) {
-            if (Token::Match(tok, "%var% ="))
-                return true;
+    if (Token::Match(tok, "%var% ="))
+        return true;
 
-            const Token *parent = tok->astParent();
-            while (Token::Match(parent, ".|::"))
-                parent = parent->astParent();
-            if (parent && parent->type() == Token::eIncDecOp)
+    const Token *parent = tok->astParent();
+    while (Token::Match(parent, ".|::"))
+        parent = parent->astParent();
+    return parent && parent->type() == Token::eIncDecOp;
+}
+
+static bool isVariableChanged(const VariableTokens &varTokens, const Token *start, const Token *end, const unsigned int varid)
+{
+    if (VariableTokens::isShort(start, end)) {
+        for (const Token *tok = start; tok != end; tok = tok->next()) {
+            if (tok->varId() == varid && isVariableChanged(tok))
                 return true;
         }
+        return false;
+    }
+
+    const std::pair<VariableTokens::const_iterator, VariableTokens::const_iterator> tokens = varTokens.range(start, end, varid);
+    for (auto it = tokens.first; it != tokens.second; ++it) {
+        if (isVariableChanged(*it))
+            return true;
     }
     return false;
 }
@@ -421,7 +552,7 @@ static void valueFlowBitAnd(TokenList *tokenlist)
     }
 }
 
-static void valueFlowBeforeCondition(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowBeforeCondition(TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
         unsigned int varid=0;
@@ -469,7 +600,7 @@ static void valueFlowBeforeCondition(TokenList *tokenlist, ErrorLogger *errorLog
 
             // Variable changed in 3rd for-expression
             if (Token::simpleMatch(tok2->previous(), "for (")) {
-                if (isVariableChanged(tok2->astOperand2()->astOperand2(), tok2->link(), varid)) {
+                if (isVariableChanged(varTokens, tok2->astOperand2()->astOperand2(), tok2->link(), varid)) {
                     varid = 0U;
                     if (settings->debugwarnings)
                         bailout(tokenlist, errorLogger, tok, "variable " + var->name() + " used in loop");
@@ -481,7 +612,7 @@ static void valueFlowBeforeCondition(TokenList *tokenlist, ErrorLogger *errorLog
                 const Token * const start = tok2->link()->next();
                 const Token * const end   = start->link();
 
-                if (isVariableChanged(start,end,varid)) {
+                if (isVariableChanged(varTokens, start,end,varid)) {
                     varid = 0U;
                     if (settings->debugwarnings)
                         bailout(tokenlist, errorLogger, tok, "variable " + var->name() + " used in loop");
@@ -598,9 +729,9 @@ static void valueFlowBeforeCondition(TokenList *tokenlist, ErrorLogger *errorLog
             }
 
             if (tok2->str() == "}") {
-                const Token *vartok = Token::findmatch(tok2->link(), "%varid%", tok2, varid);
+                const Token *vartok = varTokens.find(tok2->link(), tok2, varid);
                 while (Token::Match(vartok, "%var% = %num% ;") && !vartok->tokAt(2)->getValue(num))
-                    vartok = Token::findmatch(vartok->next(), "%varid%", tok2, varid);
+                    vartok = varTokens.find(vartok->next(), tok2, varid);
                 if (vartok) {
                     if (settings->debugwarnings) {
                         std::string errmsg = "variable ";
@@ -621,7 +752,7 @@ static void valueFlowBeforeCondition(TokenList *tokenlist, ErrorLogger *errorLog
 
                     const Token *start = tok2;
                     const Token *end   = start->link();
-                    if (isVariableChanged(start,end,varid)) {
+                    if (isVariableChanged(varTokens, start,end,varid)) {
                         if (settings->debugwarnings)
                             bailout(tokenlist, errorLogger, tok2, "variable " + var->name() + " is assigned in loop. so valueflow analysis bailout when start of loop is reached.");
                         break;
@@ -678,6 +809,7 @@ static bool valueFlowForward(Token * const               startToken,
                              std::list<ValueFlow::Value> values,
                              const bool                  constValue,
                              TokenList * const           tokenlist,
+                             const VariableTokens        &varTokens,
                              ErrorLogger * const         errorLogger,
                              const Settings * const      settings)
 {
@@ -706,7 +838,8 @@ static bool valueFlowForward(Token * const               startToken,
                 }
 
                 bool bailoutflag = false;
-                for (std::list<ValueFlow::Value>::const_iterator it = values.begin(); it != values.end(); ++it) 
+                const bool canBeTrue = conditionCanBeTrue(condition);
+                for (std::list<ValueFlow::Value>::const_iterator it = values.begin(); canBeTrue && it != values.end(); ++it) 
                 {
                     if (conditionIsTrue(condition, getProgramMemory(condition->astParent(), varid, *it))) 
                     {
@@ -734,7 +867,8 @@ static bool valueFlowForward(Token * const               startToken,
             const Token *condition = tok2->linkAt(-1);
             condition = condition ? condition->linkAt(-1) : nullptr;
             condition = condition ? condition->astOperand2() : nullptr;
-            for (auto it = values.begin(); it != values.end(); ++it) {
+            const bool canBeTrue = conditionCanBeTrue(condition);
+            for (auto it = values.begin(); canBeTrue && it != values.end(); ++it) {
                 if (conditionIsTrue(condition, getProgramMemory(tok2, varid, *it))) {
                     skipelse = true;
                     break;
@@ -750,7 +884,7 @@ static bool valueFlowForward(Token * const               startToken,
         else if (Token::Match(tok2, "%var% (") && Token::simpleMatch(tok2->linkAt(1), ") {")) 
         {
             // is variable changed in condition?
-            if (isVariableChanged(tok2->next(), tok2->next()->link(), varid)) {
+            if (isVariableChanged(varTokens, tok2->next(), tok2->next()->link(), varid)) {
                 if (settings->debugwarnings)
                     bailout(tokenlist, errorLogger, tok2, "variable " + var->name() + " valueFlowForward, assignment in condition");
                 return false;
@@ -758,8 +892,9 @@ static bool valueFlowForward(Token * const               startToken,
 
             // Should scope be skipped because variable value is checked?
             std::list<ValueFlow::Value> truevalues;
+            const bool canBeFalse = canExecute(tok2->next()->astOperand2());
             for (std::list<ValueFlow::Value>::iterator it = values.begin(); it != values.end(); ++it) {
-                if (!conditionIsFalse(tok2->next()->astOperand2(), getProgramMemory(tok2, varid, *it)))
+                if (!canBeFalse || !conditionIsFalse(tok2->next()->astOperand2(), getProgramMemory(tok2, varid, *it)))
                     truevalues.push_back(*it);
             }
             if (truevalues.size() != values.size()) 
@@ -774,10 +909,11 @@ static bool valueFlowForward(Token * const               startToken,
                                  truevalues,
                                  constValue,
                                  tokenlist,
+                                 varTokens,
                                  errorLogger,
                                  settings);
 
-                if (isVariableChanged(startToken1, startToken1->link(), varid))
+                if (isVariableChanged(varTokens, startToken1, startToken1->link(), varid))
                     removeValues(values, truevalues);
 
                 // goto '}'
@@ -788,10 +924,12 @@ static bool valueFlowForward(Token * const               startToken,
             Token * const start = tok2->linkAt(1)->next();
             Token * const end   = start->link();
             bool varusage = (indentlevel >= 0 && constValue && number_of_if == 0U) ?
-                            isVariableChanged(start,end,varid) :
-                            (nullptr != Token::findmatch(start, "%varid%", end, varid));
+                            isVariableChanged(varTokens, start,end,varid) :
+                            (nullptr != varTokens.find(start, end, varid));
             if (!read) {
-                read = bool(nullptr != Token::findmatch(tok2, "%varid% !!=", end, varid));
+                const std::pair<VariableTokens::const_iterator, VariableTokens::const_iterator> tokens = varTokens.range(tok2, end, varid);
+                for (auto it = tokens.first; !read && it != tokens.second; ++it)
+                    read = !Token::simpleMatch((*it)->next(), "=");
             }
             if (varusage) 
             {
@@ -801,7 +939,7 @@ static bool valueFlowForward(Token * const               startToken,
                     return false;
 
                 // TODO: don't check noreturn scopes
-                if (read && (number_of_if > 0U || Token::findmatch(tok2, "%varid%", start, varid))) 
+                if (read && (number_of_if > 0U || varTokens.find(tok2, start, varid))) 
                 {
                     // Set values in condition
                     const Token * const condend = tok2->linkAt(1);
@@ -837,7 +975,7 @@ static bool valueFlowForward(Token * const               startToken,
             }
 
             // noreturn scopes..
-            if ((number_of_if > 0 || Token::findmatch(tok2, "%varid%", start, varid)) &&
+            if ((number_of_if > 0 || varTokens.find(tok2, start, varid)) &&
                 (Token::findmatch(start, "return|continue|break|throw", end) ||
                  (Token::simpleMatch(end,"} else {") && Token::findmatch(end, "return|continue|break|throw", end->linkAt(2))))) 
             {
@@ -846,12 +984,12 @@ static bool valueFlowForward(Token * const               startToken,
                 return false;
             }
 
-            if (isVariableChanged(start, end, varid)) 
+            if (isVariableChanged(varTokens, start, end, varid)) 
             {
                 if ((!read || number_of_if == 0) &&
                     Token::simpleMatch(tok2, "if (") &&
                     !(Token::simpleMatch(end, "} else {") &&
-                      (Token::findmatch(end, "%varid%", end->linkAt(2), varid) ||
+                      (varTokens.find(end, end->linkAt(2), varid) ||
                        Token::findmatch(end, "return|continue|break|throw", end->linkAt(2))))) 
                 {
                     ++number_of_if;
@@ -873,11 +1011,11 @@ static bool valueFlowForward(Token * const               startToken,
                         loopCondition = true;
                     if (loopCondition) 
                     {
-                        const Token *tok3 = Token::findmatch(start, "%varid%", end, varid);
+                        const Token *tok3 = varTokens.find(start, end, varid);
                         if (Token::Match(tok3, "%varid% =", varid) &&
                             tok3->scope()->classEnd                &&
                             Token::Match(tok3->scope()->classEnd->tokAt(-3), "[;}] break ;") &&
-                            !Token::findmatch(tok3->next(), "%varid%", end, varid)) {
+                            !varTokens.find(tok3->next(), end, varid)) {
                             bail = false;
                             tok2 = end;
                         }
@@ -1018,7 +1156,7 @@ static bool valueFlowForward(Token * const               startToken,
     return true;
 }
 
-static void valueFlowAfterAssign(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowAfterAssign(TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
         // Assignment
@@ -1041,13 +1179,13 @@ static void valueFlowAfterAssign(TokenList *tokenlist, ErrorLogger *errorLogger,
         if (!tok->astOperand2() || tok->astOperand2()->values.empty())
             continue;
 
-        const std::list<ValueFlow::Value>& values = tok->astOperand2()->values;
+        const ValueFlow::ValueList &values = tok->astOperand2()->values;
         const bool constValue = tok->astOperand2()->isNumber();
-        valueFlowForward(tok, endOfVarScope, var, varid, values, constValue, tokenlist, errorLogger, settings);
+        valueFlowForward(tok, endOfVarScope, var, varid, std::list<ValueFlow::Value>(values.begin(), values.end()), constValue, tokenlist, varTokens, errorLogger, settings);
     }
 }
 
-static void valueFlowAfterCondition(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowAfterCondition(TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
         const Token *vartok, *numtok;
@@ -1128,7 +1266,7 @@ static void valueFlowAfterCondition(TokenList *tokenlist, ErrorLogger *errorLogg
             // does condition reassign variable?
             if (tok != top->astOperand2() &&
                 Token::Match(top->astOperand2(), "%oror%|&&") &&
-                isVariableChanged(top,top->link(),varid)) {
+                isVariableChanged(varTokens, top,top->link(),varid)) {
                 if (settings->debugwarnings)
                     bailout(tokenlist, errorLogger, tok, "assignment in condition");
                 continue;
@@ -1162,7 +1300,7 @@ static void valueFlowAfterCondition(TokenList *tokenlist, ErrorLogger *errorLogg
 
             bool ok = true;
             if (startToken)
-                ok = valueFlowForward(startToken->next(), startToken->link(), var, varid, values, true, tokenlist, errorLogger, settings);
+                ok = valueFlowForward(startToken->next(), startToken->link(), var, varid, values, true, tokenlist, varTokens, errorLogger, settings);
 
             // After conditional code..
             if (ok && Token::simpleMatch(top->link(), ") {")) {
@@ -1190,7 +1328,7 @@ static void valueFlowAfterCondition(TokenList *tokenlist, ErrorLogger *errorLogg
                     // TODO: constValue could be true if there are no assignments in the conditional blocks and
                     //       perhaps if there are no && and no || in the condition
                     bool constValue = false;
-                    valueFlowForward(after->next(), top->scope()->classEnd, var, varid, values, constValue, tokenlist, errorLogger, settings);
+                    valueFlowForward(after->next(), top->scope()->classEnd, var, varid, values, constValue, tokenlist, varTokens, errorLogger, settings);
                 }
             }
         }
@@ -1412,12 +1550,12 @@ static bool valueFlowForLoop2(const Token *tok,
     return true;
 }
 
-static void valueFlowForLoopSimplify(Token * const bodyStart, const unsigned int varid, const MathLib::bigint value, TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowForLoopSimplify(Token * const bodyStart, const unsigned int varid, const MathLib::bigint value, TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
     const Token * const bodyEnd = bodyStart->link();
 
     // Is variable modified inside for loop
-    if (isVariableChanged(bodyStart, bodyEnd, varid))
+    if (isVariableChanged(varTokens, bodyStart, bodyEnd, varid))
         return;
 
     for (Token *tok2 = bodyStart->next(); tok2 != bodyEnd; tok2 = tok2->next()) {
@@ -1467,7 +1605,7 @@ static void valueFlowForLoopSimplify(Token * const bodyStart, const unsigned int
             (tok2->str() == "||" && conditionIsTrue(tok2->astOperand1(), getProgramMemory(tok2->astTop(), varid, value))))
             break;
 
-        else if (Token::simpleMatch(tok2, ") {") && Token::findmatch(tok2->link(), "%varid%", tok2, varid)) {
+        else if (Token::simpleMatch(tok2, ") {") && varTokens.find(tok2->link(), tok2, varid)) {
             if (Token::findmatch(tok2, "continue|break|return", tok2->linkAt(1), varid)) {
                 if (settings->debugwarnings)
                     bailout(tokenlist, errorLogger, tok2, "For loop variable bailout on conditional continue|break|return");
@@ -1489,15 +1627,9 @@ static void valueFlowForLoopSimplify(Token * const bodyStart, const unsigned int
     }
 }
 
-static void valueFlowForLoopSimplifyAfter(Token *fortok, unsigned int varid, const MathLib::bigint num, TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowForLoopSimplifyAfter(Token *fortok, unsigned int varid, const MathLib::bigint num, TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
-    const Token *vartok = nullptr;
-    for (const Token *tok = fortok; tok; tok = tok->next()) {
-        if (tok->varId() == varid) {
-            vartok = tok;
-            break;
-        }
-    }
+    const Token *vartok = varTokens.find(fortok, nullptr, varid);
     if (!vartok || !vartok->variable())
         return;
 
@@ -1518,11 +1650,12 @@ static void valueFlowForLoopSimplifyAfter(Token *fortok, unsigned int varid, con
                      values,
                      false,
                      tokenlist,
+                     varTokens,
                      errorLogger,
                      settings);
 }
 
-static void valueFlowForLoop(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowForLoop(TokenList *tokenlist, const VariableTokens &varTokens, ErrorLogger *errorLogger, const Settings *settings)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
         if (!Token::simpleMatch(tok, "for (") ||
@@ -1539,27 +1672,42 @@ static void valueFlowForLoop(TokenList *tokenlist, ErrorLogger *errorLogger, con
 
         if (valueFlowForLoop1(tok, &varid, &num1, &num2, &numAfter)) {
             if (num1 <= num2) {
-                valueFlowForLoopSimplify(bodyStart, varid, num1, tokenlist, errorLogger, settings);
-                valueFlowForLoopSimplify(bodyStart, varid, num2, tokenlist, errorLogger, settings);
-                valueFlowForLoopSimplifyAfter(tok, varid, numAfter, tokenlist, errorLogger, settings);
+                valueFlowForLoopSimplify(bodyStart, varid, num1, tokenlist, varTokens, errorLogger, settings);
+                valueFlowForLoopSimplify(bodyStart, varid, num2, tokenlist, varTokens, errorLogger, settings);
+                valueFlowForLoopSimplifyAfter(tok, varid, numAfter, tokenlist, varTokens, errorLogger, settings);
             } else
-                valueFlowForLoopSimplifyAfter(tok, varid, num1, tokenlist, errorLogger, settings);
+                valueFlowForLoopSimplifyAfter(tok, varid, num1, tokenlist, varTokens, errorLogger, settings);
         } else {
             std::map<unsigned int, MathLib::bigint> mem1, mem2, memAfter;
             if (valueFlowForLoop2(tok, &mem1, &mem2, &memAfter)) {
                 for (auto it = mem1.begin(); it != mem1.end(); ++it)
-                    valueFlowForLoopSimplify(bodyStart, it->first, it->second, tokenlist, errorLogger, settings);
+                    valueFlowForLoopSimplify(bodyStart, it->first, it->second, tokenlist, varTokens, errorLogger, settings);
                 for (auto it = mem2.begin(); it != mem2.end(); ++it)
-                    valueFlowForLoopSimplify(bodyStart, it->first, it->second, tokenlist, errorLogger, settings);
+                    valueFlowForLoopSimplify(bodyStart, it->first, it->second, tokenlist, varTokens, errorLogger, settings);
                 for (auto it = memAfter.begin(); it != memAfter.end(); ++it)
-                    valueFlowForLoopSimplifyAfter(tok, it->first, it->second, tokenlist, errorLogger, settings);
+                    valueFlowForLoopSimplifyAfter(tok, it->first, it->second, tokenlist, varTokens, errorLogger, settings);
             }
         }
     }
 }
 
+namespace {
+    /** The tokens in a function body that get the values that are passed to a parameter */
+    struct ParameterUsage {
+        ParameterUsage() : bailout(nullptr) {}
+
+        std::vector<Token *> tokens;
+
+        /** token where the parameter values are no longer known */
+        const Token *bailout;
+    };
+}
+
 static void valueFlowSubFunction(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
 {
+    // The usage of each parameter is only searched once, not for every call
+    std::map<const Variable *, ParameterUsage> usages;
+
     for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
         if (!Token::Match(tok, "%var% ("))
             continue;
@@ -1584,7 +1732,7 @@ static void valueFlowSubFunction(TokenList *tokenlist, ErrorLogger *errorLogger,
 
             // passing value(s) to function
             if (!argtok->values.empty() && Token::Match(argtok, "%var%|%num%|%str% [,)]"))
-                argvalues = argtok->values;
+                argvalues.assign(argtok->values.begin(), argtok->values.end());
             else {
                 // bool operator => values 1/0 are passed to function..
                 const Token *op = argtok;
@@ -1595,7 +1743,7 @@ static void valueFlowSubFunction(TokenList *tokenlist, ErrorLogger *errorLogger,
                     argvalues.push_back(ValueFlow::Value(0));
                     argvalues.push_back(ValueFlow::Value(1));
                 } else if (Token::Match(op, "%cop%") && !op->values.empty()) {
-                    argvalues = op->values;
+                    argvalues.assign(op->values.begin(), op->values.end());
                 } else {
                     // possible values are unknown..
                     continue;
@@ -1608,17 +1756,25 @@ static void valueFlowSubFunction(TokenList *tokenlist, ErrorLogger *errorLogger,
                 continue;
 
             // Set value in function scope..
-            const unsigned int varid2 = arg->declarationId();
-            for (const Token *tok2 = functionScope->classStart->next(); tok2 != functionScope->classEnd; tok2 = tok2->next()) {
-                if (Token::Match(tok2, "%varid% !!=", varid2)) {
-                    for (std::list<ValueFlow::Value>::const_iterator val = argvalues.begin(); val != argvalues.end(); ++val)
-                        setTokenValue(const_cast<Token*>(tok2), *val);
-                } else if (Token::Match(tok2, "%oror%|&&|{|?")) {
-                    if (settings->debugwarnings)
-                        bailout(tokenlist, errorLogger, tok2, "parameter " + arg->name() + ", at '" + tok2->str() + "'");
-                    break;
+            auto usage = usages.find(arg);
+            if (usage == usages.end()) {
+                usage = usages.insert(std::make_pair(arg, ParameterUsage())).first;
+                const unsigned int varid2 = arg->declarationId();
+                for (Token *tok2 = functionScope->classStart->next(); tok2 != functionScope->classEnd; tok2 = tok2->next()) {
+                    if (Token::Match(tok2, "%varid% !!=", varid2)) {
+                        usage->second.tokens.push_back(tok2);
+                    } else if (Token::Match(tok2, "%oror%|&&|{|?")) {
+                        usage->second.bailout = tok2;
+                        break;
+                    }
                 }
             }
+            for (auto tok2 = usage->second.tokens.begin(); tok2 != usage->second.tokens.end(); ++tok2) {
+                for (std::list<ValueFlow::Value>::const_iterator val = argvalues.begin(); val != argvalues.end(); ++val)
+                    setTokenValue(*tok2, *val);
+            }
+            if (usage->second.bailout && settings->debugwarnings)
+                bailout(tokenlist, errorLogger, usage->second.bailout, "parameter " + arg->name() + ", at '" + usage->second.bailout->str() + "'");
         }
     }
 }
@@ -1692,14 +1848,64 @@ void ValueFlow::setValues(TokenList *tokenlist, ErrorLogger *errorLogger, const
     for (Token *tok = tokenlist->front(); tok; tok = tok->next())
         tok->values.clear();
 
+    Token::assignIndexes(tokenlist->front());
+    const VariableTokens varTokens(tokenlist);
+
     valueFlowNumber(tokenlist);
     valueFlowString(tokenlist);
     valueFlowPointerAlias(tokenlist);
     valueFlowFunctionReturn(tokenlist, errorLogger, settings);
     valueFlowBitAnd(tokenlist);
-    valueFlowForLoop(tokenlist, errorLogger, settings);
-    valueFlowBeforeCondition(tokenlist, errorLogger, settings);
-    valueFlowAfterAssign(tokenlist, errorLogger, settings);
-    valueFlowAfterCondition(tokenlist, errorLogger, settings);
+    valueFlowForLoop(tokenlist, varTokens, errorLogger, settings);
+    valueFlowBeforeCondition(tokenlist, varTokens, errorLogger, settings);
+    valueFlowAfterAssign(tokenlist, varTokens, errorLogger, settings);
+    valueFlowAfterCondition(tokenlist, varTokens, errorLogger, settings);
     valueFlowSubFunction(tokenlist, errorLogger, settings);
 }
+
+ValueFlow::ValueList::ValueList(const ValueList &other) : _block(nullptr)
+{
+    *this = other;
+}
+
+ValueFlow::ValueList::~ValueList()
+{
+    clear();
+}
+
+ValueFlow::ValueList &ValueFlow::ValueList::operator=(const ValueList &other)
+{
+    if (this == &other)
+        return *this;
+    if (_block)
+        _block->size = 0U;
+    for (auto it = other.begin(); it != other.end(); ++it)
+        push_back(*it);
+    return *this;
+}
+
+void ValueFlow::ValueList::push_back(const Value &value)
+{
+    if (!_block || _block->size == _block->capacity) {
+        // Most tokens get a single value
+        const unsigned int capacity = _block ? 2U * _block->capacity : 1U;
+        Block *block = static_cast<Block *>(::operator new(sizeof(Block) + capacity * sizeof(Value)));
+        block->size = 0U;
+        block->capacity = capacity;
+        Value * const values = reinterpret_cast<Value *>(block + 1);
+        // Value is trivially copyable and destructible
+        for (auto it = begin(); it != end(); ++it)
+            new (values + block->size++) Value(*it);
+        new (values + block->size++) Value(value);
+        ::operator delete(_block);
+        _block = block;
+        return;
+    }
+    new (data() + _block->size++) Value(value);
+}
+
+void ValueFlow::ValueList::clear()
+{
+    ::operator delete(_block);
+    _block = nullptr;
+}
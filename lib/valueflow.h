@@ -21,6 +21,10 @@
 #define valueflowH
 //---------------------------------------------------------------------------
 
+#include "config.h"
+
+#include <cstddef>
+
 class Token;
 class TokenList;
 class ErrorLogger;
@@ -54,6 +58,82 @@ namespace ValueFlow {
         bool inconclusive;
     };
 
+    /**
+     * @brief Values of a token.
+     *
+     * Most tokens have no values, so the list is only a pointer until the
+     * first value is added. The values are then stored in one block after
+     * a small header, like in a std::vector. Adding a value may move the
+     * other values, so iterators and pointers to values become invalid.
+     */
+    class CPPCHECKLIB ValueList {
+    public:
+        typedef Value *iterator;
+        typedef const Value *const_iterator;
+
+        ValueList() : _block(nullptr) {}
+        ValueList(const ValueList &other);
+        ~ValueList();
+        ValueList &operator=(const ValueList &other);
+
+        iterator begin() {
+            return _block ? data() : nullptr;
+        }
+        iterator end() {
+            return _block ? data() + _block->size : nullptr;
+        }
+        const_iterator begin() const {
+            return _block ? data() : nullptr;
+        }
+        const_iterator end() const {
+            return _block ? data() + _block->size : nullptr;
+        }
+
+        bool empty() const {
+            return !_block || _block->size == 0U;
+        }
+        std::size_t size() const {
+            return _block ? _block->size : 0U;
+        }
+
+        Value &front() {
+            return data()[0];
+        }
+        const Value &front() const {
+            return data()[0];
+        }
+        Value &back() {
+            return data()[_block->size - 1U];
+        }
+        const Value &back() const {
+            return data()[_block->size - 1U];
+        }
+
+        void push_back(const Value &value);
+
+        /** Remove all values and free the memory */
+        void clear();
+
+        void swap(ValueList &other) {
+            Block *block = _block;
+            _block = other._block;
+            other._block = block;
+        }
+
+    private:
+        /** header of the memory block, the values follow it */
+        struct Block {
+            unsigned int size;
+            unsigned int capacity;
+        };
+
+        Value *data() const {
+            return reinterpret_cast<Value *>(_block + 1);
+        }
+
+        Block *_block;
+    };
+
     void setValues(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings);
 }
 
@@ -0,0 +1,228 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysiscache.h"
+#include "cppcheck.h"
+#include "filelister.h"
+#include "settings.h"
+#include "testsuite.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <sstream>
+#ifndef _WIN32
+#include <stdlib.h>
+#include <unistd.h>
+#else
+#include <direct.h>
+#include <io.h>
+#endif
+
+extern std::ostringstream errout;
+
+/** Temporary directory for cache files. It is removed with its files. */
+class CacheDir {
+public:
+    CacheDir() {
+#ifndef _WIN32
+        char name[] = "/tmp/testanalysiscache-XXXXXX";
+        if (mkdtemp(name))
+            _path = name;
+#else
+        char name[] = "testanalysiscache-XXXXXX";
+        if (_mktemp_s(name, sizeof(name)) == 0 && _mkdir(name) == 0)
+            _path = name;
+#endif
+    }
+
+    ~CacheDir() {
+        if (_path.empty())
+            return;
+        std::map<std::string, std::size_t> files;
+        std::set<std::string> extra;
+        extra.insert(".cache");
+        extra.insert(".tmp");
+        FileLister::recursiveAddFiles(files, _path, extra);
+        for (auto it = files.begin(); it != files.end(); ++it)
+            std::remove(it->first.c_str());
+#ifndef _WIN32
+        rmdir(_path.c_str());
+#else
+        _rmdir(_path.c_str());
+#endif
+    }
+
+    const std::string &path() const {
+        return _path;
+    }
+
+private:
+    std::string _path;
+};
+
+class TestAnalysisCache : public TestFixture {
+public:
+    TestAnalysisCache() : TestFixture("TestAnalysisCache") {
+    }
+
+private:
+
+    void run() {
+        TEST_CASE(hash);
+        TEST_CASE(key);
+        TEST_CASE(fingerprint);
+        TEST_CASE(storeAndLoad);
+        TEST_CASE(usable);
+        TEST_CASE(replay);
+        TEST_CASE(wholeProgram);
+    }
+
+    void hash() const {
+        // FNV-1a test vectors
+        ASSERT_EQUALS(true, 0xcbf29ce484222325ULL == AnalysisCache::hash(""));
+        ASSERT_EQUALS(true, 0xaf63dc4c8601ec8cULL == AnalysisCache::hash("a"));
+        ASSERT_EQUALS(true, 0x85944171f73967e8ULL == AnalysisCache::hash("foobar"));
+    }
+
+    void key() const {
+        Settings settings;
+        const AnalysisCache cache(".", settings);
+        const std::string key1 = cache.key("int x;", "a.c", "");
+        ASSERT_EQUALS(32U, key1.size());
+        ASSERT_EQUALS(key1, cache.key("int x;", "a.c", ""));
+        ASSERT(key1 != cache.key("int y;", "a.c", ""));
+        ASSERT(key1 != cache.key("int x;", "b.c", ""));
+        ASSERT(key1 != cache.key("int x;", "a.c", "A"));
+
+        settings.addEnabled("style");
+        const AnalysisCache cache2(".", settings);
+        ASSERT(key1 != cache2.key("int x;", "a.c", ""));
+    }
+
+    void fingerprint() const {
+        Settings settings1, settings2;
+        ASSERT_EQUALS(AnalysisCache::fingerprint(settings1), AnalysisCache::fingerprint(settings2));
+        settings2.inconclusive = true;
+        ASSERT(AnalysisCache::fingerprint(settings1) != AnalysisCache::fingerprint(settings2));
+        settings2.inconclusive = false;
+        settings2.platform(Settings::Win64);
+        if (settings1.platformType != Settings::Win64)
+            ASSERT(AnalysisCache::fingerprint(settings1) != AnalysisCache::fingerprint(settings2));
+    }
+
+    void storeAndLoad() const {
+        const CacheDir dir;
+        Settings settings;
+        const AnalysisCache cache(dir.path(), settings);
+        const std::string key(cache.key("void f() {}", "storeAndLoad.c", ""));
+
+        AnalysisCache::Entry entry;
+        ASSERT_EQUALS(false, cache.load(key, entry));
+
+        entry.hasChecksum = true;
+        entry.checksum = 0x123456789ULL;
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("storeAndLoad.c", 3));
+        entry.messages.push_back(ErrorLogger::ErrorMessage(locs, Severity::error, "Short\nVerbose\nmessage", "id1", false));
+        entry.messages.push_back(ErrorLogger::ErrorMessage(locs, Severity::style, "Style", "id2", true));
+        entry.fileInfo = "16 Unused functions7 u f\nu g\n";
+        cache.store(key, entry);
+
+        AnalysisCache::Entry loaded;
+        ASSERT_EQUALS(true, cache.load(key, loaded));
+
+        ASSERT_EQUALS(true, loaded.hasChecksum);
+        ASSERT_EQUALS(true, 0x123456789ULL == loaded.checksum);
+        ASSERT_EQUALS(2U, loaded.messages.size());
+        ASSERT_EQUALS(entry.messages.front().serialize(), loaded.messages.front().serialize());
+        ASSERT_EQUALS(entry.messages.back().serialize(), loaded.messages.back().serialize());
+        ASSERT_EQUALS(entry.fileInfo, loaded.fileInfo);
+    }
+
+    void usable() const {
+        Settings settings;
+        ASSERT_EQUALS(true, AnalysisCache::isUsable(settings));
+        settings.debugwarnings = true;
+        ASSERT_EQUALS(false, AnalysisCache::isUsable(settings));
+        settings.debugwarnings = false;
+        settings.addEnabled("unusedFunction");
+        ASSERT_EQUALS(true, AnalysisCache::isUsable(settings));
+    }
+
+    void replay() {
+        const char code[] = "void f() {\n"
+                            "    char *p = malloc(10);\n"
+                            "}\n";
+        const CacheDir dir;
+
+        errout.str("");
+        {
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings().cacheDir = dir.path();
+            cppCheck.check("replay.c", code);
+        }
+        const std::string uncached = errout.str();
+        ASSERT_EQUALS("[replay.c:3]: (error) Memory leak: p\n", uncached);
+
+        // The stored result is used instead of checking the code again
+        Settings settings;
+        const AnalysisCache cache(dir.path(), settings);
+        const std::string key(cache.key("void f() {\nchar *p = malloc(10);\n}\n", "replay.c", ""));
+        AnalysisCache::Entry entry;
+        ASSERT_EQUALS(true, cache.load(key, entry));
+        ASSERT_EQUALS(1U, entry.messages.size());
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(ErrorLogger::ErrorMessage::FileLocation("replay.c", 1));
+        entry.messages.push_back(ErrorLogger::ErrorMessage(locs, Severity::style, "Cached message", "cached", false));
+        cache.store(key, entry);
+
+        errout.str("");
+        {
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings().cacheDir = dir.path();
+            cppCheck.check("replay.c", code);
+        }
+        ASSERT_EQUALS(uncached + "[replay.c:1]: (style) Cached message\n", errout.str());
+    }
+
+    void wholeProgram() {
+        // The file info for the whole program analysis is loaded from the cache
+        const char code[] = "void f() { }\n";
+        const CacheDir dir;
+        for (int i = 0; i < 2; ++i) {
+            errout.str("");
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings().cacheDir = dir.path();
+            cppCheck.settings().addEnabled("unusedFunction");
+            cppCheck.check("wholeProgram.c", code);
+            cppCheck.analyseWholeProgram();
+            ASSERT_EQUALS("[wholeProgram.c:1]: (style) The function 'f' is never used.\n", errout.str());
+
+            if (i == 0) {
+                const AnalysisCache cache(dir.path(), cppCheck.settings());
+                const std::string key = cache.key("void f() { }\n", "wholeProgram.c", "");
+                AnalysisCache::Entry entry;
+                ASSERT_EQUALS(true, cache.load(key, entry));
+                ASSERT_EQUALS("16 Unused functions21 d 1 f wholeProgram.c\n", entry.fileInfo);
+            }
+        }
+    }
+};
+
+REGISTER_TEST(TestAnalysisCache)
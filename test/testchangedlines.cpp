@@ -0,0 +1,125 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "changedlines.h"
+#include "testsuite.h"
+
+#include <sstream>
+
+class TestChangedLines : public TestFixture {
+public:
+    TestChangedLines() : TestFixture("TestChangedLines") {
+    }
+
+private:
+
+    void run() {
+        TEST_CASE(parseDiff);
+        TEST_CASE(parseDiffRemovedLines);
+        TEST_CASE(parseDiffInvalid);
+        TEST_CASE(fileNames);
+    }
+
+    void parseDiff() const {
+        std::istringstream istr("diff --git a/src/a.c b/src/a.c\n"
+                                "index 1234567..89abcde 100644\n"
+                                "--- a/src/a.c\n"
+                                "+++ b/src/a.c\n"
+                                "@@ -10,3 +10,4 @@ void f()\n"
+                                " {\n"
+                                "+    x = 1;\n"
+                                "-- removed line that starts with --\n"
+                                "+++ added line that starts with ++\n"
+                                " }\n"
+                                "@@ -40 +41 @@\n"
+                                "-a\n"
+                                "+b\n"
+                                "--- /dev/null\n"
+                                "+++ b/src/new.h\n"
+                                "@@ -0,0 +1,2 @@\n"
+                                "+int x;\n"
+                                "+int y;\n"
+                                "--- a/src/old.h\n"
+                                "+++ /dev/null\n"
+                                "@@ -1 +0,0 @@\n"
+                                "-int z;\n");
+        ChangedLines changedLines;
+        ASSERT_EQUALS("", changedLines.parseDiff(istr));
+
+        ASSERT_EQUALS(true, changedLines.hasFile("src/a.c"));
+        ASSERT_EQUALS(false, changedLines.overlaps("src/a.c", 1, 10));
+        ASSERT_EQUALS(true, changedLines.overlaps("src/a.c", 11, 11));
+        ASSERT_EQUALS(true, changedLines.overlaps("src/a.c", 12, 12));
+        ASSERT_EQUALS(false, changedLines.overlaps("src/a.c", 14, 39));
+        ASSERT_EQUALS(true, changedLines.overlaps("src/a.c", 41, 41));
+        ASSERT_EQUALS(false, changedLines.overlaps("src/a.c", 43, 100));
+
+        ASSERT_EQUALS(true, changedLines.overlaps("src/new.h", 2, 2));
+        ASSERT_EQUALS(false, changedLines.hasFile("src/old.h"));
+        ASSERT_EQUALS(false, changedLines.hasFile("/dev/null"));
+    }
+
+    void parseDiffRemovedLines() const {
+        // The lines around removed lines are changed
+        std::istringstream istr("--- a.c\n"
+                                "+++ a.c\n"
+                                "@@ -5,2 +4,0 @@\n"
+                                "-int a;\n"
+                                "-int b;\n");
+        ChangedLines changedLines;
+        ASSERT_EQUALS("", changedLines.parseDiff(istr));
+        ASSERT_EQUALS(false, changedLines.overlaps("a.c", 1, 3));
+        ASSERT_EQUALS(true, changedLines.overlaps("a.c", 4, 4));
+        ASSERT_EQUALS(true, changedLines.overlaps("a.c", 5, 5));
+        ASSERT_EQUALS(false, changedLines.overlaps("a.c", 6, 10));
+    }
+
+    void parseDiffInvalid() const {
+        std::istringstream istr1("+++ a.c\n"
+                                 "@@ -a +1 @@\n");
+        ChangedLines changedLines1;
+        ASSERT_EQUALS("seccheck: error: invalid hunk header in diff: '@@ -a +1 @@'.", changedLines1.parseDiff(istr1));
+
+        std::istringstream istr2("+++ a.c\n"
+                                 "@@ -1,2 +1,2 @@\n"
+                                 " a\n"
+                                 "?b\n");
+        ChangedLines changedLines2;
+        ASSERT_EQUALS("seccheck: error: unexpected line in diff hunk: '?b'.", changedLines2.parseDiff(istr2));
+    }
+
+    void fileNames() const {
+        ChangedLines changedLines;
+        ASSERT_EQUALS(true, changedLines.empty());
+        changedLines.add("src/./a.c", 3, 5);
+        ASSERT_EQUALS(false, changedLines.empty());
+        ASSERT_EQUALS(true, changedLines.overlaps("src/a.c", 5, 8));
+        ASSERT_EQUALS(true, changedLines.overlaps("/home/user/project/src/a.c", 1, 3));
+        ASSERT_EQUALS(true, changedLines.overlaps("a.c", 4, 4));
+        ASSERT_EQUALS(false, changedLines.hasFile("xa.c"));
+        ASSERT_EQUALS(false, changedLines.hasFile("b.c"));
+
+        ChangedLines other;
+        other.add(changedLines);
+        other.add("b.c", 1, 1);
+        ASSERT_EQUALS(true, other.overlaps("src/a.c", 4, 4));
+        ASSERT_EQUALS(true, other.hasFile("b.c"));
+    }
+};
+
+REGISTER_TEST(TestChangedLines)
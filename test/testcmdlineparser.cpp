@@ -85,9 +85,20 @@ private:
         TEST_CASE(fileList); // TODO: Create and test real file listing file
         // TEST_CASE(fileListStdin);  // Disabled since hangs the test run
         TEST_CASE(inlineSuppr);
+        TEST_CASE(cacheDir);
+        TEST_CASE(cacheDirMissing);
+        TEST_CASE(diffMissing);
         TEST_CASE(jobs);
         TEST_CASE(jobsMissingCount);
         TEST_CASE(jobsInvalid);
+        TEST_CASE(executorThread);
+        TEST_CASE(executorInvalid);
+        TEST_CASE(configJobs);
+        TEST_CASE(configJobsInvalid);
+        TEST_CASE(symbolDatabaseJobs);
+        TEST_CASE(symbolDatabaseJobsInvalid);
+        TEST_CASE(templateCacheSize);
+        TEST_CASE(templateCacheSizeInvalid);
         TEST_CASE(maxConfigs);
         TEST_CASE(maxConfigsMissingCount);
         TEST_CASE(maxConfigsInvalid);
@@ -616,6 +627,29 @@ private:
         ASSERT(defParser.ParseFromArgs(3, argv));
     }
 
+    void cacheDir() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--cache-dir=cache", "file.cpp"};
+        settings.cacheDir.clear();
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("cache", settings.cacheDir);
+    }
+
+    void cacheDirMissing() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--cache-dir=", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.ParseFromArgs(3, argv));
+    }
+
+    void diffMissing() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--diff=missing.diff", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("seccheck: Couldn't open the file: \"missing.diff\".\n", GET_REDIRECT_OUTPUT);
+    }
+
     void jobs() {
         REDIRECT;
         const char *argv[] = {"seccheck", "-j", "3", "file.cpp"};
@@ -640,6 +674,78 @@ private:
         ASSERT_EQUALS(false, defParser.ParseFromArgs(4, argv));
     }
 
+    void executorThread() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "-j2", "--executor=thread", "file.cpp"};
+        settings._executor = Settings::Process;
+        ASSERT(defParser.ParseFromArgs(4, argv));
+        ASSERT_EQUALS(Settings::Thread, settings._executor);
+        settings._executor = Settings::Process;
+    }
+
+    void executorInvalid() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--executor=fiber", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.ParseFromArgs(3, argv));
+    }
+
+    void configJobs() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--config-jobs=4", "file.cpp"};
+        settings._configJobs = 1;
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS(4U, settings._configJobs);
+        settings._configJobs = 1;
+    }
+
+    void configJobsInvalid() {
+        REDIRECT;
+        const char *argv1[] = {"seccheck", "--config-jobs=e", "file.cpp"};
+        CmdLineParser parser1(&settings);
+        ASSERT_EQUALS(false, parser1.ParseFromArgs(3, argv1));
+        const char *argv2[] = {"seccheck", "--config-jobs=0", "file.cpp"};
+        CmdLineParser parser2(&settings);
+        ASSERT_EQUALS(false, parser2.ParseFromArgs(3, argv2));
+        settings._configJobs = 1;
+    }
+
+    void symbolDatabaseJobs() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--symboldatabase-jobs=4", "file.cpp"};
+        settings._symbolDatabaseJobs = 1;
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS(4U, settings._symbolDatabaseJobs);
+        settings._symbolDatabaseJobs = 1;
+    }
+
+    void symbolDatabaseJobsInvalid() {
+        REDIRECT;
+        const char *argv1[] = {"seccheck", "--symboldatabase-jobs=e", "file.cpp"};
+        CmdLineParser parser1(&settings);
+        ASSERT_EQUALS(false, parser1.ParseFromArgs(3, argv1));
+        const char *argv2[] = {"seccheck", "--symboldatabase-jobs=0", "file.cpp"};
+        CmdLineParser parser2(&settings);
+        ASSERT_EQUALS(false, parser2.ParseFromArgs(3, argv2));
+        settings._symbolDatabaseJobs = 1;
+    }
+
+    void templateCacheSize() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--template-cache-size=0", "file.cpp"};
+        settings._templateCacheSize = 500000;
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS(0U, settings._templateCacheSize);
+        settings._templateCacheSize = 500000;
+    }
+
+    void templateCacheSizeInvalid() {
+        REDIRECT;
+        const char *argv[] = {"seccheck", "--template-cache-size=e", "file.cpp"};
+        CmdLineParser parser(&settings);
+        ASSERT_EQUALS(false, parser.ParseFromArgs(3, argv));
+    }
+
     void maxConfigs() {
         REDIRECT;
         const char *argv[] = {"seccheck", "-f", "--max-configs=12", "file.cpp"};
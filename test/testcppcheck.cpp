@@ -53,6 +53,12 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(configJobs);
+        TEST_CASE(configJobsUnusedFunction);
+        TEST_CASE(simplifiedCheckOrder);
+        TEST_CASE(duplicateConfigs);
+        TEST_CASE(duplicateConfigsMaxConfigs);
+        TEST_CASE(diff);
     }
 
     void instancesSorted() const {
@@ -95,6 +101,133 @@ private:
         }
         ASSERT_EQUALS("", duplicate);
     }
+
+    std::string checkConfigs(const char code[], unsigned int configJobs) {
+        errout.str("");
+        CppCheck cppCheck(*this, true);
+        cppCheck.settings()._force = true;
+        cppCheck.settings()._configJobs = configJobs;
+        cppCheck.check("test.c", code);
+        return errout.str();
+    }
+
+    void configJobs() {
+        // Checking configurations in parallel gives the same output as checking them one by one
+        const char code[] = "#ifdef A\n"
+                            "void a() { char *p = malloc(10); }\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "void b() { int buf[2]; buf[2] = 0; }\n"
+                            "#endif\n"
+                            "#if defined(A) && defined(B)\n"
+                            "void c() { int *p = 0; *p = 0; }\n"
+                            "#endif\n"
+                            "void d() { char *q = malloc(10); }\n";
+        const std::string serial = checkConfigs(code, 1);
+        ASSERT(!serial.empty());
+        ASSERT_EQUALS(serial, checkConfigs(code, 4));
+        ASSERT_EQUALS(serial, checkConfigs(code, 2));
+    }
+
+    void configJobsUnusedFunction() {
+        // Each configuration thread collects the functions of its own configuration
+        const char code[] = "#ifdef A\n"
+                            "static void a() {}\n"
+                            "#else\n"
+                            "static void b() {}\n"
+                            "#endif\n"
+                            "static void c() { }\n"
+                            "int main() { c(); return 0; }\n";
+        for (unsigned int configJobs = 1; configJobs <= 2; ++configJobs) {
+            errout.str("");
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings()._configJobs = configJobs;
+            cppCheck.settings().addEnabled("unusedFunction");
+            cppCheck.check("test.c", code);
+            cppCheck.analyseWholeProgram();
+            ASSERT_EQUALS("[test.c:2]: (style) The function 'a' is never used.\n"
+                          "[test.c:4]: (style) The function 'b' is never used.\n", errout.str());
+        }
+    }
+
+    void simplifiedCheckOrder() {
+        // The messages of the checks that are run by the TokenDispatcher are
+        // reported in the order of the checks, as the other checks
+        const char code[] = "void f() {\n"
+                            "    gets(s);\n"
+                            "    localtime(t);\n"
+                            "    char *p = malloc(10);\n"
+                            "}\n";
+        errout.str("");
+        CppCheck cppCheck(*this, true);
+        cppCheck.settings().addEnabled("style");
+        cppCheck.settings().addEnabled("portability");
+        cppCheck.settings().standards.posix = true;
+        cppCheck.check("test.c", code);
+        ASSERT_EQUALS("[test.c:4]: (style) Variable 'p' is allocated memory that is never used.\n"
+                      "[test.c:5]: (error) Memory leak: p\n"
+                      "[test.c:3]: (portability) Non reentrant function 'localtime' called. For threadsafe applications it is recommended to use the reentrant replacement function 'localtime_r'.\n"
+                      "[test.c:2]: (style) Obsolete function 'gets' called. It is recommended to use the function 'fgets' instead.\n", errout.str());
+    }
+
+    void duplicateConfigs() {
+        // A configuration that has the same code as a previous one is not checked
+        const char code[] = "#ifdef A\n"
+                            "#endif\n"
+                            "void d() { char *q = malloc(10); }\n";
+        for (unsigned int configJobs = 1; configJobs <= 2; ++configJobs) {
+            errout.str("");
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings()._configJobs = configJobs;
+            cppCheck.settings()._verbose = true;
+            cppCheck.settings().addEnabled("information");
+            cppCheck.check("test.c", code);
+            ASSERT_EQUALS("[test.c:3]: (error) Memory leak: q\n"
+                          "[test.c]: (information) The configuration 'A' was not checked because its code equals another one.\n", errout.str());
+        }
+    }
+
+    void duplicateConfigsMaxConfigs() {
+        // A configuration with duplicate code does not count toward --max-configs
+        const char code[] = "#ifdef A\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "void d() { char *q = malloc(10); }\n"
+                            "#endif\n";
+        for (unsigned int configJobs = 1; configJobs <= 2; ++configJobs) {
+            errout.str("");
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings()._configJobs = configJobs;
+            cppCheck.settings()._maxConfigs = 2;
+            cppCheck.check("test.c", code);
+            ASSERT_EQUALS("[test.c:4]: (error) Memory leak: q\n", errout.str());
+        }
+    }
+
+    void diff() {
+        const char code[] = "void a() { char *p = malloc(10); }\n"
+                            "void b() {\n"
+                            "    char *q = malloc(10);\n"
+                            "}\n";
+
+        // Only the changed function is checked
+        errout.str("");
+        {
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings()._changedLines.add("src/test.c", 3, 3);
+            cppCheck.check("test.c", code);
+        }
+        ASSERT_EQUALS("[test.c:4]: (error) Memory leak: q\n", errout.str());
+
+        // Files without changes are not checked
+        errout.str("");
+        {
+            CppCheck cppCheck(*this, true);
+            cppCheck.settings()._changedLines.add("other.c", 1, 10);
+            cppCheck.check("test.c", code);
+        }
+        ASSERT_EQUALS("", errout.str());
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
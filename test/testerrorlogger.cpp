@@ -37,6 +37,7 @@ private:
         TEST_CASE(ErrorMessageConstructLocations);
         TEST_CASE(ErrorMessageVerbose);
         TEST_CASE(ErrorMessageVerboseLocations);
+        TEST_CASE(ErrorMessageHash);
         TEST_CASE(CustomFormat);
         TEST_CASE(CustomFormat2);
         TEST_CASE(CustomFormatLocations);
@@ -114,6 +115,34 @@ private:
         ASSERT_EQUALS("[foo.cpp:5] -> [bar.cpp:8]: (error) Verbose error", msg.toString(true));
     }
 
+    void ErrorMessageHash() const {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs;
+        locs.push_back(fooCpp5);
+        locs.push_back(barCpp8);
+        const ErrorMessage msg(locs, Severity::error, "Programming error.\nVerbose error", "errorId", false);
+
+        // Messages that are formatted the same way have the same hash
+        const ErrorMessage otherId(locs, Severity::error, "Programming error.\nOther verbose error", "otherId", false);
+        ASSERT(msg.hash(false) == otherId.hash(false));
+        ASSERT(msg.hash(true) != otherId.hash(true));
+        ASSERT(msg.hash(false) != msg.hash(true));
+
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs2(locs);
+        locs2.front().setfile("sub/foo.cpp");
+        const ErrorMessage msg2(locs2, Severity::error, "Programming error.", "errorId", false);
+        locs2.front() = ErrorLogger::ErrorMessage::FileLocation("sub\\foo.cpp", 5);
+        const ErrorMessage msg3(locs2, Severity::error, "Programming error.", "errorId", false);
+        ASSERT(msg.hash(false) != msg2.hash(false));
+        ASSERT(msg2.hash(false) == msg3.hash(false));
+
+        locs2.front().line = 6;
+        ASSERT(msg3.hash(false) != ErrorMessage(locs2, Severity::error, "Programming error.", "errorId", false).hash(false));
+        locs2.pop_back();
+        ASSERT(msg3.hash(false) != ErrorMessage(locs2, Severity::error, "Programming error.", "errorId", false).hash(false));
+        ASSERT(msg.hash(false) != ErrorMessage(locs, Severity::warning, "Programming error.", "errorId", false).hash(false));
+        ASSERT(msg.hash(false) != ErrorMessage(locs, Severity::error, "Programming error.", "errorId", true).hash(false));
+    }
+
     void CustomFormat() const {
         std::list<ErrorLogger::ErrorMessage::FileLocation> locs(1, fooCpp5);
         ErrorMessage msg(locs, Severity::error, "Programming error.\nVerbose error", "errorId", false);
@@ -4,11 +4,13 @@ INCLUDEPATH += ../externals/tinyxml
 
 
 SOURCES += $${BASEPATH}/test64bit.cpp \
+           $${BASEPATH}/testanalysiscache.cpp \
            $${BASEPATH}/testassert.cpp \
            $${BASEPATH}/testautovariables.cpp \
            $${BASEPATH}/testbool.cpp \
            $${BASEPATH}/testboost.cpp \
            $${BASEPATH}/testbufferoverrun.cpp \
+           $${BASEPATH}/testchangedlines.cpp \
            $${BASEPATH}/testcharvar.cpp \
            $${BASEPATH}/testclass.cpp \
            $${BASEPATH}/testcmdlineparser.cpp \
@@ -49,6 +51,7 @@ SOURCES += $${BASEPATH}/test64bit.cpp \
            $${BASEPATH}/testthreadexecutor.cpp \
            $${BASEPATH}/testtimer.cpp \
            $${BASEPATH}/testtoken.cpp \
+           $${BASEPATH}/testtokendispatcher.cpp \
            $${BASEPATH}/testtokenize.cpp \
            $${BASEPATH}/testtype.cpp \
            $${BASEPATH}/testuninitvar.cpp \
@@ -39,6 +39,7 @@ private:
         TEST_CASE(memory2); // define extra "free" allocation functions
         TEST_CASE(resource);
         TEST_CASE(podtype);
+        TEST_CASE(markup);
         TEST_CASE(version);
     }
 
@@ -276,6 +277,49 @@ private:
         ASSERT_EQUALS(0,    type ? type->sign : '?');
     }
 
+    void markup() const {
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <markup ext=\".qml\" reporterrors=\"false\" aftercode=\"true\">\n"
+                               "    <keywords>\n"
+                               "      <keyword name=\"if\"/>\n"
+                               "    </keywords>\n"
+                               "    <codeblocks>\n"
+                               "      <block name=\"onClicked\"/>\n"
+                               "      <structure offset=\"3\" start=\"{\" end=\"}\"/>\n"
+                               "    </codeblocks>\n"
+                               "    <imported>\n"
+                               "      <importer>connect</importer>\n"
+                               "    </imported>\n"
+                               "  </markup>\n"
+                               "</def>";
+        tinyxml2::XMLDocument doc;
+        doc.Parse(xmldata, sizeof(xmldata));
+
+        Library library;
+        library.load(doc);
+
+        const Library::FileView qml = library.fileView("dir/Main.QML");
+        ASSERT_EQUALS(true, qml.markupFile());
+        ASSERT_EQUALS(false, qml.reportErrors());
+        ASSERT_EQUALS(true, qml.processMarkupAfterCode());
+        ASSERT_EQUALS(true, qml.isexecutableblock("onClicked"));
+        ASSERT_EQUALS(3, qml.blockstartoffset());
+        ASSERT_EQUALS("{", qml.blockstart());
+        ASSERT_EQUALS("}", qml.blockend());
+        ASSERT_EQUALS(true, qml.iskeyword("if"));
+        ASSERT_EQUALS(false, qml.iskeyword("while"));
+        ASSERT_EQUALS(true, qml.isimporter("connect"));
+
+        const Library::FileView cpp = library.fileView("main.cpp");
+        ASSERT_EQUALS(false, cpp.markupFile());
+        ASSERT_EQUALS(true, cpp.reportErrors());
+        ASSERT_EQUALS(false, cpp.isexecutableblock("onClicked"));
+        ASSERT_EQUALS(-1, cpp.blockstartoffset());
+        ASSERT_EQUALS(false, cpp.iskeyword("if"));
+        ASSERT_EQUALS(false, cpp.isimporter("connect"));
+    }
+
     void version() const {
         {
             const char xmldata [] = "<?xml version=\"1.0\"?>\n"
@@ -21,6 +21,8 @@
 #include "mathlib.h"
 #include "testsuite.h"
 
+#include <limits>
+
 class TestMathLib : public TestFixture {
 public:
     TestMathLib() : TestFixture("TestMathLib") {
@@ -55,6 +57,7 @@ private:
         TEST_CASE(tan);
         TEST_CASE(abs);
         TEST_CASE(toString);
+        TEST_CASE(value);
     }
 
     void isGreater() const {
@@ -985,6 +988,29 @@ private:
         // double (tailing l or L)
         ASSERT_EQUALS("0"     , MathLib::toString(+0.0l));
         ASSERT_EQUALS("-0"    , MathLib::toString(-0.0L));
+        // integers
+        ASSERT_EQUALS("-9223372036854775808", MathLib::toString(std::numeric_limits<MathLib::bigint>::min()));
+        ASSERT_EQUALS("18446744073709551615", MathLib::toString(std::numeric_limits<MathLib::biguint>::max()));
+    }
+
+    void value() const {
+        ASSERT_EQUALS(true, MathLib::value("0x10UL").isInt());
+        ASSERT_EQUALS(16, MathLib::value("0x10UL").getIntValue());
+        ASSERT_EQUALS(8, MathLib::value("010").getIntValue());
+        ASSERT_EQUALS(-5, MathLib::value("-5").getIntValue());
+        ASSERT_EQUALS(false, MathLib::value("1.5").isInt());
+        ASSERT_EQUALS("1.5", MathLib::value("1.5").str());
+
+        // same results as MathLib::calculate()
+        ASSERT_EQUALS("24", MathLib::value::calc('+', MathLib::value("0x10"), MathLib::value("010")).str());
+        ASSERT_EQUALS("-1", MathLib::value::calc('-', MathLib::value("1"), MathLib::value("2")).str());
+        ASSERT_EQUALS("3", MathLib::value::calc('/', MathLib::value("7"), MathLib::value("2")).str());
+        ASSERT_EQUALS("6", MathLib::value::calc('^', MathLib::value("3"), MathLib::value("5")).str());
+        ASSERT_EQUALS("3.5", MathLib::value::calc('/', MathLib::value("7"), MathLib::value("2.0")).str());
+        ASSERT_EQUALS("1.00000001", MathLib::value::calc('+', MathLib::value("1"), MathLib::value("0.00000001")).str());
+        ASSERT_THROW(MathLib::value::calc('/', MathLib::value("1"), MathLib::value("0")), InternalError);
+        ASSERT_THROW(MathLib::value::calc('%', MathLib::value("1"), MathLib::value("0")), InternalError);
+        ASSERT_THROW(MathLib::value::calc('j', MathLib::value("1"), MathLib::value("2")), InternalError);
     }
 };
 
@@ -253,6 +253,7 @@ private:
         TEST_CASE(allocfunc11);
         TEST_CASE(allocfunc12); // #3660: allocating and returning non-local pointer => not allocfunc
         TEST_CASE(allocfunc13); // Ticket #4494 and #4540 - class function
+        TEST_CASE(allocfunc14); // return type of function is reused for all calls
 
         TEST_CASE(throw1);
         TEST_CASE(throw2);
@@ -2813,6 +2814,23 @@ private:
         ASSERT_EQUALS("[test.cpp:11]: (error) Memory leak: a\n", errout.str());
     }
 
+    void allocfunc14() {
+        check("char *a() { return malloc(100); }\n"
+              "char *b() { return a(); }\n"
+              "void c() {\n"
+              "    char *x = b();\n"
+              "    char *y = a();\n"
+              "    char *z = b();\n"
+              "    free(y);\n"
+              "}\n"
+              "void d() {\n"
+              "    char *x = b();\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:8]: (error) Memory leak: x\n"
+                      "[test.cpp:8]: (error) Memory leak: z\n"
+                      "[test.cpp:11]: (error) Memory leak: x\n", errout.str());
+    }
+
     void throw1() {
         check("void foo()\n"
               "{\n"
@@ -22,11 +22,14 @@
 
 
 #include "testsuite.h"
+#include "headercache.h"
 #include "preprocessor.h"
 #include "tokenize.h"
 #include "token.h"
 #include "settings.h"
 
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 #include <sstream>
@@ -71,6 +74,7 @@ private:
         TEST_CASE(readCode2); // #4308 - convert C++11 raw string to plain old C string
         TEST_CASE(readCode3);
         TEST_CASE(readCode4); // #4351 - escaped whitespace in gcc
+        TEST_CASE(cleanupDirectives);
 
         // reading utf-16 file
         TEST_CASE(utf16);
@@ -182,6 +186,8 @@ private:
         TEST_CASE(macro_simple16);  // #4703: Macro parameters not trimmed
         TEST_CASE(macro_simple17);  // #5074: isExpandedMacro not set
         TEST_CASE(macro_simple18);  // (1e-7)
+        TEST_CASE(macro_multiline_statement);
+        TEST_CASE(macro_shared_definitions);
         TEST_CASE(macroInMacro1);
         TEST_CASE(macroInMacro2);
         TEST_CASE(macro_mismatch);
@@ -300,6 +306,7 @@ private:
         TEST_CASE(if_sizeof);
 
         TEST_CASE(double_include); // #5717
+        TEST_CASE(headerCache);
         TEST_CASE(invalid_ifs)// #5909
     }
 
@@ -343,6 +350,23 @@ private:
     }
 
 
+    void cleanupDirectives() {
+        // single pass cleanup is the same as the separate passes
+        const char * const code[] = {
+            "  #if( A )  \nx  \n#elif ((B))\n#endif",
+            "#ifdef A\n  #  define  X  ( 1 )\n#endif\n",
+            "#define S \"  #if (\"\na ( b );",
+            "",
+            "a\n\n  b"
+        };
+        for (std::size_t i = 0; i < sizeof(code) / sizeof(code[0]); ++i) {
+            ASSERT_EQUALS(Preprocessor::removeParentheses(Preprocessor::preprocessCleanupDirectives(code[i])),
+                          Preprocessor::cleanupDirectives(code[i], true));
+        }
+        ASSERT_EQUALS("#if A\nx\n#elif B\n#endif\n", Preprocessor::cleanupDirectives(code[0], true));
+        ASSERT_EQUALS("#if ( A )\nx\n#elif ((B))\n#endif", Preprocessor::cleanupDirectives(code[0], false));
+    }
+
     void utf16() {
         Settings settings;
         Preprocessor preprocessor(&settings, this);
@@ -1247,6 +1271,20 @@ private:
             ASSERT_EQUALS(false, preprocessor.match_cfg_def(cfg, "A>=1&&B<=A"));
             ASSERT_EQUALS(true, preprocessor.match_cfg_def(cfg, "A==1 && A==1"));
         }
+
+        {
+            // remembered results are used only if the used macros have the same values
+            std::map<std::string, std::string> cfg;
+            cfg["A"] = "B";
+            cfg["B"] = "1";
+            cfg["C"] = "";
+            ASSERT_EQUALS(true, preprocessor.match_cfg_def(cfg, "A==1"));
+            cfg["C"] = "2";
+            ASSERT_EQUALS(true, preprocessor.match_cfg_def(cfg, "A==1"));
+            cfg["B"] = "2";
+            ASSERT_EQUALS(false, preprocessor.match_cfg_def(cfg, "A==1"));
+            ASSERT_EQUALS(true, preprocessor.match_cfg_def(cfg, "A==C"));
+        }
     }
 
 
@@ -2028,6 +2066,34 @@ private:
         ASSERT_EQUALS("\na=$($8.0E+007);", OurPreprocessor::expandMacros(filedata8));
     }
 
+    void macro_multiline_statement() {
+        // a long statement is expanded line by line, macro calls that span lines are kept together
+        const char filedata[] = "#define F(x) x+1\n"
+                                "int a[] = {\n"
+                                "F(1),\n"
+                                "F(2),\n"
+                                "\n"
+                                "F(\n"
+                                "3)\n"
+                                "};\n";
+        ASSERT_EQUALS("\nint a[] = {\n$1+$1,\n$2+$1,\n\n$\n$3+$1\n};\n", OurPreprocessor::expandMacros(filedata));
+    }
+
+    void macro_shared_definitions() {
+        // the macros are parsed once and used by all configurations
+        const char filedata[] = "#ifdef A\n"
+                                "#define X(a) a+1\n"
+                                "#else\n"
+                                "#define X(a) a+2\n"
+                                "#endif\n"
+                                "X(0);\n";
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+        ASSERT_EQUALS("\n\n\n\n\n$0+$1;\n", preprocessor.getcode(filedata, "A", "file.c"));
+        ASSERT_EQUALS("\n\n\n\n\n$0+$2;\n", preprocessor.getcode(filedata, "", "file.c"));
+        ASSERT_EQUALS("\n\n\n\n\n$0+$1;\n", preprocessor.getcode(filedata, "A", "file.c"));
+    }
+
     void macroInMacro1() {
         {
             const char filedata[] = "#define A(m) long n = m; n++;\n"
@@ -4052,6 +4118,55 @@ private:
         preprocessor.handleIncludes(code, "123.h", includePaths, defs, pragmaOnce, std::list<std::string>());
     }
 
+    void headerCache() {
+        const std::string header("headercache_test.h");
+        {
+            std::ofstream fout(header.c_str());
+            fout << "int x; // comment\n";
+        }
+        HeaderCache::instance().clear();
+
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+        const std::list<std::string> includePaths;
+        std::map<std::string,std::string> defs;
+        std::set<std::string> pragmaOnce;
+        const std::string code("#include \"" + header + "\"\n");
+        const std::string expected("#file \"" + header + "\"\nint x;\n\n#endfile\n");
+        ASSERT_EQUALS(expected, preprocessor.handleIncludes(code, "test.c", includePaths, defs, pragmaOnce, std::list<std::string>()));
+
+        // The cleaned header is cached
+        HeaderCache::Stamp stamp;
+        ASSERT_EQUALS(true, HeaderCache::stamp(header, stamp));
+        std::string cached;
+        ASSERT_EQUALS(true, HeaderCache::instance().get(header, stamp, 0, cached));
+        ASSERT_EQUALS("int x;\n", cached);
+        ASSERT_EQUALS(false, HeaderCache::instance().get(header, stamp, HeaderCache::CHECK_CONFIGURATION, cached));
+        ASSERT_EQUALS(expected, preprocessor.handleIncludes(code, "test.c", includePaths, defs, pragmaOnce, std::list<std::string>()));
+
+        // The entry is not used when the file has changed
+        HeaderCache::Stamp changed(stamp);
+        ++changed.size;
+        ASSERT_EQUALS(false, HeaderCache::instance().get(header, changed, 0, cached));
+
+        // Headers with inline suppressions are read every time
+        {
+            std::ofstream fout(header.c_str());
+            fout << "// seccheck-suppress abc\nint y;\n";
+        }
+        HeaderCache::instance().clear();
+        preprocessor.handleIncludes(code, "test.c", includePaths, defs, pragmaOnce, std::list<std::string>());
+        ASSERT_EQUALS(0U, settings.nomsg.getUnmatchedLocalSuppressions(header, false).size());
+        settings._inlineSuppressions = true;
+        preprocessor.handleIncludes(code, "test.c", includePaths, defs, pragmaOnce, std::list<std::string>());
+        ASSERT_EQUALS(1U, settings.nomsg.getUnmatchedLocalSuppressions(header, false).size());
+        ASSERT_EQUALS(true, HeaderCache::stamp(header, stamp));
+        ASSERT_EQUALS(false, HeaderCache::instance().get(header, stamp, HeaderCache::INLINE_SUPPRESSIONS, cached));
+
+        HeaderCache::instance().clear();
+        std::remove(header.c_str());
+    }
+
     void invalid_ifs()  {
         const char filedata[] = "#ifdef\n"
                                 "#endif\n"
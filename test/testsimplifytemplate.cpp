@@ -91,6 +91,8 @@ private:
         TEST_CASE(template_default_type);
         TEST_CASE(template_typename);
         TEST_CASE(template_constructor);    // #3152 - template constructor is removed
+        TEST_CASE(template_expansionCache);
+        TEST_CASE(template_expansionCacheCollision);
 
         // Test TemplateSimplifier::templateParameters
         TEST_CASE(templateParameters);
@@ -1083,6 +1085,69 @@ private:
         ASSERT_EQUALS("class Fred { template < class T > Fred ( T t ) { } }", tok(code2));
     }
 
+    std::string tok(const char code[], TemplateExpansionCache &cache) {
+        errout.str("");
+
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        tokenizer.setTemplateExpansionCache(&cache);
+
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        tokenizer.simplifyTokenList2();
+
+        return tokenizer.tokens()->stringifyList(0, false);
+    }
+
+    void template_expansionCache() {
+        const char code[] = "template<class T> struct A {\n"
+                            "    T f() { return 1 + 2; }\n"
+                            "    B<T> b;\n"
+                            "};\n"
+                            "A<int> a1;\n"
+                            "A<long long> a2;";
+        const char expected[] = "A<int> a1 ; A<longlong> a2 ; "
+                                "struct A<int> { int f ( ) { return 3 ; } B < int > b ; } ; "
+                                "struct A<longlong> { long f ( ) { return 3 ; } B < long > b ; } ;";
+
+        TemplateExpansionCache cache;
+        ASSERT_EQUALS(expected, tok(code, cache));
+        ASSERT_EQUALS(2U, cache.size());
+
+        // same template => expansions are reused
+        ASSERT_EQUALS(expected, tok(code, cache));
+        ASSERT_EQUALS(2U, cache.size());
+
+        // changed template => not reused
+        const char code2[] = "template<class T> struct A {\n"
+                             "    T g() { return 1 + 2; }\n"
+                             "    B<T> b;\n"
+                             "};\n"
+                             "A<int> a1;";
+        ASSERT_EQUALS("A<int> a1 ; struct A<int> { int g ( ) { return 3 ; } B < int > b ; } ;", tok(code2, cache));
+        ASSERT_EQUALS(3U, cache.size());
+
+        // the least recently used expansions are removed when the cache is full
+        TemplateExpansionCache small(cache.tokens() - 1);
+        ASSERT_EQUALS(expected, tok(code, small));
+        ASSERT_EQUALS("A<int> a1 ; struct A<int> { int g ( ) { return 3 ; } B < int > b ; } ;", tok(code2, small));
+        ASSERT_EQUALS(2U, small.size());
+        ASSERT(small.tokens() < cache.tokens());
+        small.setMaxTokens(0);
+        ASSERT_EQUALS(0U, small.size());
+    }
+
+    void template_expansionCacheCollision() {
+        // An expansion is only used for the template text it was made from
+        TemplateExpansionCache cache;
+        std::shared_ptr<TemplateExpansionCache::Expansion> expansion(new TemplateExpansionCache::Expansion);
+        expansion->templateText.reset(new std::string("template < class T > struct A { } ;"));
+        const TemplateExpansionCache::Key key(1U, "A<int>");
+        cache.put(key, expansion);
+        ASSERT(cache.get(key, "template < class T > struct A { } ;") == expansion);
+        ASSERT(!cache.get(key, "template < class T > struct B { } ;"));
+    }
+
     unsigned int templateParameters(const char code[]) {
         Settings settings;
         Tokenizer tokenizer(&settings, this);
@@ -106,6 +106,26 @@ private:
             ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "abc.cpp", 1));
             ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "abc.cpp", 2));
         }
+
+        // Globs with a common prefix, the first matching glob is used
+        {
+            Suppressions suppressions;
+            std::istringstream s("errorid:src/*/a.c\nerrorid:src/*a*.c:3\nerrorid:src/b?/*.h\nerrorid:src/*.c:5");
+            ASSERT_EQUALS("", suppressions.parseFile(s));
+            ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "src/x/a.c", 1));
+            ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "src//a.c", 1));
+            ASSERT_EQUALS(false, suppressions.isSuppressed("errorid", "src/x/b.c", 1));
+            ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "src/bab.c", 3));
+            ASSERT_EQUALS(false, suppressions.isSuppressed("errorid", "src/bab.c", 4));
+            ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "src/b1/x/y.h", 1));
+            ASSERT_EQUALS(false, suppressions.isSuppressed("errorid", "src/b/x.h", 1));
+            ASSERT_EQUALS(1U, suppressions.getUnmatchedGlobalSuppressions(true).size());
+
+            // Globs that are added later are matched too
+            ASSERT_EQUALS("", suppressions.addSuppression("errorid", "*.cpp"));
+            ASSERT_EQUALS(true, suppressions.isSuppressed("errorid", "a.cpp", 1));
+            ASSERT_EQUALS("src/*.c", suppressions.getUnmatchedGlobalSuppressions(true).front().file);
+        }
     }
 
     void suppressionsFileNameWithExtraPath() const {
@@ -248,6 +248,9 @@ private:
         TEST_CASE(functionPrototype); // ticket #5867
 
         TEST_CASE(lambda); // ticket #5867
+
+        TEST_CASE(symbolDatabaseJobs);
+        TEST_CASE(findNestedByName);
     }
 
     void array() const {
@@ -2750,6 +2753,70 @@ private:
             ASSERT_EQUALS(Scope::eLambda, scope->type);
         }
     }
+
+    void findNestedByName() {
+        GET_SYMBOL_DB("namespace N {\n"
+                      "    void X() { }\n"
+                      "    struct X { int a; };\n"
+                      "    struct Y { int b; };\n"
+                      "}\n"
+                      "N::X x;\n");
+        ASSERT(db != nullptr);
+        if (!db)
+            return;
+        const Scope *ns = db->scopeList.front().findRecordInNestedList("N");
+        ASSERT(ns && ns->type == Scope::eNamespace);
+        if (!ns)
+            return;
+        const Scope *x = ns->findRecordInNestedList("X");
+        ASSERT(x && x->type == Scope::eStruct);
+        ASSERT(ns->findType("Y") && ns->findType("Y")->classScope == ns->findRecordInNestedList("Y"));
+        ASSERT(ns->findType("Z") == nullptr);
+        ASSERT(db->isClassOrStruct("Y"));
+        ASSERT(!db->isClassOrStruct("Z"));
+        const Token *xtok = Token::findsimplematch(tokenizer.tokens(), "x ;");
+        ASSERT(xtok && xtok->variable() && xtok->variable()->typeScope() == x);
+    }
+
+    // Describe the scope, function and variable of each token
+    std::string annotations(const char code[], unsigned int jobs) {
+        errout.str("");
+        Settings settings;
+        settings._symbolDatabaseJobs = jobs;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        std::ostringstream ret;
+        for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+            ret << tok->str();
+            if (tok->scope() && tok->scope()->classDef)
+                ret << " s:" << tok->scope()->classDef->linenr();
+            if (tok->function())
+                ret << " f:" << tok->function()->tokenDef->linenr();
+            if (tok->variable())
+                ret << " v:" << tok->variable()->nameToken()->linenr();
+            ret << '\n';
+        }
+        return ret.str();
+    }
+
+    void symbolDatabaseJobs() {
+        // Analysing the function bodies in threads gives the same result
+        std::string code = "struct A { int x; int get() { return x; } };\n"
+                           "A make();\n";
+        for (int i = 0; i < 20; ++i) {
+            const std::string n = MathLib::toString(i);
+            code += "int f" + n + "(A a, int y) {\n"
+                    "    A b = a;\n"
+                    "    if (y) { int z = b.x + make().x; return z; }\n"
+                    "    return f" + n + "(b, y - 1) + b.get();\n"
+                    "}\n";
+        }
+        const std::string serial = annotations(code.c_str(), 1);
+        ASSERT(serial.find(" f:") != std::string::npos);
+        ASSERT_EQUALS(serial, annotations(code.c_str(), 4));
+        ASSERT_EQUALS(serial, annotations(code.c_str(), 3));
+    }
 };
 
 REGISTER_TEST(TestSymbolDatabase)
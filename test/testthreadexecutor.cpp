@@ -23,6 +23,8 @@
 #include "cppcheckexecutor.h"
 
 #include <map>
+#include <set>
+#include <sstream>
 #include <string>
 
 extern std::ostringstream errout;
@@ -39,7 +41,7 @@ private:
      * Execute check using n jobs for y files which are have
      * identical data, given within data.
      */
-    void check(unsigned int jobs, int files, int result, const std::string &data) {
+    void check(unsigned int jobs, int files, int result, const std::string &data, Settings::ExecutorType executor = Settings::Process) {
         errout.str("");
         output.str("");
         if (!ThreadExecutor::isEnabled()) {
@@ -56,11 +58,12 @@ private:
 
         Settings settings;
         settings._jobs = jobs;
-        ThreadExecutor executor(filemap, settings, *this);
+        settings._executor = executor;
+        ThreadExecutor threadExecutor(filemap, settings, *this);
         for (auto i = filemap.begin(); i != filemap.end(); ++i)
-            executor.addFileContent(i->first, data);
+            threadExecutor.addFileContent(i->first, data);
 
-        ASSERT_EQUALS(result, executor.check());
+        ASSERT_EQUALS(result, threadExecutor.check());
     }
 
     void run() {
@@ -71,6 +74,10 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(largest_file_first);
+        TEST_CASE(threads_many_errors);
+        TEST_CASE(threads_one_error_several_files);
+        TEST_CASE(threads_whole_program);
     }
 
     void deadlock_with_many_errors() {
@@ -141,6 +148,92 @@ private:
             << "}\n";
         check(2, 20, 20, oss.str());
     }
+
+    void largest_file_first() {
+        output.str("");
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        std::map<std::string, std::size_t> filemap;
+        filemap["file_1.cpp"] = 10;
+        filemap["file_2.cpp"] = 30;
+        filemap["file_3.cpp"] = 20;
+        filemap["file_4.cpp"] = 20;
+
+        Settings settings;
+        settings._jobs = 1;
+        ThreadExecutor executor(filemap, settings, *this);
+        for (auto i = filemap.begin(); i != filemap.end(); ++i)
+            executor.addFileContent(i->first, "int x;");
+
+        ASSERT_EQUALS(0U, executor.check());
+        ASSERT_EQUALS("Checking file_2.cpp...\n"
+                      "Checking file_3.cpp...\n"
+                      "Checking file_4.cpp...\n"
+                      "Checking file_1.cpp...\n", output.str());
+    }
+
+    void threads_many_errors() {
+        std::ostringstream oss;
+        oss << "int main()\n"
+            << "{\n";
+        for (int i = 0; i < 500; i++)
+            oss << "  {char *a = malloc(10);}\n";
+
+        oss << "  return 0;\n"
+            << "}\n";
+        check(2, 3, 3, oss.str(), Settings::Thread);
+    }
+
+    void threads_one_error_several_files() {
+        std::ostringstream oss;
+        oss << "int main()\n"
+            << "{\n"
+            << "  {char *a = malloc(10);}\n"
+            << "  return 0;\n"
+            << "}\n";
+        check(4, 20, 20, oss.str(), Settings::Thread);
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        // Each file reports its leak once; the threads finish in any order
+        std::multiset<std::string> reported;
+        std::istringstream istr(errout.str());
+        std::string line;
+        while (std::getline(istr, line)) {
+            if (line.find("(error)") != std::string::npos)
+                reported.insert(line);
+        }
+        std::multiset<std::string> expected;
+        for (int i = 1; i <= 20; ++i) {
+            std::ostringstream msg;
+            msg << "[file_" << i << ".cpp:3]: (error) Memory leak: a";
+            expected.insert(msg.str());
+        }
+        ASSERT(expected == reported);
+    }
+
+    void threads_whole_program() {
+        errout.str("");
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        // The array is declared in one file and used in another file
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.c"] = 1;
+        filemap["b.c"] = 1;
+
+        Settings settings;
+        settings._jobs = 2;
+        settings._executor = Settings::Thread;
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.addFileContent("a.c", "int buf[10];");
+        executor.addFileContent("b.c", "extern int *buf;\n"
+                                "void f() { buf[20] = 0; }");
+
+        ASSERT_EQUALS(0U, executor.check());
+        ASSERT_EQUALS("[b.c:2]: (error) Array buf[10] accessed at index 20 which is out of bounds\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
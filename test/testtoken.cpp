@@ -19,6 +19,8 @@
 #include "testsuite.h"
 #include "testutils.h"
 #include "token.h"
+#include "tokenarena.h"
+#include "tokenlist.h"
 #include "settings.h"
 
 #include <vector>
@@ -52,6 +54,8 @@ private:
         TEST_CASE(strValue);
 
         TEST_CASE(deleteLast);
+        TEST_CASE(arena);
+        TEST_CASE(strId);
         TEST_CASE(nextArgument);
         TEST_CASE(eraseTokens);
 
@@ -299,6 +303,62 @@ private:
         ASSERT_EQUALS(true, tokensBack == &tok);
     }
 
+    void arena() const {
+        TokenArena arena(sizeof(Token));
+        Token *tokensBack = 0;
+        Token *tok = Token::create(&tokensBack, &arena);
+        tok->str("a");
+        tok->insertToken("b");
+        tok->next()->insertToken("c");
+        ASSERT_EQUALS(true, tok->next()->arena() == &arena);
+        ASSERT_EQUALS(true, tokensBack == tok->tokAt(2));
+        ASSERT_EQUALS(1U, arena.blocks());
+
+        // Deleted tokens are reused
+        const Token *deleted = tok->next();
+        tok->deleteNext();
+        tok->insertToken("d");
+        ASSERT_EQUALS(true, tok->next() == deleted);
+        ASSERT_EQUALS("d", tok->strAt(1));
+        ASSERT_EQUALS("c", tok->strAt(2));
+
+        // More tokens than fit in one block
+        for (std::size_t i = 0; i < TokenArena::SlotsPerBlock; ++i)
+            tokensBack->insertToken("x");
+        ASSERT_EQUALS(2U, arena.blocks());
+
+        TokenList::deleteTokens(tok);
+        arena.release();
+        ASSERT_EQUALS(0U, arena.blocks());
+    }
+
+    void strId() const {
+        Token tok(0);
+        ASSERT_EQUALS(TokenStrings::None, tok.strId());
+        tok.str("if");
+        ASSERT_EQUALS(TokenStrings::If, tok.strId());
+        tok.str("<<=");
+        ASSERT_EQUALS(TokenStrings::ShiftLeftAssign, tok.strId());
+        tok.str("foo");
+        ASSERT_EQUALS(TokenStrings::None, tok.strId());
+        tok.str("\"if\"");
+        ASSERT_EQUALS(TokenStrings::None, tok.strId());
+        ASSERT_EQUALS("while", TokenStrings::str(TokenStrings::While));
+        ASSERT_EQUALS("", TokenStrings::str(TokenStrings::None));
+
+        // The id follows the string when tokens are deleted and swapped
+        givenACodeSampleToTokenize example("a = b ;", true);
+        Token *first = const_cast<Token *>(example.tokens());
+        first->swapWithNext();
+        ASSERT_EQUALS(TokenStrings::Assign, first->strId());
+        ASSERT_EQUALS(TokenStrings::None, first->next()->strId());
+        first->deleteThis();
+        ASSERT_EQUALS("a", first->str());
+        ASSERT_EQUALS(TokenStrings::None, first->strId());
+        first->next()->deleteThis();
+        ASSERT_EQUALS(TokenStrings::Semicolon, first->next()->strId());
+    }
+
     void nextArgument() const {
         givenACodeSampleToTokenize example1("foo(1, 2, 3, 4);");
         ASSERT_EQUALS(true, Token::simpleMatch(example1.tokens()->tokAt(2)->nextArgument(), "2 , 3"));
@@ -0,0 +1,110 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tokendispatcher.h"
+#include "tokenize.h"
+#include "symboldatabase.h"
+#include "cppcheck.h"
+#include "testsuite.h"
+
+#include <sstream>
+
+extern std::ostringstream errout;
+
+class TestTokenDispatcher : public TestFixture {
+public:
+    TestTokenDispatcher() : TestFixture("TestTokenDispatcher") {
+    }
+
+private:
+
+    void run() {
+        TEST_CASE(dispatch);
+        TEST_CASE(functionScopesOnly);
+        TEST_CASE(singlePass);
+    }
+
+    void dispatch() {
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr("void f() { a(); b(); a(); }");
+        tokenizer.tokenize(istr, "test.cpp");
+
+        std::string calls;
+        TokenDispatcher dispatcher;
+        ASSERT_EQUALS(true, dispatcher.empty());
+        dispatcher.addTrigger("a", [&calls](const Token *tok) {
+            calls += "1" + tok->str() + tok->next()->str();
+        });
+        dispatcher.addTrigger("a", [&calls](const Token *tok) {
+            calls += "2" + tok->str();
+        });
+        dispatcher.addTrigger("b", [&calls](const Token *tok) {
+            calls += "3" + tok->str();
+        });
+        dispatcher.addTrigger("(", [&calls](const Token *) {
+            calls += "(";
+        });
+        ASSERT_EQUALS(false, dispatcher.empty());
+        dispatcher.dispatch(tokenizer.getSymbolDatabase());
+
+        // callbacks are called in the order they were added, only for names
+        ASSERT_EQUALS("1a(2a3b1a(2a", calls);
+    }
+
+    void functionScopesOnly() {
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr("int a;\n"
+                                "struct S { int a; };\n"
+                                "void f() { a = 0; }");
+        tokenizer.tokenize(istr, "test.cpp");
+
+        unsigned int count = 0;
+        TokenDispatcher dispatcher;
+        dispatcher.addTrigger("a", [this, &count](const Token *tok) {
+            ASSERT_EQUALS(3U, tok->linenr());
+            ++count;
+        });
+        dispatcher.dispatch(tokenizer.getSymbolDatabase());
+        ASSERT_EQUALS(1U, count);
+    }
+
+    void singlePass() {
+        // checks that register triggers report the same as when run separately
+        const char code[] = "void f(char *pwd) {\n"
+                            "    char *password = gets(0);\n"
+                            "    strcpy(password, pwd);\n"
+                            "    localtime(0);\n"
+                            "}\n";
+
+        errout.str("");
+        CppCheck cppCheck(*this, true);
+        cppCheck.settings().addEnabled("style");
+        cppCheck.settings().addEnabled("portability");
+        cppCheck.settings().standards.posix = true;
+        cppCheck.check("test.cpp", code);
+        const std::string messages = errout.str();
+        ASSERT(messages.find("[test.cpp:2]: (style) Obsolete function 'gets' called.") != std::string::npos);
+        ASSERT(messages.find("[test.cpp:2]: (style) Suspicious variable name: password") != std::string::npos);
+        ASSERT(messages.find("[test.cpp:3]: (style) Obsolete function 'strcpy' called.") != std::string::npos);
+        ASSERT(messages.find("[test.cpp:4]: (portability) Non reentrant function 'localtime' called.") != std::string::npos);
+    }
+};
+
+REGISTER_TEST(TestTokenDispatcher)
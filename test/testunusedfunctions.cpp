@@ -54,6 +54,7 @@ private:
         TEST_CASE(boost);
 
         TEST_CASE(multipleFiles);   // same function name in multiple files
+        TEST_CASE(wholeProgram);
 
         TEST_CASE(lineNumber); // Ticket 3059
 
@@ -365,6 +366,45 @@ private:
         ASSERT_EQUALS("[test1.cpp:1]: (style) The function 'f' is never used.\n", errout.str());
     }
 
+    void wholeProgram() {
+        CheckUnusedFunctions c;
+
+        Settings settings;
+        settings.addEnabled("unusedFunction");
+
+        // The file infos are serialized by the worker processes and they
+        // are merged in any order
+        const char * const code[] = {
+            "void f() { }\n"
+            "void g() { }\n",
+            "void h() { g(); }\n"
+            "void f() { }\n"
+        };
+        std::list<Check::FileInfo*> fileInfo;
+        for (int i = 1; i >= 0; --i) {
+            std::ostringstream fname;
+            fname << "test" << (i + 1) << ".cpp";
+
+            Tokenizer tokenizer(&settings, this);
+            std::istringstream istr(code[i]);
+            tokenizer.tokenize(istr, fname.str().c_str());
+
+            const Check::FileInfo *fi = c.getFileInfo(&tokenizer, &settings);
+            fileInfo.push_back(c.loadFileInfo(fi->toString()));
+            delete fi;
+        }
+
+        errout.str("");
+        c.analyseWholeProgram(fileInfo, *this);
+        while (!fileInfo.empty()) {
+            delete fileInfo.back();
+            fileInfo.pop_back();
+        }
+
+        ASSERT_EQUALS("[test1.cpp:1]: (style) The function 'f' is never used.\n"
+                      "[test2.cpp:1]: (style) The function 'h' is never used.\n", errout.str());
+    }
+
     void lineNumber() {
         check("void foo() {}\n"
               "void bar() {}\n"
@@ -62,6 +62,8 @@ private:
         TEST_CASE(valueFlowForLoop);
         TEST_CASE(valueFlowSubFunction);
         TEST_CASE(valueFlowFunctionReturn);
+
+        TEST_CASE(valueList);
     }
 
     bool testValueOfX(const char code[], unsigned int linenr, int value) {
@@ -81,7 +83,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                ValueFlow::ValueList::const_iterator it;
                 for (it = tok->values.begin(); it != tok->values.end(); ++it) {
                     if (it->intvalue == value && !it->tokvalue)
                         return true;
@@ -110,7 +112,7 @@ private:
 
         for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
             if (tok->str() == "x" && tok->linenr() == linenr) {
-                std::list<ValueFlow::Value>::const_iterator it;
+                ValueFlow::ValueList::const_iterator it;
                 for (it = tok->values.begin(); it != tok->values.end(); ++it) {
                     if (Token::simpleMatch(it->tokvalue, value))
                         return true;
@@ -139,7 +141,7 @@ private:
         errout.str("");
         tokenizer.tokenize(istr, "test.cpp");
         const Token *tok = Token::findmatch(tokenizer.tokens(), tokstr);
-        return tok ? tok->values : std::list<ValueFlow::Value>();
+        return tok ? std::list<ValueFlow::Value>(tok->values.begin(), tok->values.end()) : std::list<ValueFlow::Value>();
     }
 
     ValueFlow::Value valueOfTok(const char code[], const char tokstr[]) {
@@ -745,6 +747,21 @@ private:
                "}";
         ASSERT_EQUALS(false, testValueOfX(code, 4U, 33));
 
+        code = "void f() {\n"
+               "    int x = 32;\n"
+               "    if (a[0]==0) { b[x]=0; }\n"
+               "    c[x]=0;\n"
+               "}";
+        ASSERT_EQUALS(true, testValueOfX(code, 3U, 32));
+        ASSERT_EQUALS(true, testValueOfX(code, 4U, 32));
+
+        code = "void f() {\n"
+               "    int x = 32;\n"
+               "    if (x>=32 || getx()) return;\n"
+               "    b[x]=0;\n"
+               "}";
+        ASSERT_EQUALS(false, testValueOfX(code, 4U, 32));
+
         code = "void f() {\n"
                "    int x = 32;\n"
                "    if (a==1) { z=x+12; }\n"
@@ -1385,6 +1402,37 @@ private:
                "}";
         ASSERT_EQUALS(15, valueOfTok(code, "*").intvalue);
     }
+
+    void valueList() {
+        ValueFlow::ValueList values;
+        ASSERT_EQUALS(true, values.empty());
+        ASSERT(values.begin() == values.end());
+
+        for (int i = 0; i < 5; ++i)
+            values.push_back(ValueFlow::Value(i));
+        values.push_back(values.front()); // the value moves when the list grows
+        ASSERT_EQUALS(6U, values.size());
+        ASSERT_EQUALS(0, values.front().intvalue);
+        ASSERT_EQUALS(0, values.back().intvalue);
+        ASSERT_EQUALS(3, values.begin()[3].intvalue);
+
+        ValueFlow::ValueList copy(values);
+        copy.push_back(ValueFlow::Value(10));
+        ASSERT_EQUALS(6U, values.size());
+        ASSERT_EQUALS(7U, copy.size());
+
+        ValueFlow::ValueList other;
+        other.swap(copy);
+        ASSERT_EQUALS(true, copy.empty());
+        ASSERT_EQUALS(10, other.back().intvalue);
+
+        other = values;
+        ASSERT_EQUALS(6U, other.size());
+
+        values.clear();
+        ASSERT_EQUALS(true, values.empty());
+        ASSERT_EQUALS(0U, values.size());
+    }
 };
 
 REGISTER_TEST(TestValueFlow)
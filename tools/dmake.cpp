@@ -243,8 +243,16 @@ int main(int argc, char **argv)
     makeConditionalVariable(fout, "HAVE_RULES", "no");
 
     // compiled patterns..
-    fout << "# folder where lib/*.cpp files are located\n";
-    makeConditionalVariable(fout, "SRCDIR", "lib");
+    fout << "# folder where lib/*.cpp files are located. The Token::Match() patterns are\n"
+         << "# compiled by tools/matchcompiler.py into build/ when python is available,\n"
+         << "# use 'make SRCDIR=lib' to build the uncompiled sources.\n"
+         << "ifndef SRCDIR\n"
+         << "    ifeq ($(shell python -c \"print(1)\" 2>/dev/null),1)\n"
+         << "        SRCDIR=build\n"
+         << "    else\n"
+         << "        SRCDIR=lib\n"
+         << "    endif\n"
+         << "endif\n\n";
     fout << "ifeq ($(SRCDIR),build)\n"
          << "    ifdef VERIFY\n"
          << "        matchcompiler_S := $(shell python tools/matchcompiler.py --verify)\n"
@@ -299,6 +307,9 @@ int main(int argc, char **argv)
          << "        endif # !CPPCHK_GLIBCXX_DEBUG\n"
          << "    endif # GNU/kFreeBSD\n"
          << "\n"
+         << "    # ThreadExecutor uses std::thread\n"
+         << "    LDFLAGS += -pthread\n"
+         << "\n"
          << "endif # COMSPEC\n"
          << "\n";
 
@@ -403,8 +414,16 @@ int main(int argc, char **argv)
     fout << "\t./dmake\n\n";
     fout << "reduce:\ttools/reduce.o externals/tinyxml/tinyxml2.o $(LIBOBJ)\n";
     fout << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -std=c++0x -g -o reduce tools/reduce.o -Ilib -Iexternals/tinyxml $(LIBOBJ) $(LIBS) externals/tinyxml/tinyxml2.o $(LDFLAGS) $(RDYNAMIC)\n\n";
+    fout << "tokbench:\ttools/tokbench.o externals/tinyxml/tinyxml2.o $(LIBOBJ)\n";
+    fout << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -std=c++0x -o tokbench tools/tokbench.o -Ilib $(LIBOBJ) $(LIBS) externals/tinyxml/tinyxml2.o $(LDFLAGS) $(RDYNAMIC)\n\n";
+    fout << "matchbench:\ttools/matchbench.o build/matchbench_patterns.o externals/tinyxml/tinyxml2.o $(LIBOBJ)\n";
+    fout << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -std=c++0x -o matchbench tools/matchbench.o build/matchbench_patterns.o -Ilib $(LIBOBJ) $(LIBS) externals/tinyxml/tinyxml2.o $(LDFLAGS) $(RDYNAMIC)\n\n";
+    fout << "build/matchbench_patterns.cpp:\ttools/matchbench.py tools/matchcompiler.py $(wildcard lib/*.cpp)\n";
+    fout << "\tpython tools/matchbench.py\n\n";
+    fout << "build/matchbench_patterns.o: build/matchbench_patterns.cpp lib/cxx11emu.h lib/token.h\n";
+    fout << "\t$(CXX) ${INCLUDE_FOR_LIB} $(CPPFLAGS) $(CFG) $(CXXFLAGS) $(UNDEF_STRICT_ANSI) -std=c++0x -c -o build/matchbench_patterns.o build/matchbench_patterns.cpp\n\n";
     fout << "clean:\n";
-    fout << "\trm -f build/*.o lib/*.o cli/*.o test/*.o tools/*.o externals/tinyxml/*.o testrunner reduce dmake cppcheck cppcheck.1\n\n";
+    fout << "\trm -f build/*.o lib/*.o cli/*.o test/*.o tools/*.o externals/tinyxml/*.o testrunner reduce tokbench matchbench dmake cppcheck cppcheck.1\n\n";
     fout << "man:\tman/cppcheck.1\n\n";
     fout << "man/cppcheck.1:\t$(MAN_SOURCE)\n\n";
     fout << "\t$(XP) $(DB2MAN) $(MAN_SOURCE)\n\n";
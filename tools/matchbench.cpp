@@ -0,0 +1,149 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark for the compiled Token::Match() patterns. Every constant
+ * pattern in the lib sources is matched against every token of the given files,
+ * once interpreted by Token::Match() and once compiled by
+ * tools/matchcompiler.py. The patterns are generated by tools/matchbench.py
+ * and the number of hits must be the same for both variants.
+ *
+ * Usage: matchbench [--repeat=<n>] file ...
+ */
+
+#include "errorlogger.h"
+#include "preprocessor.h"
+#include "settings.h"
+#include "tokenize.h"
+#include "token.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// build/matchbench_patterns.cpp
+extern const unsigned int matchPatternCount;
+extern const char * const matchPatterns[];
+void matchInterpreted(const Token *tok, unsigned long hits[]);
+void matchCompiled(const Token *tok, unsigned long hits[]);
+
+class NullErrorLogger : public ErrorLogger {
+public:
+    void reportOut(const std::string &) {}
+    void reportErr(const ErrorLogger::ErrorMessage &) {}
+};
+
+static std::string preprocess(const std::string &filename, Settings &settings, ErrorLogger &errorLogger)
+{
+    std::ifstream fin(filename.c_str());
+    if (!fin.is_open()) {
+        std::cerr << "matchbench: could not open " << filename << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    Preprocessor preprocessor(&settings, &errorLogger);
+    std::string filedata;
+    std::list<std::string> configurations;
+    preprocessor.preprocess(fin, filedata, configurations, filename, std::list<std::string>());
+    return preprocessor.getcode(filedata, "", filename);
+}
+
+static double run(const std::list<const Token *> &tokenlists, unsigned int repeat,
+                  void (*match)(const Token *, unsigned long[]), std::vector<unsigned long> &hits)
+{
+    hits.assign(matchPatternCount, 0UL);
+    const std::clock_t start = std::clock();
+    for (unsigned int i = 0; i < repeat; ++i) {
+        for (auto it = tokenlists.begin(); it != tokenlists.end(); ++it) {
+            for (const Token *tok = *it; tok; tok = tok->next())
+                match(tok, &hits[0]);
+        }
+    }
+    return double(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int repeat = 1;
+    std::list<std::string> filenames;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = (unsigned int)std::atoi(argv[i] + 9);
+        else if (argv[i][0] != '-')
+            filenames.push_back(argv[i]);
+        else {
+            filenames.clear();
+            break;
+        }
+    }
+    if (filenames.empty()) {
+        std::cerr << "Usage: matchbench [--repeat=<n>] file ..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Settings settings;
+    NullErrorLogger errorLogger;
+
+    std::list<Tokenizer *> tokenizers;
+    std::list<const Token *> tokenlists;
+    unsigned long long tokens = 0;
+    for (auto it = filenames.begin(); it != filenames.end(); ++it) {
+        Tokenizer *tokenizer = new Tokenizer(&settings, &errorLogger);
+        tokenizers.push_back(tokenizer);
+        std::istringstream istr(preprocess(*it, settings, errorLogger));
+        tokenizer->tokenize(istr, it->c_str());
+        tokenlists.push_back(tokenizer->tokens());
+        for (const Token *tok = tokenizer->tokens(); tok; tok = tok->next())
+            ++tokens;
+    }
+
+    std::vector<unsigned long> interpretedHits, compiledHits;
+    const double interpreted = run(tokenlists, repeat, matchInterpreted, interpretedHits);
+    const double compiled = run(tokenlists, repeat, matchCompiled, compiledHits);
+
+    unsigned long long hits = 0;
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; i < matchPatternCount; ++i) {
+        hits += interpretedHits[i];
+        if (interpretedHits[i] != compiledHits[i]) {
+            std::cerr << "mismatch: \"" << matchPatterns[i] << "\" interpreted:" << interpretedHits[i]
+                      << " compiled:" << compiledHits[i] << std::endl;
+            ++mismatches;
+        }
+    }
+
+    std::cout << "patterns:    " << matchPatternCount << '\n'
+              << "tokens:      " << tokens << '\n'
+              << "hits:        " << hits << '\n'
+              << "interpreted: " << interpreted << " s\n"
+              << "compiled:    " << compiled << " s\n";
+    if (compiled > 0.0)
+        std::cout << "speedup:     " << (interpreted / compiled) << "x\n";
+    std::cout << std::flush;
+
+    for (auto it = tokenizers.begin(); it != tokenizers.end(); ++it)
+        delete *it;
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
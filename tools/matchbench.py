@@ -0,0 +1,111 @@
+#!/usr/bin/python
+#
+# Cppcheck - A tool for static C/C++ code analysis
+# Copyright (C) 2007-2015 Daniel Marjamaeki and Cppcheck team.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generates build/matchbench_patterns.cpp for tools/matchbench.cpp.
+# The file contains every constant Token::Match() and Token::simpleMatch()
+# pattern used in lib/*.cpp twice: once interpreted by Token::Match() and
+# once compiled by the matchcompiler.
+
+import os
+import sys
+import re
+import glob
+import tempfile
+
+from matchcompiler import MatchCompiler
+
+PATTERN = re.compile(
+    r'Token::(Match|simpleMatch)\(\s*[\w\->\.\(\)]+\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def collectPatterns(filenames):
+    patterns = []
+    seen = set()
+    for filename in sorted(filenames):
+        fin = open(filename, 'rt')
+        code = fin.read()
+        fin.close()
+        for match in PATTERN.finditer(code):
+            function = match.group(1)
+            pattern = match.group(2)
+            # %varid% patterns need a varid argument
+            if '%varid%' in pattern or (function, pattern) in seen:
+                continue
+            seen.add((function, pattern))
+            patterns.append((function, pattern))
+    return patterns
+
+
+def generateCode(patterns):
+    code = '#include "token.h"\n\n'
+    code += 'extern const unsigned int matchPatternCount = ' + \
+        str(len(patterns)) + 'U;\n\n'
+
+    code += 'extern const char * const matchPatterns[] = {\n'
+    for function, pattern in patterns:
+        code += '    "' + pattern + '",\n'
+    code += '    0\n};\n\n'
+
+    # The pattern is not a literal in the Token::Match() call so the
+    # matchcompiler leaves these calls alone
+    code += 'static inline bool interpretMatch(const Token *tok, const char pattern[])\n'
+    code += '{\n    return Token::Match(tok, pattern);\n}\n\n'
+    code += 'static inline bool interpretSimpleMatch(const Token *tok, const char pattern[])\n'
+    code += '{\n    return Token::simpleMatch(tok, pattern);\n}\n\n'
+
+    code += 'void matchInterpreted(const Token *tok, unsigned long hits[])\n{\n'
+    for i, (function, pattern) in enumerate(patterns):
+        helper = 'interpretMatch' if function == 'Match' else 'interpretSimpleMatch'
+        code += '    if (' + helper + '(tok, "' + pattern + '"))\n'
+        code += '        ++hits[' + str(i) + '];\n'
+    code += '}\n\n'
+
+    code += 'void matchCompiled(const Token *tok, unsigned long hits[])\n{\n'
+    for i, (function, pattern) in enumerate(patterns):
+        code += '    if (Token::' + function + '(tok, "' + pattern + '"))\n'
+        code += '        ++hits[' + str(i) + '];\n'
+    code += '}\n'
+    return code
+
+
+def main():
+    build_dir = 'build'
+    destname = os.path.join(build_dir, 'matchbench_patterns.cpp')
+
+    if not os.path.exists('lib'):
+        print('Please invoke from the top level cppcheck source dir. Example: tools/matchbench.py')
+        sys.exit(-1)
+
+    if not os.path.exists(build_dir):
+        os.makedirs(build_dir)
+
+    patterns = collectPatterns(glob.glob('lib/*.cpp'))
+
+    fd, srcname = tempfile.mkstemp(suffix='.cpp')
+    fout = os.fdopen(fd, 'wt')
+    fout.write(generateCode(patterns))
+    fout.close()
+    try:
+        MatchCompiler(verify_mode=False).convertFile(srcname, destname)
+    finally:
+        os.remove(srcname)
+
+    print(str(len(patterns)) + ' patterns => ' + destname)
+
+if __name__ == '__main__':
+    main()
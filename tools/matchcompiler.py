@@ -23,16 +23,37 @@ import glob
 import argparse
 
 
+def loadTokenStrings(filename=None):
+    """Read the token strings that have a fixed id from lib/tokenstrings.h"""
+    if filename is None:
+        filename = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib', 'tokenstrings.h')
+    ids = {}
+    fin = open(filename, 'rt')
+    for line in fin:
+        res = re.match(r'\s*TOKEN_STRING\((\w+), "(.*)"\)', line)
+        if res:
+            ids[res.group(2).replace('\\"', '"').replace('\\\\', '\\')] = 'TokenStrings::' + res.group(1)
+    fin.close()
+    return ids
+
+
 class MatchCompiler:
 
     def __init__(self, verify_mode=False):
         self._verifyMode = verify_mode
+        self._tokenStrings = loadTokenStrings()
         self._reset()
 
     def _reset(self):
         self._rawMatchFunctions = []
         self._matchStrs = {}
         self._matchFunctionCache = {}
+        # The preprocessor conditions the match functions are used in
+        self._functionConditions = {}
+        self._condition = ''
+
+    def _addFunctionUse(self, id):
+        self._functionConditions.setdefault(id, set()).add(self._condition)
 
     def _generateCacheSignature(
             self, pattern, endToken=None, varId=None, isFindMatch=False):
@@ -90,6 +111,12 @@ class MatchCompiler:
 
         return prefix + str(self._matchStrs[look_for])
 
+    def _compileStrCompare(self, tok, op='=='):
+        """Compare token string, using the fixed id when there is one"""
+        if tok in self._tokenStrings:
+            return 'tok->strId()' + op + self._tokenStrings[tok]
+        return 'tok->str()' + op + self._insertMatchStr(tok)
+
     def _compileCmd(self, tok):
         if tok == '%any%':
             return 'true'
@@ -106,9 +133,9 @@ class MatchCompiler:
         elif tok == '%op%':
             return 'tok->isOp()'
         elif tok == '%or%':
-            return '(tok->type() == Token::eBitOp && tok->str()==' + self._insertMatchStr('|') + ')/* | */'
+            return '(tok->type() == Token::eBitOp && ' + self._compileStrCompare('|') + ')/* | */'
         elif tok == '%oror%':
-            return '(tok->type() == Token::eLogicalOp && tok->str()==' + self._insertMatchStr('||') + ')/* || */'
+            return '(tok->type() == Token::eLogicalOp && ' + self._compileStrCompare('||') + ')/* || */'
         elif tok == '%str%':
             return '(tok->type()==Token::eString)'
         elif tok == '%type%':
@@ -123,7 +150,7 @@ class MatchCompiler:
             print ("unhandled:" + tok)
 
         return (
-            '(tok->str()==' + self._insertMatchStr(tok) + ')/* ' + tok + ' */'
+            '(' + self._compileStrCompare(tok) + ')/* ' + tok + ' */'
         )
 
     def _compilePattern(self, pattern, nr, varid,
@@ -197,8 +224,8 @@ class MatchCompiler:
 
             # !!a
             elif tok[0:2] == "!!":
-                ret += '    if (tok && tok->str() == ' + self._insertMatchStr(
-                    tok[2:]) + ')/* ' + tok[2:] + ' */\n'
+                ret += '    if (tok && ' + self._compileStrCompare(
+                    tok[2:], ' == ') + ')/* ' + tok[2:] + ' */\n'
                 ret += '        ' + returnStatement
                 gotoNextToken = '    tok = tok ? tok->next() : NULL;\n'
 
@@ -351,6 +378,7 @@ class MatchCompiler:
                 False)
             self._rawMatchFunctions.append(
                 self._compilePattern(pattern, patternNumber, varId))
+        self._addFunctionUse(patternNumber)
 
         functionName = "match"
         if self._verifyMode:
@@ -366,6 +394,7 @@ class MatchCompiler:
             # inject verify function
             functionName = "match_verify"
             patternNumber = verifyNumber
+            self._addFunctionUse(patternNumber)
 
         return (
             line[:start_pos] + functionName + str(
@@ -481,6 +510,7 @@ class MatchCompiler:
                     findMatchNumber,
                     endToken,
                     varId))
+        self._addFunctionUse(findMatchNumber)
 
         functionName = "findmatch"
         if self._verifyMode:
@@ -497,6 +527,7 @@ class MatchCompiler:
             # inject verify function
             functionName = "findmatch_verify"
             findMatchNumber = verifyNumber
+            self._addFunctionUse(findMatchNumber)
 
         return (
             line[:start_pos] + functionName + str(
@@ -568,6 +599,23 @@ class MatchCompiler:
         return line
 
     def _replaceCStrings(self, line):
+        # tok->str() == "if" => tok->strId() == TokenStrings::If
+        pos = 0
+        while True:
+            match = re.compile(r'\btok\w*->str\(\) (==|!=) "').search(line, pos)
+            if not match:
+                break
+            res = self._parseStringComparison(line, match.start())
+            if res is None:
+                break
+            text = line[res[0] + 1:res[1] - 1]
+            if text not in self._tokenStrings:
+                pos = res[1]
+                continue
+            strPos = line.index('str()', match.start())
+            line = line[:strPos] + 'strId()' + line[strPos + 5:res[0]] + self._tokenStrings[text] + line[res[1]:]
+            pos = strPos
+
         while True:
             match = re.search('str\(\) (==|!=) "', line)
             if not match:
@@ -586,6 +634,101 @@ class MatchCompiler:
 
         return line
 
+    @staticmethod
+    def _splitComments(line, inComment):
+        """Split a line in code and comments. Returns a list of
+        (isComment, text) and whether a block comment continues on the next line"""
+        parts = []
+        start = 0
+        pos = 0
+        quote = None
+        while pos < len(line):
+            if inComment:
+                end = line.find('*/', pos)
+                if end == -1:
+                    break
+                pos = end + 2
+                parts.append((True, line[start:pos]))
+                start = pos
+                inComment = False
+                continue
+            c = line[pos]
+            if quote:
+                if c == '\\':
+                    pos += 1
+                elif c == quote:
+                    quote = None
+            elif c == '"' or c == "'":
+                quote = c
+            elif line.startswith('//', pos):
+                break
+            elif line.startswith('/*', pos):
+                if pos > start:
+                    parts.append((False, line[start:pos]))
+                start = pos
+                inComment = True
+                pos += 1
+            pos += 1
+        if start < len(line):
+            rest = line[start:]
+            if inComment:
+                parts.append((True, rest))
+            else:
+                code = rest[:pos - start]
+                comment = rest[pos - start:]
+                if code:
+                    parts.append((False, code))
+                if comment:
+                    parts.append((True, comment))
+        return parts, inComment
+
+    def _preprocessorCondition(self, directive, conditions):
+        """Update the stack of #if branches with a preprocessor directive.
+        Returns False if it is not a conditional directive"""
+        res = re.match(r'\s*#\s*(\w+)\s*(.*?)\s*$', directive)
+        if res is None:
+            return False
+        name = res.group(1)
+        expr = res.group(2)
+        if name == 'ifdef':
+            conditions.append(['defined(' + expr + ')'])
+        elif name == 'ifndef':
+            conditions.append(['!defined(' + expr + ')'])
+        elif name == 'if':
+            conditions.append(['(' + expr + ')'])
+        elif name == 'elif' and conditions:
+            conditions[-1].append('(' + expr + ')')
+        elif name == 'else' and conditions:
+            conditions[-1].append(None)
+        elif name == 'endif' and conditions:
+            conditions.pop()
+        else:
+            return False
+        return True
+
+    @staticmethod
+    def _currentCondition(conditions):
+        """The condition of the current #if branches, '' outside of #if"""
+        ret = []
+        for branches in conditions:
+            for branch in branches[:-1]:
+                ret.append('!' + branch)
+            if branches[-1] is not None:
+                ret.append(branches[-1])
+        return ' && '.join(ret)
+
+    def _compileCode(self, code):
+        # Compile Token::Match and Token::simpleMatch
+        code = self._replaceTokenMatch(code)
+
+        # Compile Token::findsimplematch
+        code = self._replaceTokenFindMatch(code)
+
+        # Cache plain C-strings in C++ strings
+        code = self._replaceCStrings(code)
+
+        return code
+
     def convertFile(self, srcname, destname):
         self._reset()
 
@@ -600,17 +743,23 @@ class MatchCompiler:
         # header += '#include <iostream>\n'
         code = ''
 
+        # Patterns in comments are not compiled, and the match functions
+        # get the #if conditions of the code that uses them, so there are
+        # no unused functions
+        inComment = False
+        conditions = []
         for line in srclines:
-            # Compile Token::Match and Token::simpleMatch
-            line = self._replaceTokenMatch(line)
-
-            # Compile Token::findsimplematch
-            line = self._replaceTokenFindMatch(line)
-
-            # Cache plain C-strings in C++ strings
-            line = self._replaceCStrings(line)
+            parts, inComment = self._splitComments(line, inComment)
+            directive = ''.join(text for isComment, text in parts if not isComment)
+            if directive.lstrip().startswith('#') and self._preprocessorCondition(directive, conditions):
+                self._condition = self._currentCondition(conditions)
+                code += line
+                continue
 
-            code += line
+            for isComment, text in parts:
+                if not isComment:
+                    text = self._compileCode(text)
+                code += text
 
         # Compute string list
         stringList = ''
@@ -620,11 +769,29 @@ class MatchCompiler:
 
         # Compute matchFunctions
         strFunctions = ''
-        for function in self._rawMatchFunctions:
-            strFunctions += function
+        for nr, function in enumerate(self._rawMatchFunctions, 1):
+            functionConditions = self._functionConditions.get(nr, set(['']))
+            if '' in functionConditions:
+                strFunctions += function
+            elif len(functionConditions) == 1:
+                strFunctions += '#if ' + functionConditions.pop() + '\n' + function + '#endif\n'
+            else:
+                strFunctions += '#if ' + ' || '.join('(' + c + ')' for c in sorted(functionConditions)) + \
+                    '\n' + function + '#endif\n'
+
+        output = header + stringList + strFunctions + code
+
+        # Only touch the file when the output changes, so make does not
+        # rebuild everything each time the patterns are compiled
+        if os.path.exists(destname):
+            fin = open(destname, 'rt')
+            unchanged = fin.read() == output
+            fin.close()
+            if unchanged:
+                return
 
         fout = open(destname, 'wt')
-        fout.write(header + stringList + strFunctions + code)
+        fout.write(output)
         fout.close()
 
 
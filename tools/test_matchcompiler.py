@@ -16,6 +16,8 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+import os
+import tempfile
 import unittest
 import matchcompiler
 
@@ -154,5 +156,90 @@ class MatchCompilerTest(unittest.TestCase):
         self.assertEqual(1, len(self.mc._matchStrs))
         self.assertEqual(1, self.mc._matchStrs['foobar'])
 
+    def test_tokenStrings(self):
+        # Strings with a fixed id are compared by id
+        input = 'if (Token::Match(tok, "if ( foobar !!else")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (match1(tok)) {')
+        self.assertEqual(1, len(self.mc._matchStrs))
+        self.assertTrue('tok->strId()==TokenStrings::If' in self.mc._rawMatchFunctions[0])
+        self.assertTrue('tok->strId()==TokenStrings::LParen' in self.mc._rawMatchFunctions[0])
+        self.assertTrue('tok->strId() == TokenStrings::Else' in self.mc._rawMatchFunctions[0])
+
+        input = 'if (tok->str() == "foobar" || tok2->str() != "while") {'
+        output = self.mc._replaceCStrings(input)
+        self.assertEqual(output, 'if (tok->str() == matchStr1 || tok2->strId() != TokenStrings::While) {')
+
+        # Only token strings are compared by id
+        input = 'if (ostr.str() == "while") {'
+        output = self.mc._replaceCStrings(input)
+        self.assertEqual(output, 'if (ostr.str() == matchStr2) {')
+
+    def test_convertFileUnchanged(self):
+        # The output file is not rewritten when the output is the same
+        tempdir = tempfile.mkdtemp()
+        srcname = os.path.join(tempdir, 'src.cpp')
+        destname = os.path.join(tempdir, 'dest.cpp')
+        fout = open(srcname, 'wt')
+        fout.write('bool f(const Token *tok) { return Token::Match(tok, "foobar"); }\n')
+        fout.close()
+        try:
+            self.mc.convertFile(srcname, destname)
+            os.utime(destname, (0, 0))
+            self.mc.convertFile(srcname, destname)
+            self.assertEqual(0, os.path.getmtime(destname))
+
+            fout = open(srcname, 'wt')
+            fout.write('bool f(const Token *tok) { return Token::Match(tok, "foo"); }\n')
+            fout.close()
+            self.mc.convertFile(srcname, destname)
+            self.assertNotEqual(0, os.path.getmtime(destname))
+        finally:
+            for filename in (srcname, destname):
+                if os.path.exists(filename):
+                    os.remove(filename)
+            os.rmdir(tempdir)
+
+    def test_convertFileComments(self):
+        # Patterns in comments are not compiled, the match functions get the
+        # #if conditions of the code that uses them
+        tempdir = tempfile.mkdtemp()
+        srcname = os.path.join(tempdir, 'src.cpp')
+        destname = os.path.join(tempdir, 'dest.cpp')
+        fout = open(srcname, 'wt')
+        fout.write('// Token::Match(tok, "a")\n'
+                   '/* Token::Match(tok, "b")\n'
+                   '   Token::Match(tok, "c") */ bool f(const Token *tok) { return Token::Match(tok, "d"); }\n'
+                   '#ifdef X // Token::Match(tok, "e")\n'
+                   'bool g(const Token *tok) { return Token::Match(tok, "f"); }\n'
+                   '#else\n'
+                   'bool h(const Token *tok) { return Token::Match(tok, "g") && Token::Match(tok, "d"); }\n'
+                   '#endif\n'
+                   'switch (c) {\n'
+                   'case 1:\n'
+                   '    x = 1;\n'
+                   '    // fall through\n'
+                   'case 2:\n'
+                   '    break;\n'
+                   '}\n')
+        fout.close()
+        try:
+            self.mc.convertFile(srcname, destname)
+            fin = open(destname, 'rt')
+            output = fin.read()
+            fin.close()
+            self.assertEqual(3, len(self.mc._rawMatchFunctions))
+            self.assertTrue('// Token::Match(tok, "a")\n' in output)
+            self.assertTrue('   Token::Match(tok, "c") */ bool f(const Token *tok) { return match1(tok); }\n' in output)
+            self.assertTrue('#if defined(X)\n// pattern: f\n' in output)
+            self.assertTrue('#if !defined(X)\n// pattern: g\n' in output)
+            self.assertTrue('// pattern: d\nstatic bool match1' in output)
+            self.assertTrue('    // fall through\n' in output)
+        finally:
+            for filename in (srcname, destname):
+                if os.path.exists(filename):
+                    os.remove(filename)
+            os.rmdir(tempdir)
+
 if __name__ == '__main__':
     unittest.main()
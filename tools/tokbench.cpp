@@ -0,0 +1,184 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2015 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Micro benchmark for the tokenizer. Tokenizes (and simplifies) the given
+ * files, or a generated sample, several times and reports the time, the
+ * number of heap allocations, the heap used by the largest token list and
+ * the peak RSS.
+ *
+ * Usage: tokbench [--repeat=<n>] [--simplify] [--functions=<n>] [file ...]
+ */
+
+#include "errorlogger.h"
+#include "preprocessor.h"
+#include "settings.h"
+#include "tokenize.h"
+#include "token.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Count heap allocations made by the program
+static unsigned long long allocations = 0;
+
+// Heap bytes in use. The size is stored in front of each block, the header
+// keeps the alignment of malloc().
+static std::size_t heapInUse = 0;
+static const std::size_t HeaderSize = 2U * sizeof(void *);
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    char *p = static_cast<char *>(std::malloc(size + HeaderSize));
+    if (!p)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(p) = size;
+    heapInUse += size;
+    return p + HeaderSize;
+}
+
+void operator delete(void *p) throw()
+{
+    if (!p)
+        return;
+    char *block = static_cast<char *>(p) - HeaderSize;
+    heapInUse -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *p, std::size_t) throw()
+{
+    operator delete(p);
+}
+
+class NullErrorLogger : public ErrorLogger {
+public:
+    void reportOut(const std::string &) {}
+    void reportErr(const ErrorLogger::ErrorMessage &) {}
+};
+
+static std::string generateSample(unsigned int functions)
+{
+    std::ostringstream ostr;
+    ostr << "struct S { int a; char *p; };\n";
+    for (unsigned int i = 0; i < functions; ++i) {
+        ostr << "static int f" << i << "(struct S *s, int x) {\n"
+             << "    int buf[10];\n"
+             << "    for (int i = 0; i < 10; i++) { buf[i] = x * i + s->a; }\n"
+             << "    if (x > 0 && s->p != 0) { s->p[0] = (char)buf[x % 10]; }\n"
+             << "    return buf[0] + f" << (i ? i - 1 : 0) << "(s, x - 1);\n"
+             << "}\n";
+    }
+    return ostr.str();
+}
+
+static std::string preprocess(const std::string &filename, Settings &settings, ErrorLogger &errorLogger)
+{
+    std::ifstream fin(filename.c_str());
+    if (!fin.is_open()) {
+        std::cerr << "tokbench: could not open " << filename << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    Preprocessor preprocessor(&settings, &errorLogger);
+    std::string filedata;
+    std::list<std::string> configurations;
+    preprocessor.preprocess(fin, filedata, configurations, filename, std::list<std::string>());
+    return preprocessor.getcode(filedata, "", filename);
+}
+
+static long peakRss()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int repeat = 10;
+    unsigned int functions = 2000;
+    bool simplify = false;
+    std::list<std::string> filenames;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = (unsigned int)std::atoi(argv[i] + 9);
+        else if (std::strncmp(argv[i], "--functions=", 12) == 0)
+            functions = (unsigned int)std::atoi(argv[i] + 12);
+        else if (std::strcmp(argv[i], "--simplify") == 0)
+            simplify = true;
+        else if (argv[i][0] == '-') {
+            std::cerr << "Usage: tokbench [--repeat=<n>] [--simplify] [--functions=<n>] [file ...]" << std::endl;
+            return EXIT_FAILURE;
+        } else
+            filenames.push_back(argv[i]);
+    }
+
+    Settings settings;
+    NullErrorLogger errorLogger;
+
+    std::map<std::string, std::string> samples;
+    if (filenames.empty())
+        samples["sample.c"] = generateSample(functions);
+    for (auto it = filenames.begin(); it != filenames.end(); ++it)
+        samples[*it] = preprocess(*it, settings, errorLogger);
+
+    const unsigned long long allocationsBefore = allocations;
+    unsigned long long tokens = 0;
+    std::size_t tokenListBytes = 0;
+    const std::clock_t start = std::clock();
+    for (unsigned int i = 0; i < repeat; ++i) {
+        for (auto it = samples.begin(); it != samples.end(); ++it) {
+            const std::size_t heapBefore = heapInUse;
+            Tokenizer tokenizer(&settings, &errorLogger);
+            std::istringstream istr(it->second);
+            tokenizer.tokenize(istr, it->first.c_str());
+            if (simplify)
+                tokenizer.simplifyTokenList2();
+            if (heapInUse - heapBefore > tokenListBytes)
+                tokenListBytes = heapInUse - heapBefore;
+            for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
+                ++tokens;
+        }
+    }
+    const double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+    std::cout << "tokens:      " << tokens << '\n'
+              << "time:        " << seconds << " s\n"
+              << "allocations: " << (allocations - allocationsBefore) << '\n'
+              << "token list:  " << tokenListBytes / 1024U << " kB\n"
+              << "peak RSS:    " << peakRss() << " kB" << std::endl;
+
+    return EXIT_SUCCESS;
+}